@@ -1,8 +1,6 @@
 """Build definitions for Sanity."""
 
-load("@llvm//:llvm.bzl", "llc")
-
-def sanity_binary(name, src, deps = []):
+def sanity_binary(name, src, deps = [], opt_level = 2):
     """Compiles a binary for the Sanity language.
 
     Outputs:
@@ -12,32 +10,25 @@ def sanity_binary(name, src, deps = []):
       name: Name of this rule.
       src: The source file to compile.
       deps: Dependencies to compile this source file with.
+      opt_level: Level from 0 to 3 to optimize the program at, like -O0 to -O3 of a C compiler. Defaults to 2.
     """
 
-    # Use the compiler to generate some LLVM IR.
-    llvm_ir = "%s.ll" % name
+    # Use the compiler to generate an object file directly.
+    obj = "%s.o" % name
     native.genrule(
         name = "%s_compile" % name,
         srcs = [src],
-        outs = [llvm_ir],
+        outs = [obj],
         cmd = """
-            $(location //compiler) < "$<" > "$@"
-        """,
+            $(location //compiler) --opt_level=%d --emit=obj < "$<" > "$@"
+        """ % opt_level,
         tools = ["//compiler"],
     )
 
-    # Invoke llc to compile the LLVM IR to Assembly.
-    assembly = "%s.s" % name
-    llc(
-        name = "%s_llc" % name,
-        src = llvm_ir,
-        out = assembly,
-    )
-
-    # Assemble into the final binary.
+    # Link into the final binary.
     native.cc_binary(
         name = name,
-        srcs = [assembly],
+        srcs = [obj],
         deps = deps,
         linkopts = ["-static"],
     )
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "batch.h"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "compiler/emitter/emitter.h"
+#include "compiler/generator/generator.h"
+#include "compiler/lexer/token_stream.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/ast_interner.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/diagnostics.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/optimizer/optimizer.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+#include "compiler/utils/source_buffer.h"
+#include "compiler/utils/thread_pool.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+typedef Exceptions::AssertionException AssertionException;
+typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::IllegalStateException IllegalStateException;
+typedef Exceptions::ParseException ParseException;
+typedef Exceptions::RedeclaredException RedeclaredException;
+typedef Exceptions::SyntaxException SyntaxException;
+typedef Exceptions::TypeException TypeException;
+typedef Exceptions::UndeclaredException UndeclaredException;
+
+namespace {
+    // Emits the given module in the output format with the given machine and writes it to the given path.
+    void write(llvm::Module& module, const Batch::Options& options, llvm::TargetMachine& machine,
+            const std::string& path) {
+        std::string buffer;
+        llvm::raw_string_ostream stream(buffer);
+        Emitter::emit(module, options.format, machine, stream);
+        stream.flush();
+
+        std::ofstream output(path, std::ios::binary);
+        output.write(buffer.data(), buffer.size());
+        output.close();
+        if (!output) throw IllegalStateException("Cannot write \"" + path + "\".");
+    }
+
+    // Returns the given path made absolute, without any "." or ".." components.
+    std::string absolutePath(const std::string& path) {
+        llvm::SmallString<128> absolute(path);
+        llvm::sys::fs::make_absolute(absolute);
+        llvm::sys::path::remove_dots(absolute, true /* remove_dot_dot */);
+        return absolute.str().str();
+    }
+
+    // Compiles the given input like the compiler does a single one, collecting its errors rather than printing them.
+    Batch::Result compileFile(const std::string& input, const Batch::Options& options) {
+        Batch::Result result;
+        result.input = input;
+        result.output = Batch::outputPath(input, options);
+
+        try {
+            const std::unique_ptr<const SourceBuffer> source = SourceBuffer::open(input);
+            Diagnostics diagnostics;
+            Arena arena;
+            AST::Interner interner(arena);
+            TokenStream tokens(source->view(), diagnostics);
+            const AST::File* file = options.shareExpressions
+                ? Parser::parse(tokens, interner, diagnostics) : Parser::parse(tokens, arena, diagnostics);
+
+            if (diagnostics.empty()) {
+                CompilationSession session(input);
+                Generator generator(session, options.shareExpressions ? &interner : nullptr, &diagnostics);
+                generator.outline(options.chunkInstructions);
+                generator.generate(*file);
+
+                if (diagnostics.empty()) {
+                    std::string invalid;
+                    llvm::raw_string_ostream invalidStream(invalid);
+                    if (llvm::verifyModule(*session.module, &invalidStream)) {
+                        result.errors.push_back("Generated invalid LLVM IR:\n" + invalidStream.str());
+                    } else {
+                        // Each input has a machine of its own, since generating code with one is not thread-safe.
+                        const std::unique_ptr<llvm::TargetMachine> machine = Optimizer::hostMachine(options.optLevel);
+                        Optimizer::optimize(*session.module, *machine, options.optLevel);
+                        write(*session.module, options, *machine, result.output);
+                    }
+                }
+            }
+
+            for (const Diagnostic& diagnostic : diagnostics.all()) result.errors.push_back(diagnostic.describe());
+        } catch (const FileNotFoundException& ex) {
+            result.errors.push_back(ex.what());
+        } catch (const IllegalStateException& ex) {
+            result.errors.push_back(ex.what());
+        } catch (const SyntaxException& ex) {
+            result.errors.push_back(ex.what());
+        } catch (const ParseException& ex) {
+            result.errors.push_back(std::string("ParseException: ") + ex.what());
+        } catch (const RedeclaredException& ex) {
+            result.errors.push_back(std::string("RedeclaredException: ") + ex.what());
+        } catch (const TypeException& ex) {
+            result.errors.push_back(std::string("TypeException: ") + ex.what());
+        } catch (const UndeclaredException& ex) {
+            result.errors.push_back(std::string("UndeclaredException: ") + ex.what());
+        } catch (const AssertionException& ex) {
+            result.errors.push_back(std::string("AssertionException: ") + ex.what());
+        } catch (const std::exception& ex) {
+            // Anything else would escape through the future and terminate the whole batch, so blame this input alone.
+            result.errors.push_back(ex.what());
+        }
+
+        return result;
+    }
+}
+
+std::vector<std::string> Batch::expand(const std::vector<std::string>& arguments) {
+    std::vector<std::string> inputs;
+    for (const std::string& argument : arguments) {
+        if (argument.empty() || argument[0] != '@') {
+            inputs.push_back(argument);
+            continue;
+        }
+
+        const std::string path = argument.substr(1);
+        std::ifstream responses(path);
+        if (!responses) throw FileNotFoundException(path);
+
+        std::string line;
+        while (std::getline(responses, line)) {
+            const size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos) continue;
+            inputs.push_back(line.substr(start, line.find_last_not_of(" \t\r") + 1 - start));
+        }
+    }
+
+    return inputs;
+}
+
+std::string Batch::outputPath(const std::string& input, const Options& options) {
+    llvm::SmallString<128> path;
+    if (options.outputDirectory.empty()) {
+        path = input;
+    } else {
+        path = options.outputDirectory;
+        llvm::sys::path::append(path, llvm::sys::path::filename(input));
+    }
+    llvm::sys::path::replace_extension(path, Emitter::extension(options.format));
+
+    return path.str().str();
+}
+
+std::vector<Batch::Result> Batch::compile(const std::vector<std::string>& inputs, const Options& options,
+        ThreadPool& pool) {
+    // Paths are compared in absolute form, so different spellings of the same file are caught too.
+    std::unordered_set<std::string> sources;
+    for (const std::string& input : inputs) sources.insert(absolutePath(input));
+
+    std::unordered_set<std::string> outputs;
+    for (const std::string& input : inputs) {
+        const std::string output = outputPath(input, options);
+        if (sources.count(absolutePath(output)) != 0) {
+            throw IllegalStateException("Writing \"" + output + "\" would overwrite an input.");
+        }
+        if (!outputs.insert(absolutePath(output)).second) {
+            throw IllegalStateException("Multiple inputs would be written to \"" + output + "\".");
+        }
+    }
+
+    // Start the largest inputs first, since the batch takes at least as long as the last input started. Inputs which
+    // cannot be sized are started last, since they fail straight away.
+    std::vector<uint64_t> sizes(inputs.size(), 0);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (llvm::sys::fs::file_size(inputs[i], sizes[i])) sizes[i] = 0;
+    }
+    std::vector<size_t> order(inputs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](const size_t left, const size_t right) {
+        return sizes[left] > sizes[right];
+    });
+
+    std::vector<std::future<Result>> futures(inputs.size());
+    for (const size_t i : order) {
+        futures[i] = pool.submit([input = inputs[i], options]() { return compileFile(input, options); });
+    }
+
+    std::vector<Result> results;
+    for (std::future<Result>& future : futures) results.push_back(future.get());
+    return results;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef SANITY_BATCH_H
+#define SANITY_BATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "compiler/emitter/emitter.h"
+#include "compiler/utils/thread_pool.h"
+
+/**
+ * Compiles many source files in one process, each into an output file of its own, so a build of many small programs
+ * pays for starting the compiler and LLVM only once. Files are compiled concurrently, each in a CompilationSession of
+ * its own, so nothing is shared between them but the interned Symbols.
+ */
+namespace Batch {
+    /**
+     * Settings shared by every file of a batch, which match the compiler's flags of the same names.
+     */
+    class Options {
+    public:
+        Emitter::Format format = Emitter::LLVM_IR;
+        unsigned optLevel = 0;
+        size_t chunkInstructions = 0;
+        bool shareExpressions = false;
+
+        // Directory to write every output into, or empty to write each one next to its input.
+        std::string outputDirectory;
+    };
+
+    /**
+     * Outcome of compiling a single input. Its output is only written if there are no errors.
+     */
+    class Result {
+    public:
+        std::string input;
+        std::string output;
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * Returns the given arguments with each response file, named by an argument starting with "@", replaced by the
+     * paths it lists, one per line. Blank lines are skipped.
+     * @throws FileNotFoundException if a response file cannot be read.
+     */
+    std::vector<std::string> expand(const std::vector<std::string>& arguments);
+
+    /**
+     * Returns the path the output of the given input is written to, which is its file name with the extension of the
+     * output Format in place of its own.
+     */
+    std::string outputPath(const std::string& input, const Options& options);
+
+    /**
+     * Compiles each of the given inputs on the given pool and returns their Results in the same order, however they
+     * were scheduled. The largest inputs are started first, so a big file started last does not hold up the whole
+     * batch. Every error of every input is collected, rather than stopping at the first input to fail.
+     * @throws IllegalStateException if two inputs would be written to the same output, or an output would overwrite an
+     *     input, in which case nothing is compiled.
+     */
+    std::vector<Result> compile(const std::vector<std::string>& inputs, const Options& options, ThreadPool& pool);
+}
+
+#endif //SANITY_BATCH_H
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "batch.h"
+#include "compiler/emitter/emitter.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/utils/thread_pool.h"
+
+typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream stream(path);
+    stream << content;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream stream(path);
+    std::stringstream content;
+    content << stream.rdbuf();
+    return content.str();
+}
+
+TEST(Batch, CompilesEachInputToItsOwnOutput) {
+    std::string large = "extern putchar: (int) -> int;\n";
+    for (int i = 0; i < 1000; ++i) large += "putchar(" + std::to_string(i) + ");\n";
+    writeFile("batch_small.sane", "extern putchar: (int) -> int;\nputchar('a');\n");
+    writeFile("batch_large.sane", large);
+
+    ThreadPool pool(2);
+    const std::vector<Batch::Result> results = Batch::compile({ "batch_small.sane", "batch_large.sane" },
+        Batch::Options(), pool);
+
+    ASSERT_EQ(2, results.size());
+    ASSERT_EQ("batch_small.sane", results[0].input);
+    ASSERT_EQ("batch_small.ll", results[0].output);
+    ASSERT_TRUE(results[0].errors.empty());
+    ASSERT_NE(std::string::npos, readFile("batch_small.ll").find("call i32 @putchar(i32 97)"));
+    ASSERT_EQ("batch_large.sane", results[1].input);
+    ASSERT_TRUE(results[1].errors.empty());
+    ASSERT_NE(std::string::npos, readFile("batch_large.ll").find("call i32 @putchar(i32 999)"));
+}
+
+TEST(Batch, ReportsErrorsOfEachInputInInputOrder) {
+    writeFile("batch_valid.sane", "1 + 2;\n");
+    writeFile("batch_unparsable.sane", "let a int = 1;\nlet b int = 2;\n");
+    writeFile("batch_undeclared.sane", "undeclared;\n");
+
+    ThreadPool pool(3);
+    const std::vector<Batch::Result> results = Batch::compile(
+        { "batch_undeclared.sane", "batch_missing.sane", "batch_valid.sane", "batch_unparsable.sane" },
+        Batch::Options(), pool);
+
+    ASSERT_EQ(4, results.size());
+    ASSERT_EQ(1, results[0].errors.size());
+    ASSERT_NE(std::string::npos, results[0].errors[0].find("UndeclaredException"));
+    ASSERT_EQ(1, results[1].errors.size());
+    ASSERT_TRUE(results[2].errors.empty());
+    ASSERT_EQ(2, results[3].errors.size());
+    ASSERT_TRUE(readFile("batch_unparsable.ll").empty());
+}
+
+TEST(Batch, ReportsInputsWhichFailToGenerateWithoutStoppingOthers) {
+    writeFile("batch_overflow.sane", "extern putchar: (int) -> int;\nputchar(99999999999);\n");
+    writeFile("batch_arity.sane", "extern putchar: (int) -> int;\nputchar(1, 2);\n");
+    writeFile("batch_fine.sane", "extern putchar: (int) -> int;\nputchar('a');\n");
+
+    ThreadPool pool(2);
+    const std::vector<Batch::Result> results = Batch::compile(
+        { "batch_overflow.sane", "batch_arity.sane", "batch_fine.sane" }, Batch::Options(), pool);
+
+    ASSERT_EQ(3, results.size());
+    ASSERT_EQ(1, results[0].errors.size());
+    ASSERT_EQ(1, results[1].errors.size());
+    ASSERT_NE(std::string::npos, results[1].errors[0].find("Generated invalid LLVM IR"));
+    ASSERT_TRUE(readFile("batch_arity.ll").empty());
+    ASSERT_TRUE(results[2].errors.empty());
+    ASSERT_NE(std::string::npos, readFile("batch_fine.ll").find("call i32 @putchar(i32 97)"));
+}
+
+TEST(Batch, ExpandsResponseFiles) {
+    writeFile("batch_inputs.txt", "first.sane\n\n  second.sane \n");
+
+    ASSERT_EQ(std::vector<std::string>({ "zeroth.sane", "first.sane", "second.sane" }),
+        Batch::expand({ "zeroth.sane", "@batch_inputs.txt" }));
+    ASSERT_THROW(Batch::expand({ "@batch_missing.txt" }), FileNotFoundException);
+}
+
+TEST(Batch, NamesOutputsAfterInputs) {
+    Batch::Options options;
+    ASSERT_EQ("src/hello.ll", Batch::outputPath("src/hello.sane", options));
+
+    options.format = Emitter::OBJECT;
+    options.outputDirectory = "out";
+    ASSERT_EQ("out/hello.o", Batch::outputPath("src/hello.sane", options));
+}
+
+TEST(Batch, ThrowsIllegalStateExceptionOnInputsWithTheSameOutput) {
+    Batch::Options options;
+    options.outputDirectory = "out";
+    ThreadPool pool(1);
+
+    ASSERT_THROW(Batch::compile({ "a/hello.sane", "b/hello.sane" }, options, pool), IllegalStateException);
+}
+
+TEST(Batch, ThrowsIllegalStateExceptionOnOutputsOverwritingInputs) {
+    writeFile("batch_source.ll", "Not to be overwritten.");
+    Batch::Options options;
+    ThreadPool pool(1);
+
+    ASSERT_THROW(Batch::compile({ "batch_source.ll" }, options, pool), IllegalStateException);
+    ASSERT_THROW(Batch::compile({ "batch_other.sane", "./batch_other.ll" }, options, pool), IllegalStateException);
+    options.outputDirectory = "out/..";
+    ASSERT_THROW(Batch::compile({ "src/batch_source.sane", "batch_source.ll" }, options, pool), IllegalStateException);
+    ASSERT_EQ("Not to be overwritten.", readFile("batch_source.ll"));
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "emitter.h"
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "compiler/models/exceptions.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+namespace {
+    // Name of each Format, in the order they are declared.
+    const char* const FORMAT_NAMES[] = { "llvm-ir", "bitcode", "asm", "obj" };
+    const char* const FORMAT_EXTENSIONS[] = { ".ll", ".bc", ".s", ".o" };
+}
+
+std::experimental::optional<Emitter::Format> Emitter::format(const std::experimental::string_view name) {
+    for (uint8_t format = LLVM_IR; format <= OBJECT; ++format) {
+        if (name == FORMAT_NAMES[format]) return (Format) format;
+    }
+
+    return std::experimental::nullopt;
+}
+
+const char* Emitter::extension(const Format format) {
+    return FORMAT_EXTENSIONS[format];
+}
+
+void Emitter::emit(llvm::Module& module, const Format format, llvm::TargetMachine& machine,
+        llvm::raw_ostream& stream) {
+    switch (format) {
+        case LLVM_IR:
+            module.print(stream, nullptr);
+            return;
+        case BITCODE:
+            llvm::WriteBitcodeToFile(&module, stream);
+            return;
+        case ASSEMBLY:
+        case OBJECT:
+            break;
+    }
+
+    module.setTargetTriple(machine.getTargetTriple().str());
+    module.setDataLayout(machine.createDataLayout());
+
+    // Generate the code into memory first, since writing an object file may seek back into it, which pipes cannot do.
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream output(buffer);
+    llvm::legacy::PassManager passes;
+    const llvm::TargetMachine::CodeGenFileType type = format == ASSEMBLY
+        ? llvm::TargetMachine::CGFT_AssemblyFile : llvm::TargetMachine::CGFT_ObjectFile;
+    if (machine.addPassesToEmitFile(passes, output, type)) {
+        throw IllegalStateException("Cannot emit " + std::string(FORMAT_NAMES[format]) + " for "
+            + machine.getTargetTriple().str() + ".");
+    }
+    passes.run(module);
+
+    stream.write(buffer.data(), buffer.size());
+}
\ No newline at end of file
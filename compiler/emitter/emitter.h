@@ -0,0 +1,44 @@
+#ifndef SANITY_EMITTER_H
+#define SANITY_EMITTER_H
+
+#include <cstdint>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+/**
+ * Writes out compiled modules. Assembly and object files are generated in-process by a TargetMachine for the host, so
+ * building a program takes neither printing its IR as text and parsing it back nor launching a separate code generator.
+ */
+namespace Emitter {
+    enum Format : uint8_t {
+        LLVM_IR, // Textual LLVM IR.
+        BITCODE, // Binary LLVM IR.
+        ASSEMBLY, // Assembly for the host.
+        OBJECT, // Object file for the host.
+    };
+
+    /**
+     * Returns the Format of the given name, which is one of "llvm-ir", "bitcode", "asm" or "obj", or
+     * std::experimental::nullopt if there is none by that name.
+     */
+    std::experimental::optional<Format> format(std::experimental::string_view name);
+
+    /**
+     * Returns the extension of files in the given Format, including its leading dot, such as ".ll" for LLVM_IR.
+     */
+    const char* extension(Format format);
+
+    /**
+     * Writes the given module to the given stream in the given Format. Assembly and object files are generated by the
+     * given machine, such as the one from Optimizer::hostMachine() the module was optimized for, and the module is
+     * retargeted at it to generate them. Safe to call from multiple threads as long as each emits a module of a
+     * separate LLVMContext with a machine of its own.
+     * @throws IllegalStateException if the machine cannot generate code in the Format.
+     */
+    void emit(llvm::Module& module, Format format, llvm::TargetMachine& machine, llvm::raw_ostream& stream);
+}
+
+#endif //SANITY_EMITTER_H
\ No newline at end of file
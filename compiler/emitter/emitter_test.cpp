@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "emitter.h"
+#include "compiler/generator/generator.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/symbol.h"
+#include "compiler/optimizer/optimizer.h"
+#include "compiler/utils/arena.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Generates "extern putchar: (int) -> int; putchar('a');" in the module of the given session, then emits it in the
+// given Format with a machine for the host at the given optimization level.
+std::string emitModule(CompilationSession& session, const Emitter::Format format, const unsigned optLevel = 0) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const AST::FunctionPrototype proto(arena.list(std::vector<const AST::Type*>({ &integer })), &integer);
+    const AST::Function putchar(Symbols::intern("putchar"), &proto);
+    const AST::CharLiteral letter('a');
+    const AST::FunctionCall call(Symbols::intern("putchar"),
+        arena.list(std::vector<const AST::Expression*>({ &letter })));
+    const AST::StatementExpression stmt(&call);
+    Generator::gen(session, AST::File(arena.list(std::vector<const AST::Function*>({ &putchar })),
+        arena.list(std::vector<const AST::Statement*>({ &stmt }))));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    Emitter::emit(*session.module, format, *Optimizer::hostMachine(optLevel), ss);
+    return ss.str();
+}
+
+TEST(Emitter, ParsesFormatNames) {
+    ASSERT_EQ(Emitter::LLVM_IR, Emitter::format("llvm-ir").value());
+    ASSERT_EQ(Emitter::BITCODE, Emitter::format("bitcode").value());
+    ASSERT_EQ(Emitter::ASSEMBLY, Emitter::format("asm").value());
+    ASSERT_EQ(Emitter::OBJECT, Emitter::format("obj").value());
+    ASSERT_FALSE(Emitter::format("exe"));
+}
+
+TEST(Emitter, NamesExtensionOfEachFormat) {
+    ASSERT_STREQ(".ll", Emitter::extension(Emitter::LLVM_IR));
+    ASSERT_STREQ(".bc", Emitter::extension(Emitter::BITCODE));
+    ASSERT_STREQ(".s", Emitter::extension(Emitter::ASSEMBLY));
+    ASSERT_STREQ(".o", Emitter::extension(Emitter::OBJECT));
+}
+
+TEST(Emitter, EmitsLLVMIR) {
+    CompilationSession session("Emitter Test");
+    const std::string ir = emitModule(session, Emitter::LLVM_IR);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    session.module->print(ss, nullptr);
+    ASSERT_EQ(ss.str(), ir);
+}
+
+TEST(Emitter, EmitsBitcode) {
+    CompilationSession session("Emitter Test");
+    ASSERT_EQ(0, emitModule(session, Emitter::BITCODE).find("BC\xC0\xDE"));
+}
+
+TEST(Emitter, EmitsAssemblyForHost) {
+    CompilationSession session("Emitter Test");
+    const std::string assembly = emitModule(session, Emitter::ASSEMBLY);
+
+    ASSERT_NE(std::string::npos, assembly.find("main:"));
+    ASSERT_NE(std::string::npos, assembly.find("putchar"));
+    ASSERT_FALSE(session.module->getTargetTriple().empty());
+}
+
+TEST(Emitter, EmitsObjectFileForHost) {
+    for (unsigned optLevel = 0; optLevel <= 3; ++optLevel) {
+        CompilationSession session("Emitter Test");
+        const std::string object = emitModule(session, Emitter::OBJECT, optLevel);
+
+        ASSERT_EQ(0, object.find("\x7F" "ELF"));
+    }
+}
\ No newline at end of file
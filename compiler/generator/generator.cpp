@@ -1,68 +1,200 @@
 #include "generator.h"
 
-#include <memory>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
 #include <vector>
+#include <experimental/string_view>
 #include <llvm/IR/Verifier.h>
 #include "llvm/ADT/APInt.h"
+#include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Value.h"
 #include "compiler/models/ast.h"
+#include "compiler/models/ast_interner.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/diagnostics.h"
 #include "compiler/models/exceptions.h"
-#include "compiler/models/globals.h"
+#include "compiler/models/flat_ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
 
 typedef Exceptions::AssertionException AssertionException;
-typedef Exceptions::RedeclaredException RedeclaredException;
-typedef Exceptions::TypeException TypeException;
-typedef Exceptions::UndeclaredException UndeclaredException;
 
 const int CHAR_BIT_SIZE = 32; // putchar() uses int32 rather than int8.
 const int INTEGER_BIT_SIZE = 32;
 
-llvm::Function* Generator::gen(const AST::File& file) {
-    return Generator().generate(file);
+llvm::Function* Generator::gen(CompilationSession& session, const AST::File& file) {
+    return Generator(session).generate(file);
 }
 
-llvm::Value* Generator::generate(const AST::AddOpExpression& addition) {
-    llvm::Value* left = addition.leftExpr->generate(*this);
-    llvm::Value* right = addition.rightExpr->generate(*this);
+llvm::Function* Generator::gen(CompilationSession& session, const AST::File& file, const AST::Interner& interner) {
+    return Generator(session, interner).generate(file);
+}
 
-    return builder.CreateAdd(left, right, "addtmp");
+llvm::Function* Generator::gen(CompilationSession& session, const FlatAST::File& file) {
+    return Generator(session).generate(file);
 }
 
-llvm::Value* Generator::generate(const AST::SubOpExpression& subtraction) {
-    llvm::Value* left = subtraction.leftExpr->generate(*this);
-    llvm::Value* right = subtraction.rightExpr->generate(*this);
+llvm::Function* Generator::gen(CompilationSession& session, const FlatAST::File& file, Diagnostics& diagnostics) {
+    return Generator(session, nullptr, &diagnostics).generate(file);
+}
+
+Generator::Generator(CompilationSession& session) : Generator(session, nullptr, nullptr) { }
+
+Generator::Generator(CompilationSession& session, const AST::Interner& interner)
+    : Generator(session, &interner, nullptr) { }
 
-    return builder.CreateSub(left, right, "subtmp");
+Generator::Generator(CompilationSession& session, const AST::Interner* interner, Diagnostics* diagnostics)
+    : session(session), interner(interner), diagnostics(diagnostics) { }
+
+llvm::Function* Generator::gen(CompilationSession& session, const AST::File& file, Diagnostics& diagnostics) {
+    return Generator(session, nullptr, &diagnostics).generate(file);
 }
 
-llvm::Value* Generator::generate(const AST::MulOpExpression& multiplication) {
-    llvm::Value* left = multiplication.leftExpr->generate(*this);
-    llvm::Value* right = multiplication.rightExpr->generate(*this);
+// Throws the exception of the given kind of error, or reports it to the Diagnostics if there are any.
+void Generator::fail(const Diagnostic::Kind kind, const std::string& message) {
+    Diagnostic diagnostic(kind, message);
+    if (!this->diagnostics) diagnostic.raise();
 
-    return builder.CreateMul(left, right, "multmp");
+    this->diagnostics->report(std::move(diagnostic));
 }
 
-llvm::Value* Generator::generate(const AST::DivOpExpression& division) {
-    llvm::Value* left = division.leftExpr->generate(*this);
-    llvm::Value* right = division.rightExpr->generate(*this);
+// Returns whether the given kind of expression is a binary operation, which an Interner may share.
+static bool isOperation(const FlatAST::Kind kind) {
+    return kind == FlatAST::ADD_OP || kind == FlatAST::SUB_OP || kind == FlatAST::MUL_OP || kind == FlatAST::DIV_OP;
+}
+
+// Generates the given expression over an explicit stack rather than by recursion, so however deeply it is nested it
+// cannot overflow the native one. Returns null if it failed and the error was reported to the Diagnostics.
+llvm::Value* Generator::expression(const AST::Expression& expr) {
+    this->operandValues.clear();
+    this->failed = false;
+    AST::walk(expr, *this);
+
+    return this->failed ? nullptr : this->operandValues.back();
+}
+
+// Skips the operands of a shared operation which was generated before, reusing its value, and of a call to a function
+// which is not declared. Nothing else is generated once an expression has failed.
+bool Generator::enter(const AST::Expression& expr) {
+    if (this->failed) return false;
+
+    if (this->interner && isOperation(expr.kind()) && this->interner->shared(&expr)) {
+        const auto generated = this->sharedValues.find(&expr);
+        if (generated != this->sharedValues.end()) {
+            this->operandValues.push_back(generated->second);
+            return false;
+        }
+    }
+
+    if (expr.kind() == FlatAST::FUNCTION_CALL) {
+        const Symbol callee = static_cast<const AST::FunctionCall&>(expr).callee;
+        if (this->functions.find(callee) == this->functions.end()) {
+            this->fail(Diagnostic::UNDECLARED,
+                "Function \"" + Symbols::name(callee).to_string() + "\" not declared in this scope.");
+            this->failed = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Generator::between(const AST::Expression& expr) { }
+
+// Generates the given expression from the values of its operands, which are the last ones walked.
+void Generator::leave(const AST::Expression& expr) {
+    if (this->failed) return;
+
+    llvm::Value* value;
+    switch (expr.kind()) {
+        case FlatAST::ADD_OP:
+            value = this->operation([this](llvm::Value* left, llvm::Value* right) {
+                return this->session.builder.CreateAdd(left, right, "addtmp");
+            });
+            break;
+        case FlatAST::SUB_OP:
+            value = this->operation([this](llvm::Value* left, llvm::Value* right) {
+                return this->session.builder.CreateSub(left, right, "subtmp");
+            });
+            break;
+        case FlatAST::MUL_OP:
+            value = this->operation([this](llvm::Value* left, llvm::Value* right) {
+                return this->session.builder.CreateMul(left, right, "multmp");
+            });
+            break;
+        case FlatAST::DIV_OP:
+            value = this->operation([this](llvm::Value* left, llvm::Value* right) {
+                return this->session.builder.CreateSDiv(left, right, "divtmp");
+            });
+            break;
+        case FlatAST::FUNCTION_CALL: {
+            const auto& call = static_cast<const AST::FunctionCall&>(expr);
+            const std::vector<llvm::Value*> arguments(this->operandValues.end() - call.arguments.size(),
+                this->operandValues.end());
+            this->operandValues.resize(this->operandValues.size() - call.arguments.size());
+            value = this->session.builder.CreateCall(this->functions.at(call.callee), arguments);
+            break;
+        }
+        default:
+            // Anything else has no operands, so is generated directly.
+            value = expr.generate(*this);
+            break;
+    }
+
+    if (!value) {
+        this->failed = true;
+        return;
+    }
+
+    if (this->interner && isOperation(expr.kind()) && this->interner->shared(&expr)) {
+        this->sharedValues.emplace(&expr, value);
+    }
+    this->operandValues.push_back(value);
+}
+
+// Generates a binary operation by passing the values of its operands, the last two walked, to the given function.
+template <typename Create>
+llvm::Value* Generator::operation(const Create create) {
+    llvm::Value* right = this->operandValues.back();
+    this->operandValues.pop_back();
+    llvm::Value* left = this->operandValues.back();
+    this->operandValues.pop_back();
+
+    return create(left, right);
+}
+
+llvm::Value* Generator::generate(const AST::AddOpExpression& addition) {
+    return this->expression(addition);
+}
+
+llvm::Value* Generator::generate(const AST::SubOpExpression& subtraction) {
+    return this->expression(subtraction);
+}
+
+llvm::Value* Generator::generate(const AST::MulOpExpression& multiplication) {
+    return this->expression(multiplication);
+}
 
-    return builder.CreateSDiv(left, right, "divtmp");
+llvm::Value* Generator::generate(const AST::DivOpExpression& division) {
+    return this->expression(division);
 }
 
 llvm::IntegerType* Generator::generate(const AST::IntegerType& integer) {
-    return llvm::IntegerType::getInt32Ty(*context);
+    return llvm::IntegerType::getInt32Ty(this->session.context);
 }
 
 llvm::PointerType* Generator::generate(const AST::StringType& string) {
-    return llvm::PointerType::getInt8PtrTy(*context);
+    return llvm::PointerType::getInt8PtrTy(this->session.context);
 }
 
 llvm::FunctionType* Generator::generate(const AST::FunctionPrototype& prototype) {
@@ -76,8 +208,18 @@ llvm::FunctionType* Generator::generate(const AST::FunctionPrototype& prototype)
 }
 
 llvm::Function* Generator::generate(const AST::Function& func) {
-    llvm::FunctionType* type = func.type->generate(*this);
-    return llvm::Function::Create(type, llvm::Function::ExternalLinkage, func.name, module.get());
+    return this->function(func.name, func.type->generate(*this));
+}
+
+// Creates a function of the given name and type in the module.
+llvm::Function* Generator::function(const Symbol name, llvm::FunctionType* type) {
+    const std::experimental::string_view text = Symbols::name(name);
+    llvm::Function* function = llvm::Function::Create(type, llvm::Function::ExternalLinkage,
+        llvm::StringRef(text.data(), text.size()), this->session.module.get());
+
+    // Like the module, calls resolve to the first declaration of a name.
+    this->functions.emplace(name, function);
+    return function;
 }
 
 void Generator::generate(const AST::StatementExpression& stmt) {
@@ -85,78 +227,290 @@ void Generator::generate(const AST::StatementExpression& stmt) {
 }
 
 void Generator::generate(const AST::StatementLet& stmt) {
-    if (namedValues[stmt.name]) {
-        throw RedeclaredException("Variable \"" + stmt.name + "\" already declared in this scope.");
+    if (this->session.namedValues[stmt.name]) {
+        this->fail(Diagnostic::REDECLARED,
+            "Variable \"" + Symbols::name(stmt.name).to_string() + "\" already declared in this scope.");
+        return;
     }
 
     llvm::Value* value = stmt.expr->generate(*this);
+    if (!value) return;
+
     llvm::Type* type = stmt.type->generate(*this);
-    if (value->getType() != type) throw TypeException("Type mismatch");
+    if (value->getType() != type) {
+        this->fail(Diagnostic::TYPE, "Type mismatch");
+        return;
+    }
+
+    this->define(stmt.name, value);
+}
 
-    namedValues[stmt.name] = value;
+// Declares the given variable. If statements are being outlined, it is also stored in an internal global for later
+// chunks to load, right away so its value need not be kept alive until the end of the chunk. Constants can be used from
+// any function, so they are passed on as they are.
+void Generator::define(const Symbol name, llvm::Value* value) {
+    this->session.namedValues[name] = value;
+    if (!this->chunk || !llvm::isa<llvm::Instruction>(value)) return;
+
+    const std::experimental::string_view text = Symbols::name(name);
+    llvm::GlobalVariable* global = new llvm::GlobalVariable(*this->session.module, value->getType(),
+        false /* isConstant */, llvm::GlobalValue::InternalLinkage, llvm::Constant::getNullValue(value->getType()),
+        llvm::StringRef(text.data(), text.size()));
+    this->session.builder.CreateStore(value, global);
+
+    this->escapedValues.emplace(name, global);
+    this->loadedValues.emplace(name, value);
 }
 
 llvm::Function* Generator::generate(const AST::File& file) {
     for (const auto& func : file.funcs) {
-        func->generate(*this);
+        this->declare(*func);
     }
 
-    // Stub a main function because one is required.
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>();
-    const auto returnType = std::make_shared<AST::IntegerType>(AST::IntegerType());
-    const auto mainProto = std::make_shared<const AST::FunctionPrototype>(AST::FunctionPrototype(params, returnType));
-    const AST::Function mainFunc("main", mainProto);
-    llvm::Function* main = mainFunc.generate(*this);
+    // Generate the body of the main function.
+    for (const auto& stmt : file.statements) {
+        this->append(*stmt);
+    }
+
+    return this->finish();
+}
+
+// Stubs the main function, because one is required, and starts inserting into it.
+llvm::Function* Generator::startMain() {
+    if (this->main) return this->main;
+
+    const AST::IntegerType returnType;
+    const AST::FunctionPrototype mainProto(ArenaList<const AST::Type*>(), &returnType);
+    const AST::Function mainFunc(Symbols::intern("main"), &mainProto);
+    this->main = mainFunc.generate(*this);
 
     // Create a new basic block to start insertion into.
-    llvm::BasicBlock* bb = llvm::BasicBlock::Create(*context, "entry", main);
-    builder.SetInsertPoint(bb);
+    llvm::BasicBlock* bb = llvm::BasicBlock::Create(this->session.context, "entry", this->main);
+    this->session.builder.SetInsertPoint(bb);
 
-    // Generate the body of the main function.
-    for (const auto& stmt : file.statements) {
-        stmt->generate(*this);
+    return this->main;
+}
+
+void Generator::outline(const size_t instructions) {
+    this->chunkLimit = instructions;
+}
+
+// Starts inserting the next top-level statement, outlining it into a new chunk if the open one is full.
+void Generator::startStatement() {
+    this->startMain();
+    if (this->chunkLimit == 0) return;
+
+    if (this->chunk) {
+        // Chunks only grow at their end, so only the instructions added since the last statement need counting.
+        const llvm::BasicBlock& block = this->chunk->getEntryBlock();
+        auto instruction = this->counted ? std::next(this->counted->getIterator()) : block.begin();
+        for (; instruction != block.end(); ++instruction) ++this->chunkInstructions;
+        if (!block.empty()) this->counted = &block.back();
+        if (this->chunkInstructions < this->chunkLimit) return;
+
+        this->endChunk();
+    }
+    this->startChunk();
+}
+
+// Creates the next chunk, calls it from main and starts inserting into it.
+void Generator::startChunk() {
+    llvm::FunctionType* type = llvm::FunctionType::get(llvm::Type::getVoidTy(this->session.context),
+        false /* isVarArgs */);
+    this->chunk = llvm::Function::Create(type, llvm::Function::InternalLinkage,
+        "main.chunk" + std::to_string(this->chunkCount++), this->session.module.get());
+    this->chunk->addFnAttr(llvm::Attribute::NoInline); // Each chunk is called once, so would be inlined straight back.
+    this->chunkInstructions = 0;
+    this->counted = nullptr;
+
+    this->session.builder.SetInsertPoint(&this->main->getEntryBlock());
+    this->session.builder.CreateCall(this->chunk);
+    this->session.builder.SetInsertPoint(llvm::BasicBlock::Create(this->session.context, "entry", this->chunk));
+}
+
+// Returns from the open chunk. Values generated in it cannot be used from the next one, including shared operations.
+void Generator::endChunk() {
+    this->session.builder.CreateRetVoid();
+    llvm::verifyFunction(*this->chunk);
+
+    this->chunk = nullptr;
+    this->loadedValues.clear();
+    this->sharedValues.clear();
+}
+
+void Generator::declare(const AST::Function& func) {
+    this->place(func.generate(*this));
+}
+
+// Keeps every declaration ahead of main, where it would be if all of them were declared before main was started.
+void Generator::place(llvm::Function* function) {
+    if (this->main) {
+        function->removeFromParent();
+        this->session.module->getFunctionList().insert(this->main->getIterator(), function);
+    }
+}
+
+void Generator::append(const AST::Statement& stmt) {
+    this->startStatement();
+    stmt.generate(*this);
+}
+
+llvm::Function* Generator::finish() {
+    llvm::Function* main = this->startMain();
+    if (this->chunk) {
+        this->endChunk();
+        this->session.builder.SetInsertPoint(&main->getEntryBlock());
     }
 
     // Return 0 always
     llvm::APInt retVal(INTEGER_BIT_SIZE, (uint32_t) 0, true /* signed */);
-    builder.CreateRet(llvm::ConstantInt::get(*context, retVal));
+    this->session.builder.CreateRet(llvm::ConstantInt::get(this->session.context, retVal));
 
     llvm::verifyFunction(*main);
     return main;
 }
 
+llvm::Function* Generator::generate(const FlatAST::File& file) {
+    for (const FlatAST::Node func : file.funcs()) {
+        this->place(this->function(file.lhs(func), (llvm::FunctionType*) this->type(file, file.rhs(func))));
+    }
+
+    // The nodes of each statement directly follow those of the element before it, ending with the statement itself.
+    // Only the values of the current statement's nodes are kept, so they stay in cache however large the File is.
+    std::vector<llvm::Value*> values;
+    FlatAST::Node first = file.funcs().empty() ? 0 : file.funcs().back() + 1;
+    for (const FlatAST::Node stmt : file.statements()) {
+        const FlatAST::Node start = first;
+        first = stmt + 1;
+
+        this->startStatement();
+        const bool let = file.kind(stmt) == FlatAST::STATEMENT_LET;
+        if (let && this->session.namedValues[file.lhs(stmt)]) {
+            this->fail(Diagnostic::REDECLARED,
+                "Variable \"" + Symbols::name(file.lhs(stmt)).to_string() + "\" already declared in this scope.");
+            continue;
+        }
+
+        // Like the tree form, a statement stops being generated at its first error.
+        values.resize(stmt - start);
+        bool failed = false;
+        for (FlatAST::Node node = start; node < stmt && !failed; ++node) {
+            values[node - start] = this->value(file, node, start, values);
+            failed = !values[node - start] && FlatAST::isExpression(file.kind(node));
+        }
+        if (failed || !let) continue;
+
+        llvm::Value* value = values[file.extra(file.rhs(stmt) + 1) - start];
+        if (value->getType() != this->type(file, file.extra(file.rhs(stmt)))) {
+            this->fail(Diagnostic::TYPE, "Type mismatch");
+            continue;
+        }
+
+        this->define(file.lhs(stmt), value);
+    }
+
+    return this->finish();
+}
+
+// Returns the LLVM type of the given type node.
+llvm::Type* Generator::type(const FlatAST::File& file, const FlatAST::Node node) {
+    switch (file.kind(node)) {
+        case FlatAST::INTEGER_TYPE:
+            return this->generate(AST::IntegerType());
+        case FlatAST::STRING_TYPE:
+            return this->generate(AST::StringType());
+        case FlatAST::FUNCTION_PROTOTYPE: {
+            std::vector<llvm::Type*> parameterTypes;
+            for (const FlatAST::Node param : file.list(file.rhs(node))) {
+                parameterTypes.push_back(this->type(file, param));
+            }
+            llvm::Type* returnType = this->type(file, file.lhs(node));
+
+            return llvm::FunctionType::get(returnType, parameterTypes, false /* isVarArgs */);
+        }
+        default:
+            throw AssertionException("Expected a type, but got node of kind " + std::to_string(file.kind(node)) + ".");
+    }
+}
+
+// Generates the given expression node from the values of its children, where values holds the value of each node from
+// first onwards. Any other kind of node has no value.
+llvm::Value* Generator::value(const FlatAST::File& file, const FlatAST::Node node, const FlatAST::Node first,
+        const std::vector<llvm::Value*>& values) {
+    const auto valueOf = [&file, first, &values](const uint32_t child) { return values[child - first]; };
+
+    switch (file.kind(node)) {
+        case FlatAST::ADD_OP:
+            return this->session.builder.CreateAdd(valueOf(file.lhs(node)), valueOf(file.rhs(node)), "addtmp");
+        case FlatAST::SUB_OP:
+            return this->session.builder.CreateSub(valueOf(file.lhs(node)), valueOf(file.rhs(node)), "subtmp");
+        case FlatAST::MUL_OP:
+            return this->session.builder.CreateMul(valueOf(file.lhs(node)), valueOf(file.rhs(node)), "multmp");
+        case FlatAST::DIV_OP:
+            return this->session.builder.CreateSDiv(valueOf(file.lhs(node)), valueOf(file.rhs(node)), "divtmp");
+        case FlatAST::CHAR_LITERAL:
+            return this->generate(AST::CharLiteral((char) file.lhs(node)));
+        case FlatAST::INTEGER_LITERAL:
+            return this->generate(AST::IntegerLiteral((int32_t) file.lhs(node)));
+        case FlatAST::STRING_LITERAL:
+            return this->generate(AST::StringLiteral(file.text(node)));
+        case FlatAST::FUNCTION_CALL: {
+            const auto func = this->functions.find(file.lhs(node));
+            if (func == this->functions.end()) {
+                this->fail(Diagnostic::UNDECLARED,
+                    "Function \"" + Symbols::name(file.lhs(node)).to_string() + "\" not declared in this scope.");
+                return nullptr;
+            }
+
+            std::vector<llvm::Value*> arguments;
+            for (const FlatAST::Node arg : file.list(file.rhs(node))) {
+                arguments.push_back(valueOf(arg));
+            }
+
+            return this->session.builder.CreateCall(func->second, arguments);
+        }
+        case FlatAST::IDENTIFIER_EXPR:
+            return this->generate(AST::IdentifierExpr(file.lhs(node)));
+        default:
+            return nullptr;
+    }
+}
+
 llvm::Value* Generator::generate(const AST::CharLiteral& literal) {
     llvm::APInt llvmInt(CHAR_BIT_SIZE, (uint64_t) literal.value, true /* signed */);
-    return llvm::ConstantInt::get(*context, llvmInt);
+    return llvm::ConstantInt::get(this->session.context, llvmInt);
 }
 
 llvm::Value* Generator::generate(const AST::IntegerLiteral& literal) {
     llvm::APInt llvmInt(INTEGER_BIT_SIZE, (uint64_t) literal.value, true /* signed */);
-    return llvm::ConstantInt::get(*context, llvmInt);
+    return llvm::ConstantInt::get(this->session.context, llvmInt);
 }
 
 llvm::Value* Generator::generate(const AST::StringLiteral& literal) {
-    return builder.CreateGlobalStringPtr(literal.value, "globalstr");
+    return this->session.builder.CreateGlobalStringPtr(llvm::StringRef(literal.value.data(), literal.value.size()),
+        "globalstr");
 }
 
-// Generate a call to a function. Currently assumes it takes exactly one argument and the result is dropped because that
-// is all a "Hello World!" program with putchar() requires.
 llvm::CallInst* Generator::generate(const AST::FunctionCall& call) {
-    llvm::Function* func = module->getFunction(call.callee);
-
-    if (!func) throw UndeclaredException("Function \"" + call.callee + "\" not declared in this scope.");
-
-    std::vector<llvm::Value*> arguments;
-    for (const auto& arg : call.arguments) {
-        arguments.push_back(arg->generate(*this));
-    }
-
-    return builder.CreateCall(func, arguments);
+    return llvm::cast_or_null<llvm::CallInst>(this->expression(call));
 }
 
 llvm::Value* Generator::generate(const AST::IdentifierExpr& identifier) {
-    llvm::Value* value = namedValues[identifier.name];
-    if (!value) throw UndeclaredException("Variable \"" + identifier.name + "\" not declared in this scope.");
+    llvm::Value* value = this->session.namedValues[identifier.name];
+    if (!value) {
+        this->fail(Diagnostic::UNDECLARED,
+            "Variable \"" + Symbols::name(identifier.name).to_string() + "\" not declared in this scope.");
+        return nullptr;
+    }
 
-    return value;
+    // A variable declared in an earlier chunk is loaded from the global it was passed on through.
+    const auto escaped = this->escapedValues.find(identifier.name);
+    if (escaped == this->escapedValues.end()) return value;
+
+    llvm::Value*& loaded = this->loadedValues[identifier.name];
+    if (!loaded) {
+        loaded = this->session.builder.CreateLoad(escaped->second->getValueType(), escaped->second,
+            escaped->second->getName());
+    }
+    return loaded;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define SANITY_SANITY_GENERATOR_H
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
@@ -10,16 +12,137 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
 #include "../models/ast.h"
+#include "../models/ast_interner.h"
+#include "../models/compilation_session.h"
+#include "../models/diagnostics.h"
+#include "../models/flat_ast.h"
+#include "../models/symbol.h"
 
 /**
  * Visitor class for the AST models which generates LLVM IR objects based on the abstract syntax tree.
  */
-class Generator : public AST::IGenerator {
-protected:
-    Generator() = default;
+class Generator : public AST::IGenerator, private AST::IExpressionWalker {
+private:
+    // Session owning the module generated into, along with the context, builder and variables it is generated with.
+    CompilationSession& session;
+
+    // Functions declared so far, so calls can look them up by Symbol rather than by name in the module.
+    std::unordered_map<Symbol, llvm::Function*> functions;
+
+    // Function which the top-level statements are generated into, only created once it is needed.
+    llvm::Function* main = nullptr;
+
+    // Interner the AST was constructed with, if any, along with the value generated for each of its shared operations.
+    // Statements all go into one block and variables cannot be redeclared, so a shared operation has the same value
+    // wherever it appears after it was first generated, at least until statements move on to the next chunk.
+    const AST::Interner* interner = nullptr;
+    std::unordered_map<const AST::Expression*, llvm::Value*> sharedValues;
+
+    // Collects errors rather than throwing them when set.
+    Diagnostics* diagnostics = nullptr;
+
+    // When non-zero, top-level statements are outlined into chunk functions of about this many instructions each, which
+    // main calls in order. Only the chunk being filled is ever open, along with how many instructions it holds so far,
+    // counted up to the last one seen.
+    size_t chunkLimit = 0;
+    size_t chunkCount = 0;
+    llvm::Function* chunk = nullptr;
+    size_t chunkInstructions = 0;
+    const llvm::Instruction* counted = nullptr;
+
+    // Internal globals through which variables are passed on to later chunks, since values cannot be used from another
+    // function, along with the value of each one in the open chunk. Each global is loaded at most once per chunk.
+    std::unordered_map<Symbol, llvm::GlobalVariable*> escapedValues;
+    std::unordered_map<Symbol, llvm::Value*> loadedValues;
+
+    // Values of the expressions walked so far whose parents are not generated yet, and whether any of them failed.
+    std::vector<llvm::Value*> operandValues;
+    bool failed = false;
+
+    llvm::Function* startMain();
+    void startStatement();
+    void startChunk();
+    void endChunk();
+    void define(Symbol name, llvm::Value* value);
+    void fail(Diagnostic::Kind kind, const std::string& message);
+
+    llvm::Value* expression(const AST::Expression& expr);
+    bool enter(const AST::Expression& expr) override;
+    void between(const AST::Expression& expr) override;
+    void leave(const AST::Expression& expr) override;
+
+    template <typename Create>
+    llvm::Value* operation(Create create);
+
+    llvm::Function* function(Symbol name, llvm::FunctionType* type);
+    void place(llvm::Function* function);
+
+    llvm::Type* type(const FlatAST::File& file, FlatAST::Node node);
+    llvm::Value* value(const FlatAST::File& file, FlatAST::Node node, FlatAST::Node first,
+        const std::vector<llvm::Value*>& values);
 
 public:
-    static llvm::Function* gen(const AST::File& file);
+    /**
+     * Generates into the module of the given session, which must outlive the Generator.
+     */
+    explicit Generator(CompilationSession& session);
+
+    /**
+     * Generates the IR of each operation shared by the given Interner only once, reusing its value every other time the
+     * operation appears.
+     */
+    Generator(CompilationSession& session, const AST::Interner& interner);
+
+    /**
+     * Generates with the given Interner, as above, unless it is null. Errors are reported to the given Diagnostics
+     * rather than thrown unless they are null too. A statement with an error is skipped, so a single run reports the
+     * errors of every statement, but the IR generated alongside errors is incomplete and should be discarded. Both the
+     * tree and flat forms of an AST report the same errors.
+     */
+    Generator(CompilationSession& session, const AST::Interner* interner, Diagnostics* diagnostics);
+
+    /**
+     * Outlines the top-level statements generated from now on into internal functions of about the given number of
+     * instructions each, which main calls in order, rather than generating all of them into main. Optimizing and
+     * selecting instructions for a function costs more than linearly in its size, so bounded chunks keep the cost of
+     * compiling huge sources linear, and the chunks can be compiled independently of each other. Zero stops outlining.
+     */
+    void outline(size_t instructions);
+
+    static llvm::Function* gen(CompilationSession& session, const AST::File& file);
+    static llvm::Function* gen(CompilationSession& session, const AST::File& file, const AST::Interner& interner);
+    static llvm::Function* gen(CompilationSession& session, const AST::File& file, Diagnostics& diagnostics);
+    static llvm::Function* gen(CompilationSession& session, const FlatAST::File& file);
+    static llvm::Function* gen(CompilationSession& session, const FlatAST::File& file, Diagnostics& diagnostics);
+
+    /**
+     * Declares the given extern function. Functions declared after the main function has been started are still placed
+     * before it in the module, so generating a File one element at a time produces the same IR as generating it whole.
+     */
+    void declare(const AST::Function& func);
+
+    /**
+     * Generates the given top-level statement at the end of the main function, or of its last chunk if outlining.
+     * @throws RedeclaredException
+     * @throws TypeException
+     * @throws UndeclaredException
+     */
+    void append(const AST::Statement& stmt);
+
+    /**
+     * Finishes and returns the main function once every top-level element has been declared or appended.
+     */
+    llvm::Function* finish();
+
+    /**
+     * Generates the given File in its flat form, walking its nodes in the order they are stored so the value of each
+     * expression is ready by the time its parent needs it. Produces the same IR as generating the File it was
+     * flattened from.
+     * @throws RedeclaredException
+     * @throws TypeException
+     * @throws UndeclaredException
+     */
+    llvm::Function* generate(const FlatAST::File& file);
 
     llvm::Value* generate(const AST::AddOpExpression& addition) override;
     llvm::Value* generate(const AST::SubOpExpression& subtraction) override;
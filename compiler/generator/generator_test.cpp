@@ -1,28 +1,40 @@
 #include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
 #include "generator.h"
 #include "compiler/models/ast.h"
-#include "compiler/models/token_builder.h"
-#include "compiler/models/globals.h"
-#include "llvm/IR/IRBuilder.h"
-#include "llvm/IR/LLVMContext.h"
+#include "compiler/models/ast_interner.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/diagnostics.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/flat_ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
 
-// Declared in globals.h
-std::unique_ptr<llvm::LLVMContext> context = llvm::make_unique<llvm::LLVMContext>();
-llvm::IRBuilder<> builder(*context);
-std::unique_ptr<llvm::Module> module = llvm::make_unique<llvm::Module>("Generator Test", *context);
-std::map<std::string, llvm::Value*> namedValues;
+// Session shared by the tests which inspect the values generated rather than a whole module.
+CompilationSession sharedSession("Generator Test");
+
+typedef Exceptions::RedeclaredException RedeclaredException;
+typedef Exceptions::UndeclaredException UndeclaredException;
 
 // Extend Generator to get access to protected constructor.
-class GeneratorUnderTest : public Generator { };
+class GeneratorUnderTest : public Generator {
+public:
+    GeneratorUnderTest() : Generator(sharedSession) { }
+};
 
 TEST(Generator, GeneratesAddOpExpression) {
-    const auto leftValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto addition = AST::AddOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 1;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 2;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto addition = AST::AddOpExpression(&leftExpr, &rightExpr);
 
     const llvm::Value* sum = GeneratorUnderTest().generate(addition);
 
@@ -30,11 +42,11 @@ TEST(Generator, GeneratesAddOpExpression) {
 }
 
 TEST(Generator, GeneratesSubOpExpression) {
-    const auto leftValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto subtraction = AST::SubOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 2;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 1;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto subtraction = AST::SubOpExpression(&leftExpr, &rightExpr);
 
     const llvm::Value* difference = GeneratorUnderTest().generate(subtraction);
 
@@ -42,11 +54,11 @@ TEST(Generator, GeneratesSubOpExpression) {
 }
 
 TEST(Generator, GeneratesMulOpExpression) {
-    const auto leftValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("3").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto multiplication = AST::MulOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 2;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 3;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto multiplication = AST::MulOpExpression(&leftExpr, &rightExpr);
 
     const llvm::Value* product = GeneratorUnderTest().generate(multiplication);
 
@@ -54,11 +66,11 @@ TEST(Generator, GeneratesMulOpExpression) {
 }
 
 TEST(Generator, GeneratesDivOpExpression) {
-    const auto leftValue = TokenBuilder("6").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("3").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto division = AST::DivOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 6;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 3;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto division = AST::DivOpExpression(&leftExpr, &rightExpr);
 
     const llvm::Value* quotient = GeneratorUnderTest().generate(division);
 
@@ -66,11 +78,11 @@ TEST(Generator, GeneratesDivOpExpression) {
 }
 
 TEST(Generator, GeneratesFlooredDivExpression) {
-    const auto leftValue = TokenBuilder("8").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("3").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto division = AST::DivOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 8;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 3;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto division = AST::DivOpExpression(&leftExpr, &rightExpr);
 
     const llvm::Value* quotient = GeneratorUnderTest().generate(division);
 
@@ -90,72 +102,73 @@ TEST(Generator, GeneratesStringType) {
 }
 
 TEST(Generator, GeneratesFunctionPrototype) {
-    const auto integer = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ integer, integer });
-    const AST::FunctionPrototype proto(params, integer /* returnType */);
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer, &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
     const llvm::FunctionType* func = GeneratorUnderTest().generate(proto);
 
     ASSERT_EQ(2, func->getNumParams());
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), func->params()[0]);
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), func->params()[1]);
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), func->getReturnType());
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), func->params()[0]);
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), func->params()[1]);
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), func->getReturnType());
 }
 
 TEST(Generator, GeneratesFunction) {
-    const auto integer = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ integer, integer });
-    const auto proto = std::make_shared<const AST::FunctionPrototype>(AST::FunctionPrototype(
-            params, integer /* returnType */));
-    const AST::Function function("test", proto);
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer, &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function function(Symbols::intern("test"), &proto);
     const llvm::Function* func = GeneratorUnderTest().generate(function);
 
     ASSERT_EQ("test", func->getName().str());
 
     ASSERT_EQ(2, func->arg_size());
     auto argument = func->arg_begin();
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), argument->getType());
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), argument->getType());
     argument++;
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), argument->getType());
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), argument->getType());
     argument++;
 
-    ASSERT_EQ(llvm::IntegerType::getInt32Ty(*context), func->getReturnType());
+    ASSERT_EQ(llvm::IntegerType::getInt32Ty(sharedSession.context), func->getReturnType());
 }
 
 TEST(Generator, GeneratesStatementLet) {
-    const std::shared_ptr<const Token> nameToken = TokenBuilder("foo").build();
-    const auto type = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const std::shared_ptr<const Token> valueToken = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto expr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(valueToken));
-    const AST::StatementLet stmt(nameToken, type, expr);
+    const Symbol name = Symbols::intern("foo");
+    const AST::IntegerType type;
+    const int32_t literalValue = 1;
+    const AST::IntegerLiteral expr(literalValue);
+    const AST::StatementLet stmt(name, &type, &expr);
 
     GeneratorUnderTest().generate(stmt);
 
-    ASSERT_NE(nullptr, namedValues[nameToken->source]);
+    ASSERT_NE(nullptr, sharedSession.namedValues[name]);
 }
 
 TEST(Generator, GeneratesMainFromFile) {
-    const auto integer = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ integer });
-    const auto proto = std::make_shared<const AST::FunctionPrototype>(
-            AST::FunctionPrototype(params, integer /* returnType */));
-    const auto func = std::make_shared<const AST::Function>("test2", proto);
-
-    const std::shared_ptr<const Token> nameToken1 = TokenBuilder("test2").build();
-    const std::shared_ptr<const Token> charToken1 = TokenBuilder("a").setCharLiteral(true).build();
-    const auto arg1 = std::make_shared<const AST::CharLiteral>(charToken1);
-    const auto arguments1 = std::vector<std::shared_ptr<const AST::Expression>>({ arg1 });
-    const auto expr1 = std::make_shared<const AST::FunctionCall>(AST::FunctionCall(nameToken1, arguments1));
-    const auto stmt1 = std::make_shared<const AST::StatementExpression>(AST::StatementExpression(expr1));
-
-    const std::shared_ptr<const Token> nameToken2 = TokenBuilder("test2").build();
-    const std::shared_ptr<const Token> charToken2 = TokenBuilder("b").setCharLiteral(true).build();
-    const auto arg2 = std::make_shared<const AST::CharLiteral>(charToken2);
-    const auto arguments2 = std::vector<std::shared_ptr<const AST::Expression>>({ arg2 });
-    const auto expr2 = std::make_shared<const AST::FunctionCall>(AST::FunctionCall(nameToken2, arguments2));
-    const auto stmt2 = std::make_shared<const AST::StatementExpression>(AST::StatementExpression(expr2));
-
-    const AST::File file(std::vector<std::shared_ptr<const AST::Function>>({ func }),
-        std::vector<std::shared_ptr<const AST::Statement>>({ stmt1, stmt2 }));
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function func(Symbols::intern("test2"), &proto);
+
+    const Symbol name1 = Symbols::intern("test2");
+    const char charToken1 = 'a';
+    const AST::CharLiteral arg1(charToken1);
+    const auto arguments1 = arena.list(std::vector<const AST::Expression*>({ &arg1 }));
+    const AST::FunctionCall expr1(name1, arguments1);
+    const AST::StatementExpression stmt1(&expr1);
+
+    const Symbol name2 = Symbols::intern("test2");
+    const char charToken2 = 'b';
+    const AST::CharLiteral arg2(charToken2);
+    const auto arguments2 = arena.list(std::vector<const AST::Expression*>({ &arg2 }));
+    const AST::FunctionCall expr2(name2, arguments2);
+    const AST::StatementExpression stmt2(&expr2);
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &stmt1, &stmt2 })));
     const llvm::Function* main = GeneratorUnderTest().generate(file);
 
     ASSERT_EQ("main", main->getName());
@@ -163,24 +176,24 @@ TEST(Generator, GeneratesMainFromFile) {
 }
 
 TEST(Generator, GeneratesCharLiteral) {
-    const std::shared_ptr<const Token> token = TokenBuilder("a").setCharLiteral(true).build();
-    const auto charLiteral = AST::CharLiteral(token);
+    const char value = 'a';
+    const auto charLiteral = AST::CharLiteral(value);
     auto generated = (llvm::ConstantInt*) GeneratorUnderTest().generate(charLiteral);
 
     ASSERT_EQ((int64_t) 'a', generated->getValue().getSExtValue());
 }
 
 TEST(Generator, GeneratesIntegerLiteral) {
-    const std::shared_ptr<const Token> token = TokenBuilder("1234").setIntegerLiteral(true).build();
-    const auto integerLiteral = AST::IntegerLiteral(token);
+    const int32_t value = 1234;
+    const auto integerLiteral = AST::IntegerLiteral(value);
     auto generated = (llvm::ConstantInt*) GeneratorUnderTest().generate(integerLiteral);
 
     ASSERT_EQ((int64_t) 1234, generated->getValue().getSExtValue());
 }
 
 TEST(Generator, GeneratesStringLiteral) {
-    const std::shared_ptr<const Token> token = TokenBuilder("abc123").setStringLiteral(true).build();
-    const auto stringLiteral = AST::StringLiteral(token);
+    const std::string value = "abc123";
+    const auto stringLiteral = AST::StringLiteral(value);
 
     // Not sure how to verify the string's contents.
     ASSERT_NO_THROW((llvm::ConstantExpr*) GeneratorUnderTest().generate(stringLiteral));
@@ -188,21 +201,21 @@ TEST(Generator, GeneratesStringLiteral) {
 
 TEST(Generator, GeneratesFunctionCall) {
     GeneratorUnderTest generator;
-    const auto param1 = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto param2 = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ param1, param2 });
-    const auto returnType = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto externProto = std::make_shared<const AST::FunctionPrototype>(
-            AST::FunctionPrototype(params, returnType));
-    const auto externDecl = AST::Function("test3", externProto);
+    Arena arena;
+    const AST::IntegerType param1;
+    const AST::IntegerType param2;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &param1, &param2 }));
+    const AST::IntegerType returnType;
+    const AST::FunctionPrototype externProto(params, &returnType);
+    const auto externDecl = AST::Function(Symbols::intern("test3"), &externProto);
     generator.generate(externDecl);
 
-    const std::shared_ptr<const Token> name = TokenBuilder("test3").build();
-    const std::shared_ptr<const Token> literal1 = TokenBuilder("a").setCharLiteral(true).build();
-    const auto arg1 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(literal1));
-    const std::shared_ptr<const Token> literal2 = TokenBuilder("b").setCharLiteral(true).build();
-    const auto arg2 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(literal2));
-    const auto args = std::vector<std::shared_ptr<const AST::Expression>>({ arg1, arg2 });
+    const Symbol name = Symbols::intern("test3");
+    const char literal1 = 'a';
+    const AST::CharLiteral arg1(literal1);
+    const char literal2 = 'b';
+    const AST::CharLiteral arg2(literal2);
+    const auto args = arena.list(std::vector<const AST::Expression*>({ &arg1, &arg2 }));
 
     const auto func = AST::FunctionCall(name, args);
     const llvm::CallInst* call = generator.generate(func);
@@ -216,17 +229,258 @@ TEST(Generator, GeneratesFunctionCall) {
 TEST(Generator, GeneratesIdentifierExpression) {
     GeneratorUnderTest generator;
 
-    const std::shared_ptr<const Token> nameToken = TokenBuilder("bar").build();
-    const auto type = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const std::shared_ptr<const Token> valueToken = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto expr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(valueToken));
-    const AST::StatementLet declaration(nameToken, type, expr);
+    const Symbol name = Symbols::intern("bar");
+    const AST::IntegerType type;
+    const int32_t literalValue = 1;
+    const AST::IntegerLiteral expr(literalValue);
+    const AST::StatementLet declaration(name, &type, &expr);
 
     generator.generate(declaration);
 
-    const auto identifier = AST::IdentifierExpr(nameToken);
+    const auto identifier = AST::IdentifierExpr(name);
 
     const llvm::Value* llvmValue = generator.generate(identifier);
 
     ASSERT_EQ((int64_t) 1, ((llvm::ConstantInt*) llvmValue)->getValue().getSExtValue());
+}
+
+TEST(Generator, KeepsExternsDeclaredAfterStatementsBeforeMain) {
+    const int32_t literalValue = 1;
+    const AST::IntegerLiteral literal(literalValue);
+    const AST::StatementExpression stmt(&literal);
+    const AST::IntegerType integer;
+    const AST::FunctionPrototype proto(ArenaList<const AST::Type*>(), &integer /* returnType */);
+    const AST::Function func(Symbols::intern("declaredLate"), &proto);
+
+    Generator generator(sharedSession);
+    generator.append(stmt);
+    generator.declare(func);
+    const llvm::Function* main = generator.finish();
+
+    ASSERT_EQ(main, &*std::next(sharedSession.module->getFunction("declaredLate")->getIterator()));
+}
+
+// Generates the given File, along with any other arguments to Generator::gen(), in a session of its own, returning the
+// IR printed.
+template <typename File, typename... Args>
+std::string generateModule(const File& file, Args&... args) {
+    CompilationSession session("Generator Test");
+    Generator::gen(session, file, args...);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    session.module->print(ss, nullptr);
+    return ss.str();
+}
+
+TEST(Generator, GeneratesFlatFileLikeTree) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function func(Symbols::intern("flat"), &proto);
+
+    const AST::IntegerLiteral one(1);
+    const AST::IntegerLiteral two(2);
+    const AST::IdentifierExpr param(Symbols::intern("flatParam"));
+    const AST::AddOpExpression sum(&one, &two);
+    const AST::StatementLet let(Symbols::intern("flatParam"), &integer, &sum);
+    const AST::MulOpExpression product(&param, &param);
+    const AST::FunctionCall call(Symbols::intern("flat"), arena.list(std::vector<const AST::Expression*>({ &product })));
+    const AST::StatementExpression stmt(&call);
+    const AST::StringLiteral text("Hello");
+    const AST::StatementExpression textStmt(&text);
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &stmt, &textStmt })));
+
+    ASSERT_EQ(generateModule(file), generateModule(file.flatten()));
+}
+
+TEST(Generator, ThrowsRedeclaredExceptionFromFlatFile) {
+    const AST::IntegerType integer;
+    const AST::IntegerLiteral value(1);
+    const AST::StatementLet let(Symbols::intern("flatTwice"), &integer, &value);
+
+    Arena arena;
+    const AST::File file(ArenaList<const AST::Function*>(),
+        arena.list(std::vector<const AST::Statement*>({ &let, &let })));
+
+    ASSERT_THROW(generateModule(file.flatten()), RedeclaredException);
+}
+
+TEST(Generator, ThrowsUndeclaredExceptionFromFlatFile) {
+    const AST::IdentifierExpr identifier(Symbols::intern("flatUndeclared"));
+    const AST::StatementExpression stmt(&identifier);
+
+    Arena arena;
+    const AST::File file(ArenaList<const AST::Function*>(), arena.list(std::vector<const AST::Statement*>({ &stmt })));
+
+    ASSERT_THROW(generateModule(file.flatten()), UndeclaredException);
+}
+
+// Returns the number of times the given text occurs in the given IR.
+size_t count(const std::string& ir, const std::string& text) {
+    size_t occurrences = 0;
+    for (size_t index = ir.find(text); index != std::string::npos; index = ir.find(text, index + 1)) ++occurrences;
+    return occurrences;
+}
+
+TEST(Generator, GeneratesDeeplyNestedExpressionsWithoutRecursion) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function func(Symbols::intern("nested"), &proto);
+
+    const AST::Expression* expr = arena.make<AST::IntegerLiteral>(0);
+    for (int i = 1; i < 100000; ++i) {
+        expr = i % 2 == 0
+            ? (const AST::Expression*) arena.make<AST::AddOpExpression>(expr, arena.make<AST::IntegerLiteral>(i))
+            : arena.make<AST::FunctionCall>(Symbols::intern("nested"),
+                arena.list(std::vector<const AST::Expression*>({ expr })));
+    }
+    const AST::StatementExpression stmt(expr);
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &stmt })));
+
+    const std::string ir = generateModule(file);
+    ASSERT_EQ(50000, count(ir, "call i32 @nested("));
+    ASSERT_EQ(ir, generateModule(file.flatten()));
+}
+
+TEST(Generator, GeneratesSharedOperationsOnce) {
+    Arena arena;
+    AST::Interner interner(arena);
+    const AST::IntegerType integer;
+    const AST::FunctionPrototype proto(ArenaList<const AST::Type*>(), &integer /* returnType */);
+    const AST::Function func(Symbols::intern("sharedInput"), &proto);
+    const AST::FunctionCall call(Symbols::intern("sharedInput"), ArenaList<const AST::Expression*>());
+    const AST::StatementLet let(Symbols::intern("shared"), &integer, &call);
+
+    const AST::Expression* square = interner.operation<AST::MulOpExpression>(
+        interner.identifierExpr(Symbols::intern("shared")), interner.identifierExpr(Symbols::intern("shared")));
+    const AST::StatementExpression first(square);
+    const AST::StatementExpression second(interner.operation<AST::AddOpExpression>(square, square));
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &first, &second })));
+
+    ASSERT_EQ(3, count(generateModule(file), " = mul "));
+    ASSERT_EQ(1, count(generateModule(file, interner), " = mul "));
+    ASSERT_EQ(1, count(generateModule(file, interner), " = add "));
+}
+
+TEST(Generator, ReportsErrorOfEveryStatementToDiagnostics) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const AST::StringType string;
+    const AST::IntegerLiteral one(1);
+    const AST::IdentifierExpr undeclared(Symbols::intern("reportedUndeclared"));
+    const AST::AddOpExpression sum(&one, &undeclared);
+    const AST::StatementExpression first(&sum);
+    const AST::StatementLet let(Symbols::intern("reported"), &integer, &one);
+    const AST::StatementLet mismatch(Symbols::intern("reportedMismatch"), &string, &one);
+    const AST::FunctionCall call(Symbols::intern("reportedCallee"), ArenaList<const AST::Expression*>());
+    const AST::StatementExpression last(&call);
+
+    const AST::File file(ArenaList<const AST::Function*>(),
+        arena.list(std::vector<const AST::Statement*>({ &first, &let, &mismatch, &let, &last })));
+
+    Diagnostics diagnostics;
+    generateModule(file, diagnostics);
+
+    ASSERT_EQ(4, diagnostics.size());
+    ASSERT_EQ(Diagnostic::UNDECLARED, diagnostics.all()[0].kind);
+    ASSERT_EQ(Diagnostic::TYPE, diagnostics.all()[1].kind);
+    ASSERT_EQ(Diagnostic::REDECLARED, diagnostics.all()[2].kind);
+    ASSERT_EQ(Diagnostic::UNDECLARED, diagnostics.all()[3].kind);
+    ASSERT_THROW(generateModule(file), UndeclaredException);
+
+    Diagnostics flatDiagnostics;
+    generateModule(file.flatten(), flatDiagnostics);
+
+    ASSERT_EQ(diagnostics.size(), flatDiagnostics.size());
+    for (size_t i = 0; i < diagnostics.size(); ++i) {
+        ASSERT_EQ(diagnostics.all()[i].describe(), flatDiagnostics.all()[i].describe());
+    }
+}
+
+// Generates the given File with its statements outlined into chunks of the given number of instructions, in a module of
+// its own, returning the IR printed.
+template <typename File>
+std::string generateOutlined(const File& file, const size_t instructions) {
+    CompilationSession session("Generator Test");
+    Generator generator(session);
+    generator.outline(instructions);
+    generator.generate(file);
+    EXPECT_FALSE(llvm::verifyModule(*session.module, &llvm::errs()));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    session.module->print(ss, nullptr);
+    return ss.str();
+}
+
+TEST(Generator, OutlinesStatementsIntoChunks) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function func(Symbols::intern("outlined"), &proto);
+
+    const AST::IntegerLiteral one(1);
+    const AST::FunctionCall callOne(Symbols::intern("outlined"),
+        arena.list(std::vector<const AST::Expression*>({ &one })));
+    const AST::StatementLet let(Symbols::intern("outlinedValue"), &integer, &callOne);
+    const AST::StatementLet constant(Symbols::intern("outlinedConstant"), &integer, &one);
+    const AST::IdentifierExpr value(Symbols::intern("outlinedValue"));
+    const AST::IdentifierExpr constantValue(Symbols::intern("outlinedConstant"));
+    const AST::MulOpExpression product(&value, &constantValue);
+    const AST::FunctionCall callProduct(Symbols::intern("outlined"),
+        arena.list(std::vector<const AST::Expression*>({ &product })));
+    const AST::StatementExpression use(&callProduct);
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &constant, &use, &use, &use })));
+
+    const std::string ir = generateOutlined(file, 2);
+    ASSERT_EQ(4, count(ir, "define internal void @main.chunk"));
+    ASSERT_EQ(4, count(ir, "call void @main.chunk"));
+    ASSERT_EQ(1, count(ir, "@outlinedValue = internal global i32 0"));
+    ASSERT_EQ(0, count(ir, "@outlinedConstant"));
+    ASSERT_EQ(3, count(ir, "load i32"));
+
+    ASSERT_EQ(ir, generateOutlined(file.flatten(), 2));
+    ASSERT_EQ(0, count(generateOutlined(file, 0), "@main.chunk"));
+}
+
+TEST(Generator, GeneratesConcurrentlyInSeparateSessions) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const AST::Function func(Symbols::intern("concurrent"), &proto);
+
+    const AST::CharLiteral letter('a');
+    const AST::FunctionCall call(Symbols::intern("concurrent"),
+        arena.list(std::vector<const AST::Expression*>({ &letter })));
+    const AST::StatementLet let(Symbols::intern("concurrentValue"), &integer, &call);
+    const AST::IdentifierExpr value(Symbols::intern("concurrentValue"));
+    const AST::AddOpExpression sum(&value, &value);
+    const AST::StatementExpression stmt(&sum);
+    const AST::StringLiteral text("Hello");
+    const AST::StatementExpression textStmt(&text);
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &stmt, &textStmt })));
+    const std::string expected = generateModule(file);
+
+    // Each thread generates into its own session, sharing nothing but the AST it reads.
+    std::vector<std::string> generated(4);
+    std::vector<std::thread> threads;
+    for (std::string& ir : generated) threads.emplace_back([&file, &ir]() { ir = generateModule(file); });
+    for (std::thread& thread : threads) thread.join();
+
+    for (const std::string& ir : generated) ASSERT_EQ(expected, ir);
 }
\ No newline at end of file
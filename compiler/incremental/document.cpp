@@ -0,0 +1,114 @@
+#include "document.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <experimental/string_view>
+#include "compiler/lexer/lexer.h"
+#include "compiler/lexer/token_stream.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/token_list.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+namespace {
+    // Parses the top-level elements of the given Tokens from the given index onwards, appending them to the given list,
+    // until either the Tokens run out or the given callback returns true at the start of an element.
+    template <typename Stop>
+    void parse(const TokenList& tokens, const size_t start, Arena& arena, std::vector<Document::Element>& elements,
+            Stop stop) {
+        TokenStream stream(tokens, start);
+        while (!stop(start + stream.consumed())) {
+            Document::Element element = { start + stream.consumed(), 0, nullptr, nullptr };
+            const bool parsed = Parser::parseNext(stream, arena,
+                [&element](const AST::Function* externDecl) { element.externDecl = externDecl; },
+                [&element](const AST::Statement* statement) { element.statement = statement; });
+            if (!parsed) return;
+
+            element.end = start + stream.consumed();
+            elements.push_back(std::move(element));
+        }
+    }
+}
+
+Document::Document(std::shared_ptr<const std::string> source, std::shared_ptr<Arena> arena, TokenList tokens,
+        std::vector<Element> elements)
+    : source(std::move(source)), arena(std::move(arena)), tokenList(std::move(tokens)),
+      elementList(std::move(elements)) { }
+
+Document::Document(std::string source)
+    : source(std::make_shared<const std::string>(std::move(source))), arena(std::make_shared<Arena>()),
+      tokenList(Lexer::tokenize(*this->source)) {
+    parse(this->tokenList, 0, *this->arena, this->elementList, [](size_t) { return false; });
+}
+
+Document Document::edit(const uint32_t offset, const uint32_t removed,
+        const std::experimental::string_view replacement) const {
+    if (offset > this->source->size() || removed > this->source->size() - offset) {
+        throw IllegalStateException("Edit of [" + std::to_string(offset) + ", " + std::to_string(offset + removed)
+            + ") is not within the source of " + std::to_string(this->source->size()) + " bytes.");
+    }
+
+    std::string text;
+    text.reserve(this->source->size() - removed + replacement.size());
+    text.append(*this->source, 0, offset);
+    text.append(replacement.data(), replacement.size());
+    text.append(*this->source, offset + removed, std::string::npos);
+    const std::shared_ptr<const std::string> source = std::make_shared<const std::string>(std::move(text));
+
+    Lexer::Relexed relexed = Lexer::relex(this->tokenList, *source,
+        Lexer::Edit { offset, removed, (uint32_t) replacement.size() });
+    const ptrdiff_t shift = (ptrdiff_t) relexed.newEnd - (ptrdiff_t) relexed.oldEnd;
+
+    // Elements which end before the first changed Token are kept as they are, and parsing resumes at the next one.
+    const auto first = std::upper_bound(this->elementList.begin(), this->elementList.end(), relexed.first,
+        [](const size_t token, const Element& element) { return token < element.end; });
+    std::vector<Element> elements;
+    elements.reserve(this->elementList.size() + 16);
+    elements.insert(elements.end(), this->elementList.begin(), first);
+    const size_t start = elements.empty() ? 0 : elements.back().end;
+
+    // Once an element would start after the changed Tokens at the same Token as a previous element did, the rest of
+    // the elements are the same as before, so they are kept with their Tokens shifted.
+    auto kept = first;
+    bool resynced = false;
+    parse(relexed.tokens, start, *this->arena, elements, [this, &relexed, &kept, &resynced, shift](const size_t token) {
+        if (token < relexed.newEnd) return false;
+
+        const auto previous = (size_t) ((ptrdiff_t) token - shift);
+        kept = std::lower_bound(kept, this->elementList.end(), previous,
+            [](const Element& element, const size_t token) { return element.first < token; });
+        resynced = kept != this->elementList.end() && kept->first == previous;
+        return resynced;
+    });
+
+    if (resynced) {
+        for (; kept != this->elementList.end(); ++kept) {
+            elements.push_back(Element {
+                (size_t) ((ptrdiff_t) kept->first + shift), (size_t) ((ptrdiff_t) kept->end + shift),
+                kept->externDecl, kept->statement,
+            });
+        }
+    }
+
+    return Document(source, this->arena, std::move(relexed.tokens), std::move(elements));
+}
+
+const AST::File* Document::file(Arena& arena) const {
+    std::vector<const AST::Function*> externDecls;
+    std::vector<const AST::Statement*> statements;
+    for (const Element& element : this->elementList) {
+        if (element.externDecl) {
+            externDecls.push_back(element.externDecl);
+        } else {
+            statements.push_back(element.statement);
+        }
+    }
+
+    return arena.make<AST::File>(arena.list(externDecls), arena.list(statements));
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef SANITY_DOCUMENT_H
+#define SANITY_DOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <experimental/string_view>
+#include "../models/ast.h"
+#include "../models/token_list.h"
+#include "../utils/arena.h"
+
+/**
+ * Snapshot of a source file being edited, along with its Tokens and the AST of each of its top-level elements. Editing
+ * a Document returns a new one, which only relexes the source around the edit and only reparses the top-level elements
+ * whose Tokens changed, sharing the AST of every other element with the Document it was edited from. A small edit to
+ * a large file therefore costs about as much as lexing and parsing the element it touched.
+ *
+ * Documents are immutable, so if an edit cannot be lexed or parsed, the Document it was applied to is still valid and
+ * can keep being used until the source compiles again.
+ *
+ * Every Document edited from the same original places its AST in one shared Arena, which is only freed once all of them
+ * are destroyed. A long editing session can start over with a new Document of its text to release old nodes. Since the
+ * Arena is shared, Documents edited from the same original must only be edited from one thread at a time.
+ */
+class Document {
+public:
+    /**
+     * Extern declaration or statement at the top level of a file, along with the range of Tokens it was parsed from.
+     * Exactly one of externDecl and statement is set.
+     */
+    class Element {
+    public:
+        size_t first;
+        size_t end;
+        const AST::Function* externDecl;
+        const AST::Statement* statement;
+    };
+
+private:
+    // Owned on the heap so the Tokens' view of it survives the Document being moved.
+    std::shared_ptr<const std::string> source;
+    std::shared_ptr<Arena> arena;
+    TokenList tokenList;
+    std::vector<Element> elementList;
+
+    Document(std::shared_ptr<const std::string> source, std::shared_ptr<Arena> arena, TokenList tokens,
+        std::vector<Element> elements);
+
+public:
+    /**
+     * Lexes and parses the given source in full.
+     * @throws SyntaxException
+     * @throws ParseException
+     */
+    explicit Document(std::string source);
+
+    /**
+     * Returns a new Document with the bytes [offset, offset + removed) of the source replaced by the given text. This
+     * Document is left unchanged.
+     * @throws SyntaxException
+     * @throws ParseException
+     * @throws IllegalStateException if the range is not within the source.
+     */
+    Document edit(uint32_t offset, uint32_t removed, std::experimental::string_view replacement) const;
+
+    const std::string& text() const {
+        return *this->source;
+    }
+
+    const TokenList& tokens() const {
+        return this->tokenList;
+    }
+
+    const std::vector<Element>& elements() const {
+        return this->elementList;
+    }
+
+    /**
+     * Builds the File of every top-level element in the given Arena, in the same form the Parser returns.
+     */
+    const AST::File* file(Arena& arena) const;
+};
+
+#endif //SANITY_DOCUMENT_H
\ No newline at end of file
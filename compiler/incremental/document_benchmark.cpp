@@ -0,0 +1,47 @@
+#include <gflags/gflags.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "document.h"
+
+DEFINE_int32(statements, 10000, "Number of statements in the generated source.");
+DEFINE_int32(edits, 1000, "Number of single character edits to time.");
+
+// Generates a source of the given number of statements which resembles machine-generated Sanity code.
+std::string generateSource(const int statements) {
+    std::string source = "extern putchar: (int) -> int;\n";
+    for (int i = 0; i < statements; ++i) {
+        source += "let value" + std::to_string(i) + ": int = " + std::to_string(i) + " * (42 + 7) - 3 / 7;\n";
+    }
+    return source;
+}
+
+// Measures a single character edit in the middle of a large source against lexing and parsing it from scratch.
+int main(int argc, char* argv[]) {
+    gflags::SetUsageMessage("Benchmarks editing a large Document against lexing and parsing it from scratch.");
+    gflags::ParseCommandLineFlags(&argc, &argv, true /* remove flags from argv */);
+
+    const std::string source = generateSource(FLAGS_statements);
+
+    const auto parseStart = std::chrono::steady_clock::now();
+    const Document document(source);
+    const std::chrono::duration<double, std::micro> parse = std::chrono::steady_clock::now() - parseStart;
+
+    // Alternately change a digit of the middle statement's literal and change it back.
+    const auto offset = (uint32_t) source.find("= " + std::to_string(FLAGS_statements / 2) + " ") + 2;
+    const char digits[] = { '9', source[offset] };
+
+    const auto editStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < FLAGS_edits; ++i) {
+        const Document edited = document.edit(offset, 1, std::experimental::string_view(&digits[i % 2], 1));
+    }
+    const std::chrono::duration<double, std::micro> edits = std::chrono::steady_clock::now() - editStart;
+    const double edit = edits.count() / FLAGS_edits;
+
+    std::printf("%-14s %14s %8s\n", "operation", "microseconds", "speedup");
+    std::printf("%-14s %14.1f %8.2f\n", "full parse", parse.count(), 1.0);
+    std::printf("%-14s %14.1f %8.2f\n", "edit", edit, parse.count() / edit);
+
+    return 0;
+}
\ No newline at end of file
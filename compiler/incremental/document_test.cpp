@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "document.h"
+#include "compiler/lexer/lexer.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/token_list.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+#include "llvm/Support/raw_ostream.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+typedef Exceptions::ParseException ParseException;
+typedef Exceptions::SyntaxException SyntaxException;
+
+std::string print(const AST::File& file) {
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file.print(ss);
+    return ss.str();
+}
+
+// Asserts that the given Document has exactly the Tokens and AST of lexing and parsing its source from scratch.
+void assertMatchesFullParse(const Document& document) {
+    const TokenList tokens = Lexer::tokenize(document.text());
+    ASSERT_EQ(tokens.size(), document.tokens().size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        ASSERT_EQ(tokens[i].kind, document.tokens()[i].kind);
+        ASSERT_EQ(tokens[i].offset, document.tokens()[i].offset);
+        ASSERT_EQ(tokens[i].length, document.tokens()[i].length);
+    }
+
+    Arena arena;
+    ASSERT_EQ(print(*Parser::parse(tokens, arena)), print(*document.file(arena)));
+
+    size_t end = 0;
+    for (const Document::Element& element : document.elements()) {
+        ASSERT_EQ(end, element.first);
+        ASSERT_LT(element.first, element.end);
+        end = element.end;
+    }
+    ASSERT_EQ(tokens.size(), end);
+}
+
+const std::string SOURCE = "extern puts: (string) -> int;\n"
+    "let a: int = 1 + 2;\n"
+    "puts(\"Hello\");\n"
+    "let b: int = a * 3; // Comment\n"
+    "puts(\"World\");\n";
+
+TEST(Document, ParsesEachTopLevelElement) {
+    const Document document(SOURCE);
+
+    ASSERT_EQ(5, document.elements().size());
+    ASSERT_TRUE(document.elements()[0].externDecl != nullptr);
+    ASSERT_TRUE(document.elements()[1].statement != nullptr);
+    assertMatchesFullParse(document);
+}
+
+TEST(Document, ReparsesOnlyTheEditedElement) {
+    const Document document(SOURCE);
+
+    // Rename "b" to "bee".
+    const Document edited = document.edit((uint32_t) SOURCE.find("b:"), 1, "bee");
+
+    assertMatchesFullParse(edited);
+    ASSERT_EQ(document.elements()[2].statement, edited.elements()[2].statement);
+    ASSERT_NE(document.elements()[3].statement, edited.elements()[3].statement);
+    ASSERT_EQ(document.elements()[4].statement, edited.elements()[4].statement);
+    ASSERT_EQ(document.elements()[4].first, edited.elements()[4].first);
+}
+
+TEST(Document, KeepsEveryElementWhenNoTokenChanges) {
+    const Document document(SOURCE);
+
+    const Document edited = document.edit((uint32_t) SOURCE.find("// Comment"), 0, "  ");
+
+    assertMatchesFullParse(edited);
+    for (size_t i = 0; i < document.elements().size(); ++i) {
+        ASSERT_EQ(document.elements()[i].statement, edited.elements()[i].statement);
+    }
+}
+
+TEST(Document, ShiftsElementsAfterInsertedStatements) {
+    const Document document(SOURCE);
+
+    const Document edited = document.edit((uint32_t) SOURCE.find("puts(\"Hello\")"), 0, "1; 2; 3;\n");
+
+    assertMatchesFullParse(edited);
+    ASSERT_EQ(8, edited.elements().size());
+    ASSERT_EQ(document.elements()[4].statement, edited.elements()[7].statement);
+}
+
+TEST(Document, MergesElementsWhenSemicolonIsRemoved) {
+    const Document document("foo(1);\nbar(2) + 3;\nbaz;");
+
+    assertMatchesFullParse(document.edit(6, 1, " +").edit(0, 3, "qux"));
+}
+
+TEST(Document, LeavesDocumentUnchangedWhenEditCannotBeParsed) {
+    const Document document(SOURCE);
+
+    ASSERT_THROW(document.edit((uint32_t) SOURCE.find(";"), 1, ""), ParseException);
+    ASSERT_THROW(document.edit(0, 0, "\""), SyntaxException);
+    ASSERT_THROW(document.edit((uint32_t) SOURCE.size(), 1, ""), IllegalStateException);
+
+    ASSERT_EQ(SOURCE, document.text());
+    assertMatchesFullParse(document);
+}
+
+TEST(Document, EditsEveryCharacterLikeFullParse) {
+    const Document document(SOURCE);
+
+    for (uint32_t offset = 0; offset <= SOURCE.size(); ++offset) {
+        for (const std::string replacement : { "", " ", "x", "1;", "+ 1", "/*", "*/" }) {
+            for (uint32_t removed = 0; removed <= 1 && offset + removed <= SOURCE.size(); ++removed) {
+                const std::string edited = SOURCE.substr(0, offset) + replacement + SOURCE.substr(offset + removed);
+
+                bool parses = true;
+                try {
+                    Arena arena;
+                    Parser::parse(Lexer::tokenize(edited), arena);
+                } catch (const SyntaxException& ex) {
+                    parses = false;
+                } catch (const ParseException& ex) {
+                    parses = false;
+                }
+
+                if (parses) {
+                    assertMatchesFullParse(document.edit(offset, removed, replacement));
+                } else {
+                    ASSERT_ANY_THROW(document.edit(offset, removed, replacement));
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "jit.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "compiler/models/exceptions.h"
+#include "compiler/optimizer/optimizer.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+namespace {
+    // Binds each function the given module declares without defining to its definition in the first of the given
+    // libraries to have one, or otherwise in this process. The process comes last, so libraries can replace functions
+    // of the C library, such as the standard library's read().
+    void resolve(const llvm::Module& module, const std::vector<std::string>& libraries) {
+        std::vector<llvm::sys::DynamicLibrary> loaded;
+        for (const std::string& path : libraries) {
+            std::string error;
+            loaded.push_back(llvm::sys::DynamicLibrary::getPermanentLibrary(path.c_str(), &error));
+            if (!loaded.back().isValid()) throw IllegalStateException("Cannot load \"" + path + "\": " + error);
+        }
+        loaded.push_back(llvm::sys::DynamicLibrary::getPermanentLibrary(nullptr));
+
+        for (const llvm::Function& function : module) {
+            if (!function.isDeclaration() || function.isIntrinsic()) continue;
+
+            const std::string name = function.getName().str();
+            void* address = nullptr;
+            for (llvm::sys::DynamicLibrary& library : loaded) {
+                address = library.getAddressOfSymbol(name.c_str());
+                if (address) break;
+            }
+            if (!address) throw IllegalStateException("Function \"" + name + "\" is not defined by any library.");
+
+            // Symbols added explicitly are found before those of any library when the JIT links the module.
+            llvm::sys::DynamicLibrary::AddSymbol(name, address);
+        }
+    }
+}
+
+std::unique_ptr<llvm::TargetMachine> Jit::machine(const unsigned optLevel) {
+    const llvm::CodeGenOpt::Level level = Optimizer::codeGenLevel(optLevel);
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    // Unlike code written out, the code only ever runs here, so tune it for this CPU. The engine picks the code and
+    // relocation models which reach wherever in memory the code is placed.
+    std::unique_ptr<llvm::TargetMachine> machine(llvm::EngineBuilder()
+        .setOptLevel(level)
+        .setMCPU(llvm::sys::getHostCPUName())
+        .selectTarget());
+    if (!machine) throw IllegalStateException("Cannot generate code for this machine.");
+    return machine;
+}
+
+int Jit::run(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::TargetMachine> machine,
+        const std::vector<std::string>& libraries) {
+    resolve(*module, libraries);
+
+    std::string error;
+    const std::unique_ptr<llvm::ExecutionEngine> engine(llvm::EngineBuilder(std::move(module))
+        .setEngineKind(llvm::EngineKind::JIT)
+        .setErrorStr(&error)
+        .create(machine.release()));
+    if (!engine) throw IllegalStateException("Cannot compile for this machine: " + error);
+
+    engine->finalizeObject();
+    const auto main = (int (*)()) engine->getFunctionAddress("main");
+    return main();
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef SANITY_JIT_H
+#define SANITY_JIT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+/**
+ * Runs compiled modules straight away by generating their machine code into the memory of this process, rather than
+ * writing them out to be run by another program. This takes neither printing the IR as text nor starting a second
+ * process to parse it back, so a program starts running as soon as it has been compiled.
+ */
+namespace Jit {
+    /**
+     * Returns a TargetMachine generating code for the CPU of this machine into its memory at the given optimization
+     * level, from 0 up to Optimizer::MAX_LEVEL, for modules to be optimized for and then run by.
+     * @throws IllegalStateException if code cannot be generated for this machine or the level is above MAX_LEVEL.
+     */
+    std::unique_ptr<llvm::TargetMachine> machine(unsigned optLevel);
+
+    /**
+     * Compiles the given module with the given machine from machine(), then runs its main function and returns the
+     * status it exits with. Each extern function is bound to its definition in the first of the given shared libraries
+     * to define it, or otherwise in this process, which includes the C library.
+     * @throws IllegalStateException if a library cannot be loaded, an extern function is not defined by any of them or
+     *     the module cannot be compiled by the machine.
+     */
+    int run(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::TargetMachine> machine,
+        const std::vector<std::string>& libraries = std::vector<std::string>());
+}
+
+#endif //SANITY_JIT_H
\ No newline at end of file
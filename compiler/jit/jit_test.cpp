@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "jit.h"
+#include "compiler/generator/generator.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/symbol.h"
+#include "compiler/optimizer/optimizer.h"
+#include "compiler/utils/arena.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+// Generates "extern <callee>: (int) -> int; let a: int = <callee>('a'); <callee>(a + 1);" into the module of the given
+// session, optimizes it at the given level for this machine, then moves the module out to be run.
+std::unique_ptr<llvm::Module> generateModule(CompilationSession& session, const std::string& callee,
+        llvm::TargetMachine& machine, const unsigned optLevel = 0) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const AST::FunctionPrototype proto(arena.list(std::vector<const AST::Type*>({ &integer })), &integer);
+    const AST::Function func(Symbols::intern(callee), &proto);
+    const AST::CharLiteral letter('a');
+    const AST::FunctionCall first(Symbols::intern(callee),
+        arena.list(std::vector<const AST::Expression*>({ &letter })));
+    const AST::StatementLet let(Symbols::intern("a"), &integer, &first);
+    const AST::IdentifierExpr value(Symbols::intern("a"));
+    const AST::IntegerLiteral one(1);
+    const AST::AddOpExpression sum(&value, &one);
+    const AST::FunctionCall second(Symbols::intern(callee), arena.list(std::vector<const AST::Expression*>({ &sum })));
+    const AST::StatementExpression stmt(&second);
+    Generator::gen(session, AST::File(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &stmt }))));
+
+    Optimizer::optimize(*session.module, machine, optLevel);
+    return std::move(session.module);
+}
+
+TEST(Jit, RunsMainResolvingExternsInProcess) {
+    for (unsigned optLevel = 0; optLevel <= 3; ++optLevel) {
+        CompilationSession session("JIT Test");
+        testing::internal::CaptureStdout();
+        std::unique_ptr<llvm::TargetMachine> machine = Jit::machine(optLevel);
+        std::unique_ptr<llvm::Module> module = generateModule(session, "putchar", *machine, optLevel);
+        const int status = Jit::run(std::move(module), std::move(machine));
+        std::fflush(stdout);
+
+        ASSERT_EQ("ab", testing::internal::GetCapturedStdout());
+        ASSERT_EQ(0, status);
+    }
+}
+
+TEST(Jit, ThrowsIllegalStateExceptionOnUndefinedExtern) {
+    CompilationSession session("JIT Test");
+    std::unique_ptr<llvm::TargetMachine> machine = Jit::machine(0);
+    std::unique_ptr<llvm::Module> module = generateModule(session, "sanityJitTestUndefined", *machine);
+    ASSERT_THROW(Jit::run(std::move(module), std::move(machine)), IllegalStateException);
+}
+
+TEST(Jit, ThrowsIllegalStateExceptionOnMissingLibrary) {
+    CompilationSession session("JIT Test");
+    std::unique_ptr<llvm::TargetMachine> machine = Jit::machine(0);
+    std::unique_ptr<llvm::Module> module = generateModule(session, "putchar", *machine);
+    ASSERT_THROW(Jit::run(std::move(module), std::move(machine), { "/nonexistent/libsanity.so" }),
+        IllegalStateException);
+}
+
+TEST(Jit, ThrowsIllegalStateExceptionAboveMaxOptLevel) {
+    ASSERT_THROW(Jit::machine(Optimizer::MAX_LEVEL + 1), IllegalStateException);
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "char_scan.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SANITY_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    typedef std::array<bool, 256> CharSet;
+
+    CharSet whitespaceChars() {
+        CharSet chars = {};
+        chars[' '] = chars['\t'] = chars['\r'] = chars['\n'] = true;
+        return chars;
+    }
+
+    CharSet identifierChars() {
+        CharSet chars = {};
+        for (int c = 'a'; c <= 'z'; ++c) chars[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) chars[c] = true;
+        for (int c = '0'; c <= '9'; ++c) chars[c] = true;
+        chars['_'] = true;
+        return chars;
+    }
+
+    // Characters which can be part of a string literal without ending or escaping it.
+    CharSet stringChars() {
+        CharSet chars;
+        chars.fill(true);
+        chars['\"'] = chars['\\'] = chars['\''] = chars['\n'] = chars['\t'] = chars['\r'] = false;
+        return chars;
+    }
+
+    const CharSet WHITESPACE = whitespaceChars();
+    const CharSet IDENTIFIER = identifierChars();
+    const CharSet STRING = stringChars();
+
+    const char* skip(const CharSet& chars, const char* begin, const char* const end) {
+        while (begin != end && chars[(unsigned char) *begin]) ++begin;
+        return begin;
+    }
+
+    const char* whitespaceScalar(const char* begin, const char* end) {
+        return skip(WHITESPACE, begin, end);
+    }
+
+    const char* identifierScalar(const char* begin, const char* end) {
+        return skip(IDENTIFIER, begin, end);
+    }
+
+    const char* stringScalar(const char* begin, const char* end) {
+        return skip(STRING, begin, end);
+    }
+
+    // The C library's memchr() is already vectorized, so every instruction set shares it for finding a single character.
+    const char* find(const char c, const char* begin, const char* end) {
+        const void* found = std::memchr(begin, c, end - begin);
+        return found ? (const char*) found : end;
+    }
+
+    const char* lineComment(const char* begin, const char* end) {
+        return find('\n', begin, end);
+    }
+
+    const char* blockComment(const char* begin, const char* end) {
+        return find('*', begin, end);
+    }
+
+    const CharScan::Kernels SCALAR = {
+        "scalar", whitespaceScalar, identifierScalar, lineComment, blockComment, stringScalar,
+    };
+
+#ifdef SANITY_X86
+    // Each vectorized kernel checks whole blocks of characters, builds a bit mask of the characters which end the run,
+    // and returns the first of them. The last partial block is left to the scalar kernel.
+
+    __attribute__((target("sse2")))
+    __m128i equals16(const __m128i chars, const char c) {
+        return _mm_cmpeq_epi8(chars, _mm_set1_epi8(c));
+    }
+
+    // Characters are compared as signed bytes, so non-ASCII characters are below every bound and never in range.
+    __attribute__((target("sse2")))
+    __m128i between16(const __m128i chars, const char low, const char high) {
+        const __m128i outside = _mm_or_si128(_mm_cmplt_epi8(chars, _mm_set1_epi8(low)),
+            _mm_cmpgt_epi8(chars, _mm_set1_epi8(high)));
+        return _mm_andnot_si128(outside, _mm_set1_epi8(-1));
+    }
+
+    __attribute__((target("sse2")))
+    __m128i whitespace16(const __m128i chars) {
+        return _mm_or_si128(_mm_or_si128(equals16(chars, ' '), equals16(chars, '\t')),
+            _mm_or_si128(equals16(chars, '\r'), equals16(chars, '\n')));
+    }
+
+    __attribute__((target("sse2")))
+    __m128i identifier16(const __m128i chars) {
+        // Setting the 0x20 bit lower-cases letters without making any other character a letter.
+        const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        return _mm_or_si128(_mm_or_si128(between16(lower, 'a', 'z'), between16(chars, '0', '9')),
+            equals16(chars, '_'));
+    }
+
+    __attribute__((target("sse2")))
+    __m128i stringEnd16(const __m128i chars) {
+        return _mm_or_si128(_mm_or_si128(_mm_or_si128(equals16(chars, '\"'), equals16(chars, '\\')),
+            _mm_or_si128(equals16(chars, '\''), equals16(chars, '\n'))),
+            _mm_or_si128(equals16(chars, '\t'), equals16(chars, '\r')));
+    }
+
+    __attribute__((target("sse2")))
+    const char* whitespaceSse2(const char* begin, const char* end) {
+        for (; end - begin >= 16; begin += 16) {
+            const __m128i chars = _mm_loadu_si128((const __m128i*) begin);
+            const unsigned ends = ~(unsigned) _mm_movemask_epi8(whitespace16(chars)) & 0xFFFF;
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return whitespaceScalar(begin, end);
+    }
+
+    __attribute__((target("sse2")))
+    const char* identifierSse2(const char* begin, const char* end) {
+        for (; end - begin >= 16; begin += 16) {
+            const __m128i chars = _mm_loadu_si128((const __m128i*) begin);
+            const unsigned ends = ~(unsigned) _mm_movemask_epi8(identifier16(chars)) & 0xFFFF;
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return identifierScalar(begin, end);
+    }
+
+    __attribute__((target("sse2")))
+    const char* stringSse2(const char* begin, const char* end) {
+        for (; end - begin >= 16; begin += 16) {
+            const __m128i chars = _mm_loadu_si128((const __m128i*) begin);
+            const unsigned ends = (unsigned) _mm_movemask_epi8(stringEnd16(chars));
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return stringScalar(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    __m256i equals32(const __m256i chars, const char c) {
+        return _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i between32(const __m256i chars, const char low, const char high) {
+        const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(low), chars),
+            _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(high)));
+        return _mm256_andnot_si256(outside, _mm256_set1_epi8(-1));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i whitespace32(const __m256i chars) {
+        return _mm256_or_si256(_mm256_or_si256(equals32(chars, ' '), equals32(chars, '\t')),
+            _mm256_or_si256(equals32(chars, '\r'), equals32(chars, '\n')));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i identifier32(const __m256i chars) {
+        const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+        return _mm256_or_si256(_mm256_or_si256(between32(lower, 'a', 'z'), between32(chars, '0', '9')),
+            equals32(chars, '_'));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i stringEnd32(const __m256i chars) {
+        return _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(equals32(chars, '\"'), equals32(chars, '\\')),
+            _mm256_or_si256(equals32(chars, '\''), equals32(chars, '\n'))),
+            _mm256_or_si256(equals32(chars, '\t'), equals32(chars, '\r')));
+    }
+
+    __attribute__((target("avx2")))
+    const char* whitespaceAvx2(const char* begin, const char* end) {
+        for (; end - begin >= 32; begin += 32) {
+            const __m256i chars = _mm256_loadu_si256((const __m256i*) begin);
+            const unsigned ends = ~(unsigned) _mm256_movemask_epi8(whitespace32(chars));
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return whitespaceSse2(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char* identifierAvx2(const char* begin, const char* end) {
+        for (; end - begin >= 32; begin += 32) {
+            const __m256i chars = _mm256_loadu_si256((const __m256i*) begin);
+            const unsigned ends = ~(unsigned) _mm256_movemask_epi8(identifier32(chars));
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return identifierSse2(begin, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char* stringAvx2(const char* begin, const char* end) {
+        for (; end - begin >= 32; begin += 32) {
+            const __m256i chars = _mm256_loadu_si256((const __m256i*) begin);
+            const unsigned ends = (unsigned) _mm256_movemask_epi8(stringEnd32(chars));
+            if (ends) return begin + __builtin_ctz(ends);
+        }
+        return stringSse2(begin, end);
+    }
+
+    const CharScan::Kernels SSE2 = {
+        "sse2", whitespaceSse2, identifierSse2, lineComment, blockComment, stringSse2,
+    };
+
+    const CharScan::Kernels AVX2 = {
+        "avx2", whitespaceAvx2, identifierAvx2, lineComment, blockComment, stringAvx2,
+    };
+#endif
+}
+
+std::vector<const CharScan::Kernels*> CharScan::supported() {
+    std::vector<const Kernels*> kernels = { &SCALAR };
+
+#ifdef SANITY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) kernels.push_back(&SSE2);
+    if (__builtin_cpu_supports("sse2") && __builtin_cpu_supports("avx2")) kernels.push_back(&AVX2);
+#endif
+
+    return kernels;
+}
+
+const CharScan::Kernels& CharScan::best() {
+    static const Kernels& best = *supported().back();
+    return best;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef SANITY_CHAR_SCAN_H
+#define SANITY_CHAR_SCAN_H
+
+#include <vector>
+
+/**
+ * Kernels which find the end of a run of characters that the scanner would otherwise step over one at a time, such as
+ * whitespace or the rest of an identifier. Each kernel takes the range [begin, end) and returns a pointer to the first
+ * character in it which ends the run, or end if the whole range is part of it.
+ *
+ * Kernels are implemented with SSE2 and AVX2 where the CPU supports them, checking 16 or 32 characters at a time, along
+ * with a scalar fallback which checks one character at a time.
+ */
+namespace CharScan {
+    typedef const char* (*Kernel)(const char* begin, const char* end);
+
+    /**
+     * Set of kernels implemented with the same instruction set.
+     */
+    class Kernels {
+    public:
+        const char* name;
+        Kernel whitespace; // Ends at the first character which is not a space, tab, carriage return or newline.
+        Kernel identifier; // Ends at the first character which is not [a-zA-Z0-9_].
+        Kernel lineComment; // Ends at the first newline.
+        Kernel blockComment; // Ends at the first '*', which may start the terminating "*/".
+        Kernel string; // Ends at the first character which ends or escapes a string literal, or is illegal in one.
+    };
+
+    /**
+     * Returns the fastest kernels the CPU supports, chosen the first time this is called.
+     */
+    const Kernels& best();
+
+    /**
+     * Returns every set of kernels the CPU supports, starting with the scalar ones.
+     */
+    std::vector<const Kernels*> supported();
+}
+
+#endif //SANITY_CHAR_SCAN_H
\ No newline at end of file
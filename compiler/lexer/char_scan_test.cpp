@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include "char_scan.h"
+
+// Asserts that every supported set of kernels ends the same runs as the scalar kernels, for every start of every
+// suffix of the given text, so that runs end both within and after the vectorized blocks.
+void assertKernelsAgree(const std::string& text) {
+    const CharScan::Kernels& scalar = *CharScan::supported().front();
+    const char* end = text.data() + text.size();
+
+    for (const CharScan::Kernels* kernels : CharScan::supported()) {
+        for (const char* begin = text.data(); begin <= end; ++begin) {
+            ASSERT_EQ(scalar.whitespace(begin, end), kernels->whitespace(begin, end)) << kernels->name;
+            ASSERT_EQ(scalar.identifier(begin, end), kernels->identifier(begin, end)) << kernels->name;
+            ASSERT_EQ(scalar.lineComment(begin, end), kernels->lineComment(begin, end)) << kernels->name;
+            ASSERT_EQ(scalar.blockComment(begin, end), kernels->blockComment(begin, end)) << kernels->name;
+            ASSERT_EQ(scalar.string(begin, end), kernels->string(begin, end)) << kernels->name;
+        }
+    }
+}
+
+TEST(CharScan, SupportsScalarKernels) {
+    ASSERT_STREQ("scalar", CharScan::supported().front()->name);
+}
+
+TEST(CharScan, ScalarKernelsEndRuns) {
+    const CharScan::Kernels& scalar = *CharScan::supported().front();
+    const std::string text = " \t\r\n foo_Bar9 \"a\\b\" // c\n d*/";
+    const char* begin = text.data();
+    const char* end = text.data() + text.size();
+
+    ASSERT_EQ(begin + 5, scalar.whitespace(begin, end));
+    ASSERT_EQ(begin + 13, scalar.identifier(begin + 5, end));
+    ASSERT_EQ(begin + 16, scalar.string(begin + 15, end));
+    ASSERT_EQ(begin + 24, scalar.lineComment(begin + 20, end));
+    ASSERT_EQ(begin + 27, scalar.blockComment(begin + 25, end));
+    ASSERT_EQ(end, scalar.identifier(end, end));
+}
+
+TEST(CharScan, KernelsAgreeOnLongRuns) {
+    assertKernelsAgree(std::string(100, ' ') + "\t\r\n" + std::string(70, 'a') + "_Z09" + std::string(50, 'x') + "\n"
+        + std::string(40, '*') + "\"\\\'\t\r;");
+}
+
+TEST(CharScan, KernelsAgreeOnNonAsciiCharacters) {
+    // Bytes with the high bit set are negative as signed chars, and must not count as identifier characters.
+    assertKernelsAgree(std::string(40, 'a') + "\xC3\xA9" + std::string(40, 'b') + "\x80\xFF" + std::string(40, ' ')
+        + "\xDF\xE0" + std::string(40, '_'));
+}
+
+TEST(CharScan, KernelsAgreeOnRandomText) {
+    const std::string alphabet = " \t\r\n\"\'\\*/_-+09azAZ@[`{\x7F\x80\xFF";
+    std::srand(42);
+    for (int i = 0; i < 20; ++i) {
+        std::string text;
+        for (int j = 0; j < 200; ++j) {
+            // Mostly repeat the previous character, so that runs are long enough to span whole blocks.
+            const bool repeat = !text.empty() && std::rand() % 8 != 0;
+            text.push_back(repeat ? text.back() : alphabet[std::rand() % alphabet.size()]);
+        }
+        assertKernelsAgree(text);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "inline_stream.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "compiler/models/exceptions.h"
+#include "compiler/models/line_table.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+typedef Exceptions::SyntaxException SyntaxException;
+
+InlineStream::InlineStream(const std::experimental::string_view source)
+    : source(source), current(source.data()), start(source.data()), end(source.data() + source.size()) { }
+
+char InlineStream::front() const {
+    if (!this->active()) throw IllegalStateException("No characters left in the Stream.");
+
+    return *this->current;
+}
+
+void InlineStream::returnToken() {
+    this->result = std::move(this->buffer);
+    this->buffer.clear();
+
+    this->start = this->current;
+}
+
+void InlineStream::throwException(const std::string& message) const {
+    // Errors are rare, so lines are only found once one is thrown rather than tracked while advancing.
+    const uint32_t currentOffset = (uint32_t) (this->current - this->source.data());
+    const uint32_t startOffset = (uint32_t) (this->start - this->source.data());
+    const LineTable lines(this->source);
+
+    throw SyntaxException(message, lines.line(currentOffset), lines.column(startOffset), lines.column(currentOffset));
+}
+
+std::experimental::optional<std::string> InlineStream::extractResult() {
+    std::experimental::optional<std::string> token = std::move(this->result);
+
+    // If no token to return and there is still data to process, then something has gone wrong.
+    if (!token && (!this->buffer.empty() || this->current != this->end)) {
+        throw IllegalStateException("returnToken() not properly called before extractToken()");
+    }
+
+    this->result = std::experimental::nullopt;
+
+    return token;
+}
\ No newline at end of file
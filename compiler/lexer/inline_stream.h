@@ -0,0 +1,314 @@
+#ifndef SANITY_INLINE_STREAM_H
+#define SANITY_INLINE_STREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+
+/**
+ * Character matchers for InlineStream. A matcher is any callable taking the current position and the end of the input
+ * and returning whether the input at that position matches. It is only ever called with at least one character left,
+ * so matchers for a single character can read *current without checking the end.
+ *
+ * Matchers are empty classes rather than regexes, so each one is its own type and compiles down to a few comparisons
+ * wherever it is used.
+ */
+namespace Matchers {
+    /**
+     * Matches the given character.
+     */
+    template <char C>
+    class Is {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return *current == C;
+        }
+    };
+
+    /**
+     * Matches any character from Low to High inclusive.
+     */
+    template <char Low, char High>
+    class Range {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return *current >= Low && *current <= High;
+        }
+    };
+
+    /**
+     * Matches the given sequence of characters, such as the "//" starting a comment.
+     */
+    template <char... Chars>
+    class Text {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            static constexpr char chars[] = { Chars... };
+            return (size_t) (end - current) >= sizeof...(Chars) && std::equal(chars, chars + sizeof...(Chars), current);
+        }
+    };
+
+    /**
+     * Matches if any of the given matchers match.
+     */
+    template <typename... Alternatives>
+    class AnyOf;
+
+    template <>
+    class AnyOf<> {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return false;
+        }
+    };
+
+    template <typename First, typename... Rest>
+    class AnyOf<First, Rest...> {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return First()(current, end) || AnyOf<Rest...>()(current, end);
+        }
+    };
+
+    /**
+     * Matches if the given matcher does not.
+     */
+    template <typename Matcher>
+    class Not {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return !Matcher()(current, end);
+        }
+    };
+
+    /**
+     * Matches any character.
+     */
+    class Any {
+    public:
+        bool operator()(const char* current, const char* end) const {
+            return true;
+        }
+    };
+
+    typedef AnyOf<Is<' '>, Is<'\t'>, Is<'\r'>, Is<'\n'>> Whitespace;
+    typedef Range<'0', '9'> Digit;
+    typedef AnyOf<Range<'a', 'z'>, Range<'A', 'Z'>> Letter;
+    typedef AnyOf<Letter, Is<'_'>> IdentifierStart;
+    typedef AnyOf<Letter, Digit, Is<'_'>> IdentifierChar;
+}
+
+/**
+ * Stream with the same fluent interface as Stream, but which takes its matchers and callbacks as template parameters
+ * rather than regexes and std::functions. Every rule written with it is specialized for the matchers and lambdas it
+ * uses, so the compiler can inline a whole chain of calls into one loop over the input, rather than making an indirect
+ * call and a regex search for every character. The input is read in place rather than copied into a deque.
+ *
+ * Callbacks take the stream as an InlineStream*, just like Stream's do, so a rule reads the same with either of them:
+ *
+ *     stream->match(Matchers::Digit(), [](InlineStream* stream) {
+ *         stream->consumeWhile(Matchers::Digit())->returnToken();
+ *     });
+ */
+class InlineStream {
+private:
+    std::experimental::string_view source;
+    const char* current;
+    const char* start;
+    const char* end;
+    std::string buffer;
+    std::experimental::optional<std::string> result;
+
+    void advance(const int numChars, const bool updateStartColumn) {
+        this->current += std::min((ptrdiff_t) numChars, this->end - this->current);
+
+        // If no characters have been consumed, then the token has not started yet, so move its start along.
+        if (updateStartColumn && this->buffer.empty()) this->start = this->current;
+    }
+
+    /**
+     * Returns whether or not this stream is active and able to be lexically analyzed. The stream is not active if
+     * returnToken() has been called, but the Token has not yet been extracted by extractResult(). The stream is also
+     * not active if all input characters have been read and processed.
+     */
+    bool active() const {
+        return !this->result && this->current != this->end;
+    }
+
+    template <typename Condition, typename Callback>
+    InlineStream* repeat(const Condition& condition, const Callback& callback,
+            const std::experimental::optional<const std::string>& eofError) {
+        if (!this->active()) return this;
+
+        bool matched;
+        do {
+            matched = condition(this->current, this->end);
+            if (matched) callback(this);
+        } while (matched && this->active());
+
+        if (this->current == this->end && eofError) this->throwException(eofError.value());
+
+        return this;
+    }
+
+public:
+    /**
+     * Creates a stream over the given source, which must outlive it.
+     */
+    explicit InlineStream(std::experimental::string_view source);
+
+    /**
+     * Returns the first character in the sequence.
+     * @throws IllegalStateException
+     */
+    char front() const;
+
+    /**
+     * Ignores the next amount of characters in the stream. If updateStartColumn is true, then the stream will assume
+     * that the values ignored are not associated with any Token, and the start position will be updated to skip over
+     * these characters.
+     */
+    InlineStream* ignore(const int numChars = 1, const bool updateStartColumn = false) {
+        if (this->active()) this->advance(numChars, updateStartColumn);
+        return this;
+    }
+
+    /**
+     * Ignores the characters for as long as the matcher matches. If updateStartColumn is true, then the stream will
+     * assume that the values are ignored and not associated with any Token. If an eofError is provided, and the end of
+     * the file is reached, then it will throw an error with that message.
+     * @throws SyntaxException
+     */
+    template <typename Matcher>
+    InlineStream* ignoreWhile(const Matcher& matcher, const bool updateStartColumn = false,
+            const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt) {
+        return this->repeat(matcher, [updateStartColumn](InlineStream* stream) {
+            stream->ignore(1, updateStartColumn);
+        }, eofError);
+    }
+
+    /**
+     * Ignores the characters until the matcher matches. If updateStartColumn is true, then the stream will assume that
+     * the values are ignored and not associated with any Token. If an eofError is provided, and the end of the file is
+     * reached, then it will throw an error with that message.
+     * @throws SyntaxException
+     */
+    template <typename Matcher>
+    InlineStream* ignoreUntil(const Matcher& matcher, const bool updateStartColumn = false,
+            const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt) {
+        return this->repeat([&matcher](const char* current, const char* end) {
+            return !matcher(current, end);
+        }, [updateStartColumn](InlineStream* stream) {
+            stream->ignore(1, updateStartColumn);
+        }, eofError);
+    }
+
+    /**
+     * Consumes the next amount of characters by including them in the next Token.
+     */
+    InlineStream* consume(const int numChars = 1) {
+        if (!this->active()) return this;
+
+        const ptrdiff_t count = std::min((ptrdiff_t) numChars, this->end - this->current);
+        this->buffer.append(this->current, (size_t) count);
+        this->advance((int) count, true /* updateStartColumn */);
+
+        return this;
+    }
+
+    /**
+     * Consume the provided character by including it in the next Token. Does not advance the stream.
+     */
+    InlineStream* consume(const char character) {
+        this->buffer.push_back(character);
+        return this;
+    }
+
+    /**
+     * Consumes the characters for as a long as the matcher matches. If eofError is provided and the end of file is
+     * detected, then an error is thrown with the given message.
+     * @throws SyntaxException
+     */
+    template <typename Matcher>
+    InlineStream* consumeWhile(const Matcher& matcher,
+            const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt) {
+        return this->repeat(matcher, [](InlineStream* stream) {
+            stream->consume();
+        }, eofError);
+    }
+
+    /**
+     * If the current state of the stream matches the given matcher, then the callback is invoked.
+     */
+    template <typename Matcher, typename Callback>
+    InlineStream* match(const Matcher& matcher, const Callback& callback) {
+        if (this->active() && matcher(this->current, this->end)) callback(this);
+        return this;
+    }
+
+    /**
+     * If the current state of the stream matches the given matcher, then the thenCb is invoked, otherwise the elseCb is
+     * invoked.
+     */
+    template <typename Matcher, typename ThenCallback, typename ElseCallback>
+    InlineStream* match(const Matcher& matcher, const ThenCallback& thenCb, const ElseCallback& elseCb) {
+        if (!this->active()) return this;
+
+        if (matcher(this->current, this->end)) {
+            thenCb(this);
+        } else {
+            elseCb(this);
+        }
+
+        return this;
+    }
+
+    /**
+     * As long as the current state of the stream matches the given matcher, the callback is invoked. If an eofError is
+     * provided, and the end of the file is reached, then it will throw an error with that message.
+     * @throws SyntaxException
+     */
+    template <typename Matcher, typename Callback>
+    InlineStream* repeatWhile(const Matcher& matcher, const Callback& callback,
+            const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt) {
+        return this->repeat(matcher, callback, eofError);
+    }
+
+    /**
+     * Until the current state of the stream matches the given matcher, the callback is invoked. If an eofError is
+     * provided, and the end of the file is reached, then it will throw an error with that message.
+     * @throws SyntaxException
+     */
+    template <typename Matcher, typename Callback>
+    InlineStream* repeatUntil(const Matcher& matcher, const Callback& callback,
+            const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt) {
+        return this->repeat([&matcher](const char* current, const char* end) {
+            return !matcher(current, end);
+        }, callback, eofError);
+    }
+
+    /**
+     * Saves the current state of the buffer and will return the consumed text when extractResult() is called. All
+     * other functionality is blocked until the result is extracted.
+     * @see #extractResult()
+     */
+    void returnToken();
+
+    /**
+     * Throw an exception with the given message. Automatically attaches the current line and col numbers to it.
+     * @throws SyntaxException
+     */
+    void throwException(const std::string& message) const;
+
+    /**
+     * Takes the text previously saved by returnToken() and returns it while resetting the current state of the stream
+     * to continue processing the input. Returns std::experimental::nullopt if the input has reached EOF.
+     * @throws IllegalStateException
+     * @see #returnToken()
+     */
+    std::experimental::optional<std::string> extractResult();
+};
+
+#endif //SANITY_INLINE_STREAM_H
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <experimental/optional>
+#include "inline_stream.h"
+#include "compiler/models/exceptions.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+typedef Exceptions::SyntaxException SyntaxException;
+
+template <typename Matcher>
+bool matches(const Matcher& matcher, const char* text) {
+    return matcher(text, text + std::strlen(text));
+}
+
+TEST(Matchers, MatchCharacterClasses) {
+    ASSERT_TRUE(matches(Matchers::Is<'a'>(), "a"));
+    ASSERT_FALSE(matches(Matchers::Is<'a'>(), "b"));
+    ASSERT_TRUE(matches(Matchers::Digit(), "7"));
+    ASSERT_FALSE(matches(Matchers::Digit(), "x"));
+    ASSERT_TRUE(matches(Matchers::Whitespace(), "\t"));
+    ASSERT_TRUE(matches(Matchers::IdentifierStart(), "_"));
+    ASSERT_FALSE(matches(Matchers::IdentifierStart(), "1"));
+    ASSERT_TRUE(matches(Matchers::IdentifierChar(), "1"));
+    ASSERT_FALSE(matches(Matchers::IdentifierChar(), "-"));
+    ASSERT_TRUE(matches(Matchers::Not<Matchers::Digit>(), "x"));
+    ASSERT_TRUE(matches(Matchers::Any(), "\n"));
+}
+
+TEST(Matchers, MatchTextOnlyWhenEveryCharacterIsLeft) {
+    ASSERT_TRUE(matches(Matchers::Text<'/', '/'>(), "// Comment"));
+    ASSERT_FALSE(matches(Matchers::Text<'/', '/'>(), "/* Comment */"));
+    ASSERT_FALSE(matches(Matchers::Text<'/', '/'>(), "/"));
+}
+
+TEST(InlineStream, FrontReturnsFirstCharacter) {
+    InlineStream stream("abc123");
+
+    ASSERT_EQ('a', stream.front());
+}
+
+TEST(InlineStream, IgnoresWhileCharacterMatches) {
+    InlineStream stream("abc123");
+    stream.ignoreWhile(Matchers::Letter());
+
+    ASSERT_EQ('1', stream.front());
+}
+
+TEST(InlineStream, IgnoresUntilCharacterMatches) {
+    InlineStream stream("abc123");
+    stream.ignoreUntil(Matchers::Digit());
+
+    ASSERT_EQ('1', stream.front());
+}
+
+TEST(InlineStream, ConsumesCharacters) {
+    InlineStream stream("abc123");
+    stream.consume(3)->returnToken();
+
+    ASSERT_EQ("abc", stream.extractResult().value());
+}
+
+TEST(InlineStream, ConsumesTheGivenCharacterWithoutAdvancing) {
+    InlineStream stream("abc123");
+    stream.consume('z')->returnToken();
+
+    ASSERT_EQ("z", stream.extractResult().value());
+    ASSERT_EQ('a', stream.front());
+}
+
+TEST(InlineStream, ConsumesWhileCharacterMatches) {
+    InlineStream stream("abc123");
+    stream.consumeWhile(Matchers::Letter())->returnToken();
+
+    ASSERT_EQ("abc", stream.extractResult().value());
+}
+
+TEST(InlineStream, MatchInvokesThenOrElseCallback) {
+    InlineStream stream("abc123");
+    bool thenCalled = false;
+    bool elseCalled = false;
+    stream.match(Matchers::Digit(), [&thenCalled](InlineStream* stream) {
+        thenCalled = true;
+    }, [&elseCalled](InlineStream* stream) {
+        elseCalled = true;
+    });
+
+    ASSERT_FALSE(thenCalled);
+    ASSERT_TRUE(elseCalled);
+}
+
+TEST(InlineStream, RepeatsWhileAndUntilMatcherMatches) {
+    InlineStream stream("abc123");
+    stream.repeatWhile(Matchers::Letter(), [](InlineStream* stream) {
+        stream->consume();
+    })->repeatUntil(Matchers::Is<'3'>(), [](InlineStream* stream) {
+        stream->consume();
+    })->returnToken();
+
+    ASSERT_EQ("abc12", stream.extractResult().value());
+}
+
+TEST(InlineStream, ThrowsExceptionOnEofOnlyWhenCalledWithMessage) {
+    ASSERT_NO_THROW(InlineStream("abc").ignoreWhile(Matchers::Any()));
+    ASSERT_NO_THROW(InlineStream("abc1").consumeWhile(Matchers::Letter(), std::string("Unexpected EOF.")));
+    ASSERT_THROW(InlineStream("abc").ignoreUntil(Matchers::Is<'z'>(), true /* updateStartColumn */,
+        std::string("Unexpected EOF.")), SyntaxException);
+    ASSERT_THROW(InlineStream("abc").repeatWhile(Matchers::Any(), [](InlineStream* stream) {
+        stream->ignore();
+    }, std::string("Unexpected EOF.")), SyntaxException);
+}
+
+TEST(InlineStream, CallsAfterReturnTokenAreIgnoredUntilNextRun) {
+    InlineStream stream("abc 123 \"a\\\"b\"");
+
+    std::vector<std::string> tokens;
+    std::experimental::optional<std::string> token;
+    while ((token = stream.ignoreWhile(Matchers::Whitespace(), true /* updateStartColumn */)
+            ->match(Matchers::IdentifierStart(), [](InlineStream* stream) {
+                stream->consumeWhile(Matchers::IdentifierChar())->returnToken();
+            })->match(Matchers::Digit(), [](InlineStream* stream) {
+                stream->consumeWhile(Matchers::Digit())->returnToken();
+            })->match(Matchers::Is<'\"'>(), [](InlineStream* stream) {
+                stream->ignore()->repeatUntil(Matchers::Is<'\"'>(), [](InlineStream* stream) {
+                    stream->match(Matchers::Is<'\\'>(), [](InlineStream* stream) {
+                        stream->ignore()->consume();
+                    }, [](InlineStream* stream) {
+                        stream->consume();
+                    });
+                }, std::string("Unterminated string."))->ignore()->returnToken();
+            })->extractResult())) {
+        tokens.push_back(token.value());
+    }
+
+    ASSERT_EQ(std::vector<std::string>({ "abc", "123", "a\"b" }), tokens);
+}
+
+TEST(InlineStream, ExtractResultThrowsExceptionWithoutReturnToken) {
+    InlineStream stream("abc");
+    stream.consume();
+
+    ASSERT_THROW(stream.extractResult(), IllegalStateException);
+}
+
+TEST(InlineStream, ReportsPositionOfExceptions) {
+    InlineStream stream("ab\ncd");
+
+    stream.ignore(4, true /* updateStartColumn */)->consume();
+    try {
+        stream.throwException("Test");
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(std::string("Syntax exception (line 2, col 2 -> 3): Test"), ex.what());
+    }
+}
\ No newline at end of file
@@ -1,101 +1,174 @@
 #include "lexer.h"
-#include "stream.h"
+#include "scanner.h"
+#include "compiler/models/diagnostics.h"
 #include "compiler/models/token.h"
-#include "compiler/models/token_builder.h"
-#include "compiler/models/exceptions.h"
-#include <memory>
-#include <queue>
-#include <regex>
-
-typedef Exceptions::AssertionException AssertionException;
-typedef Exceptions::SyntaxException SyntaxException;
-
-// Returns the given control char (the one that comes after the backslash, so the "n" in "\n") as its escaped value.
-char escapeCharacter(const char controlChar, const Stream* stream) {
-    switch (controlChar) {
-        case 'n': return '\n';
-        case 'r': return '\r';
-        case 't': return '\t';
-        case '\'': return '\'';
-        case '\"': return '\"';
-        case '\\': return '\\';
-        default: stream->throwException("Unexpected escape character: \\" + std::string(1, controlChar));
+#include "compiler/models/token_list.h"
+#include "compiler/utils/thread_pool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <utility>
+#include <vector>
+#include <experimental/optional>
+#include <experimental/string_view>
+
+namespace {
+    // Tokens scanned from one chunk of the source, assuming that no Token or comment crosses into it.
+    class Chunk {
+    public:
+        uint32_t start;
+        uint32_t limit;
+        std::vector<Token> tokens;
+        uint32_t stop; // Where scanning stopped, which is past the limit if a comment crosses it.
+        std::exception_ptr error; // Thrown while scanning, but only if the chunk is not rescanned.
+    };
+
+    // Returns the offsets at which to split the source into about the given number of chunks, from 0 to the end of the
+    // source. Each chunk but the last ends just after a newline.
+    std::vector<uint32_t> split(const std::experimental::string_view source, const size_t count) {
+        std::vector<uint32_t> boundaries = { 0 };
+        for (size_t i = 1; i < count; ++i) {
+            const size_t target = std::max(source.size() * i / count, (size_t) boundaries.back());
+            const void* newline = std::memchr(source.data() + target, '\n', source.size() - target);
+            if (!newline) break;
+
+            const auto boundary = (uint32_t) ((const char*) newline - source.data() + 1);
+            if (boundary > boundaries.back() && boundary < source.size()) boundaries.push_back(boundary);
+        }
+        boundaries.push_back((uint32_t) source.size());
+
+        return boundaries;
+    }
+
+    void scan(const std::experimental::string_view source, Chunk& chunk) {
+        Scanner scanner(source, chunk.start, chunk.limit);
+        try {
+            std::experimental::optional<Token> token;
+            while ((token = scanner.next())) chunk.tokens.push_back(token.value());
+        } catch (...) {
+            chunk.error = std::current_exception();
+        }
+        chunk.stop = scanner.offset();
+    }
+
+    // Rescans the start of a chunk from where the serial scan would actually reach it, until a Token starts at the same
+    // offset as one scanned in parallel. From then on, both scans are in the same state, so the rest of the chunk's
+    // Tokens are kept.
+    void rescan(const std::experimental::string_view source, Chunk& chunk, const uint32_t resume) {
+        Scanner scanner(source, resume, std::max(resume, chunk.limit));
+
+        std::vector<Token> tokens;
+        std::experimental::optional<Token> token;
+        while ((token = scanner.next())) {
+            const auto match = std::lower_bound(chunk.tokens.begin(), chunk.tokens.end(), token->offset,
+                [](const Token& scanned, const uint32_t offset) { return scanned.offset < offset; });
+            if (match != chunk.tokens.end() && match->offset == token->offset) {
+                tokens.insert(tokens.end(), match, chunk.tokens.end());
+                chunk.tokens = std::move(tokens);
+                return;
+            }
+
+            tokens.push_back(token.value());
+        }
+
+        chunk.tokens = std::move(tokens);
+        chunk.stop = scanner.offset();
+        chunk.error = nullptr;
+    }
+}
+
+TokenList Lexer::tokenize(const std::experimental::string_view source) {
+    std::vector<Token> tokens;
+
+    Scanner scanner(source);
+    std::experimental::optional<Token> token;
+    while ((token = scanner.next())) {
+        tokens.push_back(token.value());
+    }
+
+    return TokenList(source, std::move(tokens));
+}
+
+Result<TokenList> Lexer::tryTokenize(const std::experimental::string_view source) {
+    std::vector<Token> tokens;
+    Diagnostics diagnostics;
+
+    Scanner scanner(source);
+    scanner.report(diagnostics);
+    std::experimental::optional<Token> token;
+    while ((token = scanner.next())) {
+        tokens.push_back(token.value());
     }
 
-    throw AssertionException("Unreachable statement");
+    if (scanner.failed()) return diagnostics.all().front();
+    return TokenList(source, std::move(tokens));
 }
 
-std::queue<std::shared_ptr<const Token>> Lexer::tokenize(std::queue<char>& chars) {
-    auto tokens = std::queue<std::shared_ptr<const Token>>();
-
-    auto stream = std::make_unique<Stream>(Stream(chars));
-    std::experimental::optional<std::shared_ptr<const Token>> token;
-    do {
-        token = stream->repeatWhile(std::regex("^([ \t\n\r]|//|/\\*)"), 2, [](Stream* stream) {
-            stream->repeatWhile(std::regex("^[ \t\n\r]"), 1, [](Stream* stream) {
-                stream->ignore(1 /* whitespace */, true /* updateStartColumn */);
-            })->match(std::regex("^//"), 2, [](Stream* stream) {
-                stream->ignore(2 /* slashes */, true /* updateStartColumn */);
-                stream->ignoreUntil(std::regex("^\\n"), 1, true /* updateStartColumn */);
-                stream->ignore(1 /* newline */, true /* updateStartColumn */);
-            })->match(std::regex("^/\\*"), 2, [](Stream* stream) {
-                stream->ignore(2 /* open comment */, true /* updateStartColumn */);
-                stream->ignoreUntil(std::regex("^\\*/"), 2, true /* updateStartColumn */,
-                        std::string("Unexpected EOF in block comment."));
-                stream->ignore(2 /* close comment */, true /* updateStartColumn */);
-            });
-        })->match(std::regex("^[a-zA-Z_]"), 1, [](Stream* stream) {
-            stream->consumeWhile(std::regex("^[a-zA-Z0-9_]"), 1)->returnToken();
-        })->match(std::regex("^[0-9]"), 1, [](Stream* stream) {
-            stream->consumeWhile(std::regex("^[0-9]"), 1)->returnToken([](const std::string& source) {
-                return TokenBuilder(source).setIntegerLiteral(true);
-            });
-        })->match(std::regex("^\""), 1, [](Stream* stream) { // Then
-            stream->ignore(/* open double quote */)->repeatUntil(std::regex("^[\"\n\t\r]"), 1, [](Stream* stream) {
-                stream->match(std::regex("^\\\\"), 1, [](Stream* stream) { // Then, escaped char
-                    // Ignore in a separate statement so it occurs before the stream->front() call.
-                    stream->ignore(/* backslash */);
-                    stream->consume(escapeCharacter(stream->front(), stream))->ignore(/* control character */);
-                }, [](Stream* stream) { // Else, non-escaped character
-                    stream->match(std::regex("^\'"), 1, [](Stream* stream) { // Then, single quote in string
-                        stream->throwException(R"(Cannot use ' in a string literal, use \' instead.)");
-                    }, [](Stream* stream) { // Else, non single quote character
-                        stream->consume(/* char */);
-                    });
-                });
-            }, std::string("Unexpected EOF"))->match(std::regex("^\""), 1, [](Stream* stream) { // Then
-                stream->ignore(/* close double quote */)->returnToken([](const std::string& source) {
-                    return TokenBuilder(source).setStringLiteral(true);
-                });
-            }, [](Stream* stream) { // Else
-                stream->throwException("Illegal character in string.");
-            });
-        })->match(std::regex("^\'"), 1, [](Stream* stream) {
-            stream->ignore(/* open quote */)->match(std::regex("^\\\\"), 1, [](Stream* stream) { // Then, escaped char
-                // Ignore in a separate statement so it occurs before the stream->front() call.
-                stream->ignore(/* backslash */);
-                stream->consume(escapeCharacter(stream->front(), stream))->ignore(/* control character */);
-            }, [](Stream* stream) { // Else, non-escaped character
-                if (std::regex_match(std::string(1, stream->front()), std::regex("[\n\t\r\'\"]"))) {
-                    stream->throwException("Invalid character in character literal");
-                } else {
-                    stream->consume(/* char */);
-                }
-            })->match(std::regex("^\'"), 1, [](Stream* stream) { // Then
-                stream->ignore(/* close quote */)->returnToken([](const std::string& source) {
-                    return TokenBuilder(source).setCharLiteral(true);
-                });
-            }, [](Stream* stream) { // Else
-                stream->throwException("Expected character literal to end with a closing single quote.");
-            });
-        })->match(std::regex("^->"), 2, [](Stream* stream) {
-            stream->consume(2 /* -> */)->returnToken();
-        })->match(std::regex("^[^a-zA-Z0-9]"), 1, [](Stream* stream) {
-            stream->consume(/* punctuation */)->returnToken();
-        })->extractResult();
-
-        if (token) tokens.push(token.value());
-    } while (token);
-
-    return tokens;
+TokenList Lexer::tokenize(const std::experimental::string_view source, ThreadPool& pool) {
+    const std::vector<uint32_t> boundaries = split(source,
+        std::min(pool.size() * CHUNKS_PER_THREAD, source.size() / MIN_CHUNK_SIZE));
+    if (boundaries.size() <= 2) return Lexer::tokenize(source);
+
+    std::vector<Chunk> chunks(boundaries.size() - 1);
+    std::vector<std::future<void>> scanned;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        Chunk& chunk = chunks[i];
+        chunk.start = boundaries[i];
+        chunk.limit = boundaries[i + 1];
+        scanned.push_back(pool.submit([source, &chunk]() { scan(source, chunk); }));
+    }
+    for (std::future<void>& result : scanned) result.get();
+
+    // Stitch the chunks together in order, as the serial scan would have reached them.
+    std::vector<Token> tokens;
+    uint32_t resume = 0;
+    for (Chunk& chunk : chunks) {
+        if (resume != chunk.start) rescan(source, chunk, resume);
+        if (chunk.error) std::rethrow_exception(chunk.error);
+
+        tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+        resume = chunk.stop;
+    }
+
+    return TokenList(source, std::move(tokens));
+}
+
+Lexer::Relexed Lexer::relex(const TokenList& previous, const std::experimental::string_view source, const Edit& edit) {
+    // The first Token which ends at or after the edit may have changed, even if the edit only touched the character just
+    // after it. Everything up to the end of the Token before it is unchanged, and scanning is between Tokens there.
+    const auto first = std::lower_bound(previous.begin(), previous.end(), edit.offset,
+        [](const Token& token, const uint32_t offset) { return token.offset + token.length < offset; });
+    const uint32_t resume = first == previous.begin() ? 0 : (first - 1)->offset + (first - 1)->length;
+
+    std::vector<Token> tokens;
+    tokens.reserve(previous.size() + 16);
+    tokens.insert(tokens.end(), previous.begin(), first);
+    const size_t firstIndex = tokens.size();
+
+    // Once a Token starts after the edit at the same place in the text as a previous Token did, both scans are in the
+    // same state with the same text left, so the rest of the previous Tokens are kept.
+    const int64_t shift = (int64_t) edit.inserted - (int64_t) edit.removed;
+    auto kept = first;
+    Scanner scanner(source, resume, (uint32_t) source.size());
+    std::experimental::optional<Token> token;
+    while ((token = scanner.next())) {
+        if (token->offset >= edit.offset + edit.inserted) {
+            const auto offset = (uint32_t) (token->offset - shift);
+            kept = std::lower_bound(kept, previous.end(), offset,
+                [](const Token& previous, const uint32_t offset) { return previous.offset < offset; });
+            if (kept != previous.end() && kept->offset == offset) break;
+        }
+
+        tokens.push_back(token.value());
+    }
+    if (!token) kept = previous.end();
+
+    const size_t newEnd = tokens.size();
+    const auto oldEnd = (size_t) (kept - previous.begin());
+    tokens.insert(tokens.end(), kept, previous.end());
+    for (size_t i = newEnd; i < tokens.size(); ++i) tokens[i].offset = (uint32_t) (tokens[i].offset + shift);
+
+    return Relexed { TokenList(source, std::move(tokens)), firstIndex, oldEnd, newEnd };
 }
\ No newline at end of file
@@ -1,15 +1,77 @@
 #ifndef SANITY_LEXER_H
 #define SANITY_LEXER_H
 
-#include <memory>
-#include <queue>
-#include "../models/token.h"
+#include <cstddef>
+#include <cstdint>
+#include <experimental/string_view>
+#include "../models/diagnostics.h"
+#include "../models/token_list.h"
+#include "../utils/thread_pool.h"
 
 namespace Lexer {
+    // Sources are only split into chunks of at least this many bytes, smaller ones are not worth the overhead.
+    const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+    // Number of chunks to split a source into per thread, so threads which finish early can take another chunk.
+    const size_t CHUNKS_PER_THREAD = 4;
+
+    /**
+     * Tokenize the given source text into a TokenList. The source is scanned in place and is not copied, so it must
+     * outlive the returned TokenList.
+     * @throws SyntaxException
+     */
+    TokenList tokenize(std::experimental::string_view source);
+
+    /**
+     * Tokenize the given source text into a TokenList, returning the syntax error which stopped it as a Diagnostic
+     * rather than throwing it. The source must outlive the returned TokenList.
+     */
+    Result<TokenList> tryTokenize(std::experimental::string_view source);
+
+    /**
+     * Tokenize the given source text into a TokenList, scanning chunks of it in parallel on the given pool. The
+     * resulting Tokens and any SyntaxException thrown are identical to those of tokenizing the source serially.
+     *
+     * The source is split just after newlines, and each chunk is scanned as if it began between two Tokens. Only a
+     * block comment can cross a newline, so when one crosses into a chunk, that chunk is rescanned from the end of the
+     * comment until its Tokens line up with those scanned in parallel again. Since Tokens only record offsets into the
+     * source, no line numbers need adjusting.
+     * @throws SyntaxException
+     */
+    TokenList tokenize(std::experimental::string_view source, ThreadPool& pool);
+
+    /**
+     * Edit which replaced the bytes [offset, offset + removed) of a source with inserted new bytes.
+     */
+    class Edit {
+    public:
+        uint32_t offset;
+        uint32_t removed;
+        uint32_t inserted;
+    };
+
+    /**
+     * Tokens of an edited source, along with which of them changed. Tokens [first, oldEnd) of the previous TokenList
+     * were replaced by Tokens [first, newEnd) of the new one. Every other Token is the same as before, apart from those
+     * after the edit being shifted by its change in length.
+     */
+    class Relexed {
+    public:
+        TokenList tokens;
+        size_t first;
+        size_t oldEnd;
+        size_t newEnd;
+    };
+
     /**
-     * Tokenize the given queue of characters into a queue of Tokens.
+     * Tokenize an edited source given the TokenList of the source before the edit. Only the source from the end of the
+     * last Token before the edit is rescanned, until a Token starts at the same place in the text after the edit as one
+     * did before it. From then on, the rest of the previous Tokens are kept and only shifted, so the cost depends on
+     * the size of the edit rather than the size of the source. The resulting Tokens and any SyntaxException thrown are
+     * identical to those of tokenizing the edited source from scratch.
+     * @throws SyntaxException
      */
-    std::queue<std::shared_ptr<const Token>> tokenize(std::queue<char>& chars);
+    Relexed relex(const TokenList& previous, std::experimental::string_view source, const Edit& edit);
 }
 
 #endif //SANITY_LEXER_H
\ No newline at end of file
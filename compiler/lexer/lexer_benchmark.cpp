@@ -0,0 +1,59 @@
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "compiler/models/token_list.h"
+#include "compiler/utils/thread_pool.h"
+
+DEFINE_int32(size_mb, 64, "Size of the generated source to tokenize, in megabytes.");
+DEFINE_int32(runs, 5, "Number of times to tokenize the source with each number of threads, keeping the fastest.");
+
+// Generates a source of at least the given size which resembles machine-generated Sanity code.
+std::string generateSource(const size_t size) {
+    std::string source;
+    source.reserve(size + 256);
+    for (int i = 0; source.size() < size; ++i) {
+        source += "let value" + std::to_string(i) + ": int = " + std::to_string(i) + " * (value + 42) - other / 7;\n";
+        if (i % 16 == 0) source += "/* Generated block comment\n   spanning lines. */ puts(\"Hello, World!\\n\");\n";
+        if (i % 16 == 8) source += "putchar(\'\\n\'); // Trailing comment\n";
+    }
+    return source;
+}
+
+// Returns the fastest time, in seconds, taken by the given tokenization over the given number of runs.
+template <typename Tokenize>
+double fastest(const int runs, Tokenize tokenize) {
+    double best = 0;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        const TokenList tokens = tokenize();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+// Measures how tokenizing a large source scales with the number of threads.
+int main(int argc, char* argv[]) {
+    gflags::SetUsageMessage("Benchmarks tokenizing a generated source serially and with 1 to 16 threads.");
+    gflags::ParseCommandLineFlags(&argc, &argv, true /* remove flags from argv */);
+
+    const std::string source = generateSource((size_t) FLAGS_size_mb * 1024 * 1024);
+    const double megabytes = source.size() / (1024.0 * 1024.0);
+
+    const double serial = fastest(FLAGS_runs, [&source]() { return Lexer::tokenize(source); });
+    std::printf("%-10s %10s %10s %8s\n", "threads", "seconds", "MB/s", "speedup");
+    std::printf("%-10s %10.4f %10.1f %8.2f\n", "serial", serial, megabytes / serial, 1.0);
+
+    for (const size_t threads : std::vector<size_t>({ 1, 2, 4, 8, 16 })) {
+        ThreadPool pool(threads);
+        const double parallel = fastest(FLAGS_runs, [&source, &pool]() { return Lexer::tokenize(source, pool); });
+        std::printf("%-10zu %10.4f %10.1f %8.2f\n", threads, parallel, megabytes / parallel, serial / parallel);
+    }
+
+    return 0;
+}
\ No newline at end of file
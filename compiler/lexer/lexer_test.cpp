@@ -1,277 +1,405 @@
 #include <gtest/gtest.h>
 #include "lexer.h"
-#include "compiler/utils/queue_utils.h"
+#include "compiler/models/diagnostics.h"
 #include "compiler/models/exceptions.h"
-#include <memory>
-#include <queue>
+#include "compiler/models/token.h"
+#include "compiler/models/token_list.h"
+#include "compiler/utils/thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
 
 typedef Exceptions::SyntaxException SyntaxException;
 
 TEST(Lexer, TokenizesWholeWords) {
-    std::queue<char> q = QueueUtils::queueify("Hello");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("Hello");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("Hello", token->source);
+    const Token& token = tokens[0];
+    ASSERT_EQ("Hello", tokens.text(token));
 }
 
 TEST(Lexer, TokenizesWholeWordsWithUnderscores) {
-    std::queue<char> q = QueueUtils::queueify("_test test_one");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("_test test_one");
 
     ASSERT_EQ(2, tokens.size());
 
-    std::shared_ptr<const Token> first = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("_test", first->source);
+    const Token& first = tokens[0];
+    ASSERT_EQ("_test", tokens.text(first));
 
-    std::shared_ptr<const Token> second = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("test_one", second->source);
+    const Token& second = tokens[1];
+    ASSERT_EQ("test_one", tokens.text(second));
 }
 
 TEST(Lexer, TokenizesWholeWordsWithNumbers) {
-    std::queue<char> q = QueueUtils::queueify("test123");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("test123");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("test123", token->source);
+    const Token& token = tokens[0];
+    ASSERT_EQ("test123", tokens.text(token));
 }
 
 TEST(Lexer, TokenizesNumbers) {
-    std::queue<char> q = QueueUtils::queueify("123 test");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("123 test");
 
     ASSERT_EQ(2, tokens.size());
 
-    std::shared_ptr<const Token> first = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("123", first->source);
+    const Token& first = tokens[0];
+    ASSERT_EQ("123", tokens.text(first));
 
-    std::shared_ptr<const Token> second = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("test", second->source);
+    const Token& second = tokens[1];
+    ASSERT_EQ("test", tokens.text(second));
 }
 
 TEST(Lexer, TokenizesCharacterLiterals) {
-    std::queue<char> q = QueueUtils::queueify("\'a\'");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("\'a\'");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("a", token->source);
-    ASSERT_EQ(true, token->isCharLiteral);
+    const Token& token = tokens[0];
+    ASSERT_EQ('a', tokens.charValue(token));
+    ASSERT_EQ(Token::CHAR_LITERAL, token.kind);
 }
 
 TEST(Lexer, TokenizesIntegerLiterals) {
-    std::queue<char> q = QueueUtils::queueify("1234");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("1234");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("1234", token->source);
-    ASSERT_EQ(true, token->isIntegerLiteral);
+    const Token& token = tokens[0];
+    ASSERT_EQ(1234, tokens.integerValue(token));
+    ASSERT_EQ(Token::INTEGER_LITERAL, token.kind);
 }
 
 TEST(Lexer, TokenizesStringLiterals) {
-    std::queue<char> q = QueueUtils::queueify("\"Hello World!\"");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("\"Hello World!\"");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("Hello World!", token->source);
-    ASSERT_EQ(true, token->isStringLiteral);
+    const Token& token = tokens[0];
+    ASSERT_EQ("Hello World!", tokens.stringValue(token));
+    ASSERT_EQ(Token::STRING_LITERAL, token.kind);
 }
 
 TEST(Lexer, TokenizingUnterminatedCharacterThrowsSyntaxException) {
-    std::queue<char> q = QueueUtils::queueify("\'ab");
-    ASSERT_THROW(Lexer::tokenize(q), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'ab"), SyntaxException);
 }
 
 TEST(Lexer, TokenizingUnterminatedStringThrowsSyntaxException) {
-    std::queue<char> q = QueueUtils::queueify("\"test");
-    ASSERT_THROW(Lexer::tokenize(q), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"test"), SyntaxException);
+}
+
+TEST(Lexer, ReturnsSyntaxErrorAsDiagnostic) {
+    Result<TokenList> result = Lexer::tryTokenize("let a: int = 1;\n\"test");
+
+    ASSERT_FALSE(result.ok());
+    ASSERT_EQ(Diagnostic::SYNTAX, result.error().kind);
+    try {
+        Lexer::tokenize("let a: int = 1;\n\"test");
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(std::string(ex.what()), result.error().describe());
+    }
+
+    ASSERT_EQ(5, Lexer::tryTokenize("let a: int;").value().size());
 }
 
 TEST(Lexer, TokenizesFunctionYieldToken) {
-    std::queue<char> q = QueueUtils::queueify("->");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("->");
 
     ASSERT_EQ(1, tokens.size());
-    ASSERT_EQ("->", tokens.front()->source);
+    ASSERT_EQ(Token::ARROW, tokens[0].kind);
 }
 
 TEST(Lexer, TokenizesPunctuation) {
-    std::queue<char> q = QueueUtils::queueify(".!?");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize(".!?");
 
     ASSERT_EQ(3, tokens.size());
 
-    std::shared_ptr<const Token> first = tokens.front();
-    tokens.pop();
-    ASSERT_EQ(".", first->source);
+    const Token& first = tokens[0];
+    ASSERT_EQ(".", tokens.text(first));
 
-    std::shared_ptr<const Token> second = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("!", second->source);
+    const Token& second = tokens[1];
+    ASSERT_EQ("!", tokens.text(second));
 
-    std::shared_ptr<const Token> third = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("?", third->source);
+    const Token& third = tokens[2];
+    ASSERT_EQ("?", tokens.text(third));
 }
 
 TEST(Lexer, IgnoresWhitespace) {
-    std::queue<char> q = QueueUtils::queueify("   \tabc  \n\t  123\n\t");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("   \tabc  \n\t  123\n\t");
 
     ASSERT_EQ(2, tokens.size());
 
-    std::shared_ptr<const Token> first = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("abc", first->source);
+    const Token& first = tokens[0];
+    ASSERT_EQ("abc", tokens.text(first));
 
-    std::shared_ptr<const Token> second = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("123", second->source);
+    const Token& second = tokens[1];
+    ASSERT_EQ("123", tokens.text(second));
 }
 
 TEST(Lexer, TokenizesEscapedCharacterLiterals) {
-    std::queue<char> q = QueueUtils::queueify(R"('\n' '\r' '\t' '\'' '\"' '\\')");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize(R"('\n' '\r' '\t' '\'' '\"' '\\')");
 
     ASSERT_EQ(6, tokens.size());
 
-    std::shared_ptr<const Token> newline = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\n", newline->source);
+    const Token& newline = tokens[0];
+    ASSERT_EQ('\n', tokens.charValue(newline));
 
-    std::shared_ptr<const Token> carriageReturn = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\r", carriageReturn->source);
+    const Token& carriageReturn = tokens[1];
+    ASSERT_EQ('\r', tokens.charValue(carriageReturn));
 
-    std::shared_ptr<const Token> tab = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\t", tab->source);
+    const Token& tab = tokens[2];
+    ASSERT_EQ('\t', tokens.charValue(tab));
 
-    std::shared_ptr<const Token> singleQuote = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\'", singleQuote->source);
+    const Token& singleQuote = tokens[3];
+    ASSERT_EQ('\'', tokens.charValue(singleQuote));
 
-    std::shared_ptr<const Token> doubleQuote = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\"", doubleQuote->source);
+    const Token& doubleQuote = tokens[4];
+    ASSERT_EQ('\"', tokens.charValue(doubleQuote));
 
-    std::shared_ptr<const Token> backslash = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("\\", backslash->source);
+    const Token& backslash = tokens[5];
+    ASSERT_EQ('\\', tokens.charValue(backslash));
 }
 
 TEST(Lexer, TokenizesEscapedCharactersInStringLiterals) {
-    std::queue<char> q = QueueUtils::queueify(R"("\n\r\t\'\"\\")");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize(R"("\n\r\t\'\"\\")");
 
     ASSERT_EQ(1, tokens.size());
 
-    std::shared_ptr<const Token> token = tokens.front();
-    tokens.pop();
+    const Token& token = tokens[0];
 
-    ASSERT_EQ("\n\r\t\'\"\\", token->source);
+    ASSERT_EQ("\n\r\t\'\"\\", tokens.stringValue(token));
 }
 
 TEST(Lexer, TokenizingUnknownEscapeCharacterInCharacterLiteralThrowsException) {
-    std::queue<char> q = QueueUtils::queueify(R"('\z')");
-    ASSERT_THROW(Lexer::tokenize(q), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize(R"('\z')"), SyntaxException);
 }
 
 TEST(Lexer, TokenizingUnknownEscapeCharacterInStringLiteralThrowsException) {
-    std::queue<char> q = QueueUtils::queueify(R"("\z")");
-    ASSERT_THROW(Lexer::tokenize(q), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize(R"("\z")"), SyntaxException);
 }
 
 TEST(Lexer, TokenizingInvalidCharacterLiteralThrowsException) {
-    std::queue<char> qNewline = QueueUtils::queueify("\'\n\'");
-    ASSERT_THROW(Lexer::tokenize(qNewline), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'\n\'"), SyntaxException);
 
-    std::queue<char> qCarriageReturn = QueueUtils::queueify("\'\r\'");
-    ASSERT_THROW(Lexer::tokenize(qCarriageReturn), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'\r\'"), SyntaxException);
 
-    std::queue<char> qTab = QueueUtils::queueify("\'\t\'");
-    ASSERT_THROW(Lexer::tokenize(qTab), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'\t\'"), SyntaxException);
 
-    std::queue<char> qSingleQuote = QueueUtils::queueify("\'\'\'");
-    ASSERT_THROW(Lexer::tokenize(qSingleQuote), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'\'\'"), SyntaxException);
 
-    std::queue<char> qDoubleQuote = QueueUtils::queueify("\'\"\'");
-    ASSERT_THROW(Lexer::tokenize(qDoubleQuote), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\'\"\'"), SyntaxException);
 
     // Backslash is weird because the '\' escapes the trailing single-quote waiting for another single quote.
     // This is actually an unexpected EOF error. This throws an IllegalStateException, which it really shouldn't, but
     // close enough for now.
-    std::queue<char> qBackslash = QueueUtils::queueify("\'\\\'");
-    ASSERT_ANY_THROW(Lexer::tokenize(qBackslash));
+    ASSERT_ANY_THROW(Lexer::tokenize("\'\\\'"));
 }
 
 TEST(Lexer, TokenizingInvalidStringLiteralThrowsException) {
-    std::queue<char> qNewline = QueueUtils::queueify("\"\n\"");
-    ASSERT_THROW(Lexer::tokenize(qNewline), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"\n\""), SyntaxException);
 
-    std::queue<char> qCarriageReturn = QueueUtils::queueify("\"\r\"");
-    ASSERT_THROW(Lexer::tokenize(qCarriageReturn), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"\r\""), SyntaxException);
 
-    std::queue<char> qTab = QueueUtils::queueify("\"\t\"");
-    ASSERT_THROW(Lexer::tokenize(qTab), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"\t\""), SyntaxException);
 
-    std::queue<char> qSingleQuote = QueueUtils::queueify("\"\'\"");
-    ASSERT_THROW(Lexer::tokenize(qSingleQuote), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"\'\""), SyntaxException);
 
     // Note: This is technically an unexpected EOF error.
-    std::queue<char> qBackslash = QueueUtils::queueify("\"\\\"");
-    ASSERT_THROW(Lexer::tokenize(qBackslash), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("\"\\\""), SyntaxException);
 }
 
 TEST(Lexer, DoesNotTokenizeSingleLineComments) {
-    std::queue<char> q = QueueUtils::queueify("foo // bar\nbaz");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("foo // bar\nbaz");
 
     ASSERT_EQ(2, tokens.size());
 
-    const auto foo = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("foo", foo->source);
+    const Token& foo = tokens[0];
+    ASSERT_EQ("foo", tokens.text(foo));
 
-    const auto baz = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("baz", baz->source);
+    const Token& baz = tokens[1];
+    ASSERT_EQ("baz", tokens.text(baz));
 }
 
 TEST(Lexer, DoesNotTokenizeBlockComments) {
-    std::queue<char> q = QueueUtils::queueify("foo /* bar */ baz");
-    std::queue<std::shared_ptr<const Token>> tokens = Lexer::tokenize(q);
+    const TokenList tokens = Lexer::tokenize("foo /* bar */ baz");
 
     ASSERT_EQ(2, tokens.size());
 
-    const auto foo = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("foo", foo->source);
+    const Token& foo = tokens[0];
+    ASSERT_EQ("foo", tokens.text(foo));
 
-    const auto baz = tokens.front();
-    tokens.pop();
-    ASSERT_EQ("baz", baz->source);
+    const Token& baz = tokens[1];
+    ASSERT_EQ("baz", tokens.text(baz));
 }
 
 TEST(Lexer, TokenizingUnendingBlockCommentThrowsException) {
-    std::queue<char> q = QueueUtils::queueify("foo /* bar baz");
-    ASSERT_THROW(Lexer::tokenize(q), SyntaxException);
+    ASSERT_THROW(Lexer::tokenize("foo /* bar baz"), SyntaxException);
+}
+
+TEST(Lexer, TokenizesKeywordsAndPunctuationByKind) {
+    const TokenList tokens = Lexer::tokenize("let extern int string foo ( ) , : ; = + - * / -> .");
+
+    const std::vector<Token::Kind> kinds = {
+        Token::LET, Token::EXTERN, Token::INT, Token::STRING, Token::IDENTIFIER, Token::LEFT_PAREN,
+        Token::RIGHT_PAREN, Token::COMMA, Token::COLON, Token::SEMICOLON, Token::EQUALS, Token::PLUS, Token::MINUS,
+        Token::STAR, Token::SLASH, Token::ARROW, Token::PUNCTUATION,
+    };
+    ASSERT_EQ(kinds.size(), tokens.size());
+    for (size_t i = 0; i < kinds.size(); ++i) ASSERT_EQ(kinds[i], tokens[i].kind);
+}
+
+TEST(Lexer, LocatesTokensOnlyWhenAsked) {
+    const TokenList tokens = Lexer::tokenize("foo\n  \"bar\"");
+
+    ASSERT_EQ(2, tokens.size());
+    ASSERT_EQ(6, tokens[1].offset);
+    ASSERT_EQ(5, tokens[1].length);
+
+    const Location location = tokens.location(tokens[1]);
+    ASSERT_EQ(2, location.line);
+    ASSERT_EQ(3, location.startCol);
+    ASSERT_EQ(8, location.endCol);
+}
+
+// Asserts that tokenizing the source in parallel produces exactly the same Tokens as tokenizing it serially.
+void assertTokenizesInParallelLikeSerially(const std::string& source) {
+    ThreadPool pool(4);
+    const TokenList serial = Lexer::tokenize(source);
+    const TokenList parallel = Lexer::tokenize(source, pool);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        ASSERT_EQ(serial[i].kind, parallel[i].kind);
+        ASSERT_EQ(serial[i].offset, parallel[i].offset);
+        ASSERT_EQ(serial[i].length, parallel[i].length);
+        ASSERT_EQ(serial[i].symbol, parallel[i].symbol);
+    }
+}
+
+// Returns a source of at least the given size, made of many lines of statements.
+std::string repeatStatements(const size_t size) {
+    std::string source;
+    for (int i = 0; source.size() < size; ++i) {
+        source += "let foo" + std::to_string(i) + ": int = " + std::to_string(i) + " * (2 + bar); // Comment\n";
+        source += "putchar(\'\\n\'); puts(\"Hello, World!\");\n";
+    }
+    return source;
+}
+
+TEST(Lexer, TokenizesInParallelLikeSerially) {
+    assertTokenizesInParallelLikeSerially(repeatStatements(16 * Lexer::MIN_CHUNK_SIZE));
+}
+
+TEST(Lexer, TokenizesSmallSourcesInParallelLikeSerially) {
+    assertTokenizesInParallelLikeSerially("");
+    assertTokenizesInParallelLikeSerially("let foo: int = 1;");
+}
+
+TEST(Lexer, TokenizesBlockCommentsAcrossChunksInParallelLikeSerially) {
+    // Each comment spans several chunks, and contains text which cannot be scanned outside of a comment.
+    const std::string comment = "/* \"unterminated\n\'bad char\'\n"
+        + repeatStatements(3 * Lexer::MIN_CHUNK_SIZE) + "*/";
+    const std::string source = repeatStatements(Lexer::MIN_CHUNK_SIZE) + comment + " foo;\n"
+        + repeatStatements(2 * Lexer::MIN_CHUNK_SIZE) + comment + "\n" + repeatStatements(Lexer::MIN_CHUNK_SIZE);
+
+    assertTokenizesInParallelLikeSerially(source);
+}
+
+TEST(Lexer, ThrowsSameSyntaxExceptionInParallelAsSerially) {
+    const std::string source = repeatStatements(4 * Lexer::MIN_CHUNK_SIZE) + "\'ab\';\n"
+        + repeatStatements(4 * Lexer::MIN_CHUNK_SIZE) + "\"unterminated\n";
+    ThreadPool pool(4);
+
+    std::string serialMessage;
+    try {
+        Lexer::tokenize(source);
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        serialMessage = ex.what();
+    }
+
+    try {
+        Lexer::tokenize(source, pool);
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(serialMessage, ex.what());
+    }
+}
+// Asserts that relexing the given edit of the source produces exactly the same Tokens as tokenizing the edited source
+// from scratch, or throws the same SyntaxException.
+void assertRelexesLikeTokenizing(const std::string& source, const uint32_t offset, const uint32_t removed,
+        const std::string& inserted) {
+    const TokenList previous = Lexer::tokenize(source);
+    const std::string edited = source.substr(0, offset) + inserted + source.substr(offset + removed);
+
+    std::string expectedError;
+    try {
+        const TokenList expected = Lexer::tokenize(edited);
+        const Lexer::Relexed relexed = Lexer::relex(previous, edited, Lexer::Edit { offset, removed,
+            (uint32_t) inserted.size() });
+
+        ASSERT_EQ(expected.size(), relexed.tokens.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i].kind, relexed.tokens[i].kind);
+            ASSERT_EQ(expected[i].offset, relexed.tokens[i].offset);
+            ASSERT_EQ(expected[i].length, relexed.tokens[i].length);
+            ASSERT_EQ(expected[i].symbol, relexed.tokens[i].symbol);
+        }
+        ASSERT_EQ(previous.size() - relexed.oldEnd, relexed.tokens.size() - relexed.newEnd);
+        return;
+    } catch (const SyntaxException& ex) {
+        expectedError = ex.what();
+    }
+
+    try {
+        Lexer::relex(previous, edited, Lexer::Edit { offset, removed, (uint32_t) inserted.size() });
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(expectedError, ex.what());
+    }
+}
+
+TEST(Lexer, RelexesEditsLikeTokenizing) {
+    const std::string source = "let foo: int = 12 * bar; // Comment\nputs(\"a b\"); /* c */ x->y;";
+
+    assertRelexesLikeTokenizing(source, 4, 3, "renamed"); // Rename an identifier.
+    assertRelexesLikeTokenizing(source, 7, 0, "d"); // Extend an identifier at its end.
+    assertRelexesLikeTokenizing(source, 3, 1, ""); // Join two Tokens.
+    assertRelexesLikeTokenizing(source, 16, 0, " "); // Split a Token.
+    assertRelexesLikeTokenizing(source, 28, 0, "x"); // Edit a comment.
+    assertRelexesLikeTokenizing(source, 0, 0, "/*"); // Comment out the rest of the source.
+    assertRelexesLikeTokenizing(source, 0, 0, "/* */"); // Insert a whole comment.
+    assertRelexesLikeTokenizing(source, 42, 0, "\""); // Unterminate a string.
+    assertRelexesLikeTokenizing(source, 60, 1, ""); // Turn an arrow into a minus.
+    assertRelexesLikeTokenizing(source, (uint32_t) source.size(), 0, " z;"); // Append to the source.
+    assertRelexesLikeTokenizing(source, 0, (uint32_t) source.size(), ""); // Clear the source.
+}
+
+TEST(Lexer, RelexesEveryCharacterEditLikeTokenizing) {
+    const std::string source = "extern puts: (string) -> int;\nlet a: int = 1 /* x */ + 2;\nputs(\"a\\n\"); // c\n";
+
+    for (uint32_t offset = 0; offset <= source.size(); ++offset) {
+        for (const std::string inserted : { "", " ", "a", "/", "*", "\"", "\n" }) {
+            assertRelexesLikeTokenizing(source, offset, 0, inserted);
+            if (offset < source.size()) assertRelexesLikeTokenizing(source, offset, 1, inserted);
+        }
+    }
+}
+
+TEST(Lexer, ReportsOnlyTheChangedTokensWhenRelexing) {
+    const std::string source = "a b c d e";
+    const TokenList previous = Lexer::tokenize(source);
+
+    const std::string edited = "a b xyz d e";
+    const Lexer::Relexed relexed = Lexer::relex(previous, edited, Lexer::Edit { 4, 1, 3 });
+
+    ASSERT_EQ(2, relexed.first);
+    ASSERT_EQ(3, relexed.oldEnd);
+    ASSERT_EQ(3, relexed.newEnd);
+    ASSERT_EQ("xyz", relexed.tokens.text(relexed.tokens[2]));
+    ASSERT_EQ(8, relexed.tokens[3].offset);
 }
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "scanner.h"
+#include "char_scan.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "compiler/models/diagnostics.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/line_table.h"
+#include "compiler/models/source_text.h"
+#include "compiler/models/symbol.h"
+#include "compiler/models/token.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+namespace {
+    // Classes of input characters which the token grammar distinguishes between.
+    enum CharClass : uint8_t {
+        SPACE,
+        TAB_OR_RETURN,
+        NEWLINE,
+        LETTER, // Includes underscore.
+        DIGIT,
+        SLASH,
+        STAR,
+        MINUS,
+        GREATER_THAN,
+        DOUBLE_QUOTE,
+        SINGLE_QUOTE,
+        BACKSLASH,
+        OTHER,
+        END_OF_FILE,
+        NUM_CHAR_CLASSES,
+    };
+
+    // States of the scanning automaton. Every Token starts and ends in START.
+    enum State : uint8_t {
+        START,
+        IDENTIFIER,
+        INTEGER,
+        SLASH_OR_COMMENT,
+        LINE_COMMENT,
+        BLOCK_COMMENT,
+        BLOCK_COMMENT_STAR,
+        MINUS_OR_ARROW,
+        STRING,
+        STRING_ESCAPE,
+        CHAR,
+        CHAR_ESCAPE,
+        CHAR_CLOSE,
+        NUM_STATES,
+    };
+
+    // What to do with the current character when taking a transition.
+    enum Action : uint8_t {
+        IGNORE, // Advance past a character which is not part of any Token, such as whitespace or comments.
+        ADVANCE, // Advance past a character of the current Token.
+        ESCAPE, // Advance past the control character of an escape sequence, after checking that it is valid.
+        EMIT, // Return the Token without consuming the character, which is scanned again from START.
+        ADVANCE_EMIT, // Advance past the last character of the current Token and return it.
+        FAIL, // Throw a SyntaxException with the transition's error message.
+        FINISH, // The input is exhausted, there are no more Tokens.
+    };
+
+    struct Transition {
+        State next;
+        Action action;
+        Token::Kind kind; // Kind of Token emitted by the transition.
+        const char* error;
+    };
+
+    typedef std::array<std::array<Transition, NUM_CHAR_CLASSES>, NUM_STATES> TransitionTable;
+    typedef std::array<CharClass, 256> CharClassTable;
+    typedef std::array<Token::Kind, 256> PunctuationTable;
+    typedef std::array<CharScan::Kernel, NUM_STATES> RunTable;
+
+    Transition to(const State next, const Action action, const Token::Kind kind = Token::PUNCTUATION) {
+        return Transition{next, action, kind, nullptr};
+    }
+
+    Transition fail(const char* error) {
+        return Transition{START, FAIL, Token::PUNCTUATION, error};
+    }
+
+    CharClassTable classifyCharacters() {
+        CharClassTable classes;
+        classes.fill(OTHER);
+
+        classes[' '] = SPACE;
+        classes['\t'] = classes['\r'] = TAB_OR_RETURN;
+        classes['\n'] = NEWLINE;
+        for (int c = 'a'; c <= 'z'; ++c) classes[c] = LETTER;
+        for (int c = 'A'; c <= 'Z'; ++c) classes[c] = LETTER;
+        classes['_'] = LETTER;
+        for (int c = '0'; c <= '9'; ++c) classes[c] = DIGIT;
+        classes['/'] = SLASH;
+        classes['*'] = STAR;
+        classes['-'] = MINUS;
+        classes['>'] = GREATER_THAN;
+        classes['\"'] = DOUBLE_QUOTE;
+        classes['\''] = SINGLE_QUOTE;
+        classes['\\'] = BACKSLASH;
+
+        return classes;
+    }
+
+    // Kinds of single character punctuation Tokens, by character.
+    PunctuationTable classifyPunctuation() {
+        PunctuationTable kinds;
+        kinds.fill(Token::PUNCTUATION);
+
+        kinds['('] = Token::LEFT_PAREN;
+        kinds[')'] = Token::RIGHT_PAREN;
+        kinds[','] = Token::COMMA;
+        kinds[':'] = Token::COLON;
+        kinds[';'] = Token::SEMICOLON;
+        kinds['='] = Token::EQUALS;
+        kinds['+'] = Token::PLUS;
+        kinds['-'] = Token::MINUS;
+        kinds['*'] = Token::STAR;
+        kinds['/'] = Token::SLASH;
+
+        return kinds;
+    }
+
+    // Compiles the token grammar into a table of transitions for each state and class of the next character.
+    TransitionTable compileGrammar() {
+        TransitionTable table;
+
+        // Between Tokens, ignore whitespace and dispatch on the first character of the next Token. Any character
+        // without a more specific rule is a single character of punctuation.
+        table[START].fill(to(START, ADVANCE_EMIT));
+        table[START][SPACE] = table[START][TAB_OR_RETURN] = table[START][NEWLINE] = to(START, IGNORE);
+        table[START][LETTER] = to(IDENTIFIER, ADVANCE);
+        table[START][DIGIT] = to(INTEGER, ADVANCE);
+        table[START][SLASH] = to(SLASH_OR_COMMENT, ADVANCE);
+        table[START][MINUS] = to(MINUS_OR_ARROW, ADVANCE);
+        table[START][DOUBLE_QUOTE] = to(STRING, ADVANCE);
+        table[START][SINGLE_QUOTE] = to(CHAR, ADVANCE);
+        table[START][END_OF_FILE] = to(START, FINISH);
+
+        // <identifier> ::= [a-zA-Z_][a-zA-Z0-9_]*
+        table[IDENTIFIER].fill(to(START, EMIT, Token::IDENTIFIER));
+        table[IDENTIFIER][LETTER] = table[IDENTIFIER][DIGIT] = to(IDENTIFIER, ADVANCE);
+
+        // <integer-literal> ::= [0-9]+
+        table[INTEGER].fill(to(START, EMIT, Token::INTEGER_LITERAL));
+        table[INTEGER][DIGIT] = to(INTEGER, ADVANCE);
+
+        // A slash is punctuation unless it starts a "//" or "/*" comment.
+        table[SLASH_OR_COMMENT].fill(to(START, EMIT, Token::SLASH));
+        table[SLASH_OR_COMMENT][SLASH] = to(LINE_COMMENT, IGNORE);
+        table[SLASH_OR_COMMENT][STAR] = to(BLOCK_COMMENT, IGNORE);
+
+        // Line comments run until the end of the line or the end of the file.
+        table[LINE_COMMENT].fill(to(LINE_COMMENT, IGNORE));
+        table[LINE_COMMENT][NEWLINE] = to(START, IGNORE);
+        table[LINE_COMMENT][END_OF_FILE] = to(START, FINISH);
+
+        // Block comments run until the next "*/".
+        table[BLOCK_COMMENT].fill(to(BLOCK_COMMENT, IGNORE));
+        table[BLOCK_COMMENT][STAR] = to(BLOCK_COMMENT_STAR, IGNORE);
+        table[BLOCK_COMMENT][END_OF_FILE] = fail("Unexpected EOF in block comment.");
+        table[BLOCK_COMMENT_STAR] = table[BLOCK_COMMENT];
+        table[BLOCK_COMMENT_STAR][SLASH] = to(START, IGNORE);
+
+        // A minus is punctuation unless it starts a "->".
+        table[MINUS_OR_ARROW].fill(to(START, EMIT, Token::MINUS));
+        table[MINUS_OR_ARROW][GREATER_THAN] = to(START, ADVANCE_EMIT, Token::ARROW);
+
+        // <string-literal> ::= " ([^"'\n\t\r\\] | \<control-char>)* "
+        table[STRING].fill(to(STRING, ADVANCE));
+        table[STRING][DOUBLE_QUOTE] = to(START, ADVANCE_EMIT, Token::STRING_LITERAL);
+        table[STRING][BACKSLASH] = to(STRING_ESCAPE, ADVANCE);
+        table[STRING][SINGLE_QUOTE] = fail(R"(Cannot use ' in a string literal, use \' instead.)");
+        table[STRING][NEWLINE] = table[STRING][TAB_OR_RETURN] = fail("Illegal character in string.");
+        table[STRING][END_OF_FILE] = fail("Unexpected EOF");
+        table[STRING_ESCAPE].fill(to(STRING, ESCAPE));
+        table[STRING_ESCAPE][END_OF_FILE] = fail("Unexpected EOF");
+
+        // <char-literal> ::= ' ([^"'\n\t\r\\] | \<control-char>) '
+        table[CHAR].fill(to(CHAR_CLOSE, ADVANCE));
+        table[CHAR][BACKSLASH] = to(CHAR_ESCAPE, ADVANCE);
+        table[CHAR][NEWLINE] = table[CHAR][TAB_OR_RETURN] = table[CHAR][SINGLE_QUOTE] = table[CHAR][DOUBLE_QUOTE] =
+            fail("Invalid character in character literal");
+        table[CHAR][END_OF_FILE] = fail("Unexpected EOF in character literal.");
+        table[CHAR_ESCAPE].fill(to(CHAR_CLOSE, ESCAPE));
+        table[CHAR_ESCAPE][END_OF_FILE] = fail("Unexpected EOF in character literal.");
+        table[CHAR_CLOSE].fill(fail("Expected character literal to end with a closing single quote."));
+        table[CHAR_CLOSE][SINGLE_QUOTE] = to(START, ADVANCE_EMIT, Token::CHAR_LITERAL);
+
+        return table;
+    }
+
+    // Kernels which skip the runs of characters that a state loops over without emitting anything, so long runs of
+    // whitespace, identifiers, strings and comments are scanned many characters at a time.
+    RunTable compileRuns(const CharScan::Kernels& kernels) {
+        RunTable runs;
+        runs.fill(nullptr);
+
+        runs[START] = kernels.whitespace;
+        runs[IDENTIFIER] = kernels.identifier;
+        runs[LINE_COMMENT] = kernels.lineComment;
+        runs[BLOCK_COMMENT] = kernels.blockComment;
+        runs[STRING] = kernels.string;
+
+        return runs;
+    }
+
+    const CharClassTable CHAR_CLASSES = classifyCharacters();
+    const PunctuationTable PUNCTUATION_KINDS = classifyPunctuation();
+    const TransitionTable GRAMMAR = compileGrammar();
+    const RunTable RUNS = compileRuns(CharScan::best());
+
+    // Returns the end of the run of characters starting at current which the given state loops over, up to stop.
+    const char* skipRun(const unsigned state, const char* const current, const char* const stop) {
+        const CharScan::Kernel run = RUNS[state];
+        return run && current < stop ? run(current, stop) : current;
+    }
+
+    // Returns the kind of keyword the given Symbol is, or IDENTIFIER if it is not a keyword.
+    Token::Kind keywordKind(const Symbol symbol) {
+        switch (symbol) {
+            case Symbols::LET: return Token::LET;
+            case Symbols::EXTERN: return Token::EXTERN;
+            case Symbols::INT: return Token::INT;
+            case Symbols::STRING: return Token::STRING;
+            default: return Token::IDENTIFIER;
+        }
+    }
+}
+
+Scanner::Scanner(const std::experimental::string_view source)
+    : source(source), limit(source.data() + source.size()), current(source.data()), tokenStart(source.data()) {
+    if (source.size() > std::numeric_limits<uint32_t>::max()) {
+        throw IllegalStateException("Source is too large to scan: " + std::to_string(source.size()) + " bytes.");
+    }
+}
+
+Scanner::Scanner(const std::experimental::string_view source, const uint32_t start, const uint32_t limit)
+    : source(source), limit(source.data() + limit), current(source.data() + start), tokenStart(source.data() + start) {
+    if (source.size() > std::numeric_limits<uint32_t>::max()) {
+        throw IllegalStateException("Source is too large to scan: " + std::to_string(source.size()) + " bytes.");
+    }
+    if (start > limit || limit > source.size()) {
+        throw IllegalStateException("Cannot scan [" + std::to_string(start) + ", " + std::to_string(limit)
+            + ") of a source of " + std::to_string(source.size()) + " bytes.");
+    }
+}
+
+Token Scanner::emit(Token::Kind kind) {
+    Symbol symbol = Symbols::NONE;
+    if (kind == Token::IDENTIFIER) {
+        symbol = Symbols::intern(std::experimental::string_view(this->tokenStart, this->current - this->tokenStart));
+        kind = keywordKind(symbol);
+    } else if (kind == Token::PUNCTUATION) {
+        kind = PUNCTUATION_KINDS[(unsigned char) *this->tokenStart];
+    }
+
+    const Token token{
+        kind,
+        (uint32_t) (this->tokenStart - this->source.data()),
+        (uint32_t) (this->current - this->tokenStart),
+        symbol,
+    };
+    this->tokenStart = this->current;
+
+    return token;
+}
+
+std::experimental::optional<Token> Scanner::next() {
+    State state = START;
+    while (true) {
+        const CharClass charClass = this->current >= this->stop(state)
+            ? END_OF_FILE : CHAR_CLASSES[(unsigned char) *this->current];
+        const Transition& transition = GRAMMAR[state][charClass];
+
+        switch (transition.action) {
+            case IGNORE:
+                this->current = skipRun(transition.next, this->current + 1, this->stop(transition.next));
+                this->tokenStart = this->current;
+                break;
+            case ADVANCE:
+                this->current = skipRun(transition.next, this->current + 1, this->stop(transition.next));
+                break;
+            case ESCAPE:
+                if (!SourceText::unescape(*this->current)) {
+                    return this->fail("Unexpected escape character: \\" + std::string(1, *this->current));
+                }
+                this->current++;
+                break;
+            case ADVANCE_EMIT:
+                this->current++;
+                // Fall through
+            case EMIT:
+                return this->emit(transition.kind);
+            case FAIL:
+                return this->fail(transition.error);
+            case FINISH:
+                return std::experimental::nullopt;
+        }
+
+        state = transition.next;
+    }
+}
+
+// Between Tokens, the limit is treated as the end of the source. Within one, only the real end is.
+const char* Scanner::stop(const unsigned state) const {
+    return state == START ? this->limit : this->source.data() + this->source.size();
+}
+
+uint32_t Scanner::offset() const {
+    return (uint32_t) (this->current - this->source.data());
+}
+
+void Scanner::report(Diagnostics& diagnostics) {
+    this->diagnostics = &diagnostics;
+}
+
+bool Scanner::failed() const {
+    return this->failure;
+}
+
+void Scanner::throwException(const std::string& message) const {
+    this->diagnose(message).raise();
+}
+
+// Returns the syntax error of the given message at the Token currently being scanned.
+Diagnostic Scanner::diagnose(const std::string& message) const {
+    // Errors are rare, so only find the lines of the source once one occurs.
+    const LineTable lines(this->source);
+    const auto tokenOffset = (uint32_t) (this->tokenStart - this->source.data());
+    const auto currentOffset = (uint32_t) (this->current - this->source.data());
+
+    return Diagnostic(Diagnostic::SYNTAX, message, lines.line(currentOffset), lines.column(tokenOffset),
+        lines.column(currentOffset));
+}
+
+// Throws the syntax error of the given message, or reports it and skips to the end of the source, so every later call
+// to next() finds nothing left to scan.
+std::experimental::optional<Token> Scanner::fail(const std::string& message) {
+    if (!this->diagnostics) this->throwException(message);
+
+    this->diagnostics->report(this->diagnose(message));
+    this->failure = true;
+    this->current = this->tokenStart = this->source.data() + this->source.size();
+    return std::experimental::nullopt;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef SANITY_SCANNER_H
+#define SANITY_SCANNER_H
+
+#include <cstdint>
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "../models/diagnostics.h"
+#include "../models/token.h"
+
+/**
+ * Table-driven scanner for the Sanity token grammar. The grammar is compiled once into a state-transition table indexed
+ * by the current state and the class of the next character, so the input is scanned in a single pass with one table
+ * lookup per character.
+ *
+ * Tokens only record their offset in the scanned text, so the only per-character work is the table lookup. Lines and
+ * columns are not tracked at all, they are computed from the offsets with a LineTable when they are needed. Runs of
+ * characters which a state simply loops over, like whitespace or the rest of an identifier, skip the table entirely and
+ * are scanned with vectorized CharScan kernels.
+ */
+class Scanner {
+private:
+    const std::experimental::string_view source;
+    const char* const limit;
+    const char* current;
+    const char* tokenStart;
+    Diagnostics* diagnostics = nullptr;
+    bool failure = false;
+
+    Token emit(Token::Kind kind);
+    const char* stop(unsigned state) const;
+    Diagnostic diagnose(const std::string& message) const;
+    std::experimental::optional<Token> fail(const std::string& message);
+
+public:
+    /**
+     * Scan the given source text in place. The viewed characters must outlive the Scanner.
+     * @throws IllegalStateException if the source is too large for its offsets to fit in a Token.
+     */
+    explicit Scanner(std::experimental::string_view source);
+
+    /**
+     * Scan only the Tokens of the given source which start in the range [start, limit). Scanning starts at the start
+     * offset as if it were the beginning of a Token, and a Token or comment which crosses the limit is scanned to its
+     * end, so the Scanner may stop beyond the limit. Offsets of Tokens are still relative to the whole source.
+     * @throws IllegalStateException if the source is too large for its offsets to fit in a Token, or the range is not
+     *     within it.
+     */
+    Scanner(std::experimental::string_view source, uint32_t start, uint32_t limit);
+
+    /**
+     * Reports syntax errors to the given Diagnostics rather than throwing them. Scanning cannot resynchronize after an
+     * error, so the Scanner then stops as if it had reached the end of the source. The Diagnostics must outlive the
+     * Scanner.
+     */
+    void report(Diagnostics& diagnostics);
+
+    /**
+     * Scans and returns the next Token of the source, or std::experimental::nullopt once the end of the source has been
+     * reached.
+     * @throws SyntaxException unless errors are reported to Diagnostics.
+     */
+    std::experimental::optional<Token> next();
+
+    /**
+     * Returns whether scanning stopped at a syntax error reported to Diagnostics.
+     */
+    bool failed() const;
+
+    /**
+     * Returns the offset in the source that scanning has reached.
+     */
+    uint32_t offset() const;
+
+    /**
+     * Throw an exception with the given message. Automatically attaches the line and col numbers of the Token currently
+     * being scanned to it.
+     * @throws SyntaxException
+     */
+    void throwException(const std::string& message) const;
+};
+
+#endif //SANITY_SCANNER_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <experimental/string_view>
+#include "scanner.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/symbol.h"
+#include "compiler/models/token.h"
+
+typedef Exceptions::SyntaxException SyntaxException;
+
+std::vector<Token> scanAll(const std::experimental::string_view source) {
+    std::vector<Token> tokens;
+    Scanner scanner(source);
+    std::experimental::optional<Token> token;
+    while ((token = scanner.next())) tokens.push_back(token.value());
+    return tokens;
+}
+
+TEST(Scanner, ReturnsNulloptForEmptySource) {
+    const std::string source;
+    Scanner scanner(source);
+
+    ASSERT_FALSE(scanner.next());
+}
+
+TEST(Scanner, RecordsOffsetsAndLengths) {
+    const auto tokens = scanAll("foo bar\n  baz;");
+
+    ASSERT_EQ(4, tokens.size());
+
+    ASSERT_EQ(0, tokens[0].offset);
+    ASSERT_EQ(3, tokens[0].length);
+
+    ASSERT_EQ(4, tokens[1].offset);
+    ASSERT_EQ(3, tokens[1].length);
+
+    ASSERT_EQ(10, tokens[2].offset);
+    ASSERT_EQ(3, tokens[2].length);
+
+    ASSERT_EQ(13, tokens[3].offset);
+    ASSERT_EQ(1, tokens[3].length);
+}
+
+TEST(Scanner, IncludesQuotesInLiterals) {
+    const auto tokens = scanAll(R"(x "a\nb" 'c')");
+
+    ASSERT_EQ(3, tokens.size());
+
+    ASSERT_EQ(Token::STRING_LITERAL, tokens[1].kind);
+    ASSERT_EQ(2, tokens[1].offset);
+    ASSERT_EQ(6, tokens[1].length);
+
+    ASSERT_EQ(Token::CHAR_LITERAL, tokens[2].kind);
+    ASSERT_EQ(9, tokens[2].offset);
+    ASSERT_EQ(3, tokens[2].length);
+}
+
+TEST(Scanner, SkipsComments) {
+    const auto tokens = scanAll("/* a\n b */ foo // bar\nbaz");
+
+    ASSERT_EQ(2, tokens.size());
+    ASSERT_EQ(11, tokens[0].offset);
+    ASSERT_EQ(22, tokens[1].offset);
+}
+
+TEST(Scanner, TokenizesSlashAndMinusAsPunctuation) {
+    const auto tokens = scanAll("a/b-c->d-");
+
+    ASSERT_EQ(8, tokens.size());
+    ASSERT_EQ(Token::SLASH, tokens[1].kind);
+    ASSERT_EQ(Token::MINUS, tokens[3].kind);
+    ASSERT_EQ(Token::ARROW, tokens[5].kind);
+    ASSERT_EQ(2, tokens[5].length);
+    ASSERT_EQ(Token::MINUS, tokens[7].kind);
+}
+
+TEST(Scanner, TokenizesBlockCommentsEndingInStars) {
+    const auto tokens = scanAll("a /** b **/ c");
+
+    ASSERT_EQ(2, tokens.size());
+    ASSERT_EQ(0, tokens[0].offset);
+    ASSERT_EQ(12, tokens[1].offset);
+}
+
+TEST(Scanner, InternsIdentifiersAndKeywords) {
+    const auto tokens = scanAll("let foo = foo;");
+
+    ASSERT_EQ(Token::LET, tokens[0].kind);
+    ASSERT_EQ(Symbols::LET, tokens[0].symbol);
+    ASSERT_EQ(Token::IDENTIFIER, tokens[1].kind);
+    ASSERT_EQ(Symbols::intern("foo"), tokens[1].symbol);
+    ASSERT_EQ(tokens[1].symbol, tokens[3].symbol);
+    ASSERT_EQ(Symbols::NONE, tokens[2].symbol);
+}
+
+TEST(Scanner, ThrowsSyntaxExceptionOnUnterminatedCharLiteral) {
+    ASSERT_THROW(scanAll("\'"), SyntaxException);
+    ASSERT_THROW(scanAll("\'a"), SyntaxException);
+    ASSERT_THROW(scanAll("\'\\"), SyntaxException);
+}
+
+TEST(Scanner, ReportsPositionOfSyntaxErrors) {
+    try {
+        scanAll("foo\n  \"ab\'\"");
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(std::string("Syntax exception (line 2, col 3 -> 6): Cannot use ' in a string literal, use \\' "
+            "instead."), ex.what());
+    }
+}
+
+TEST(Scanner, ReportsPositionOfUnknownEscapeCharacters) {
+    try {
+        scanAll("a\n\n b \"x\\z\"");
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(std::string("Syntax exception (line 3, col 4 -> 7): Unexpected escape character: \\z"), ex.what());
+    }
+}
\ No newline at end of file
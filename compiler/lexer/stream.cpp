@@ -1,13 +1,12 @@
 #include "stream.h"
 #include <deque>
 #include <queue>
-#include <memory>
 #include <regex>
 #include <functional>
+#include <string>
 #include <experimental/optional>
-#include "compiler/models/token.h"
 #include "compiler/models/exceptions.h"
-#include "compiler/models/token_builder.h"
+#include "compiler/models/line_table.h"
 
 typedef Exceptions::IllegalStateException IllegalStateException;
 typedef Exceptions::SyntaxException SyntaxException;
@@ -51,21 +50,11 @@ void Stream::advanceChars(const int numChars, const bool updateStartColumn) {
         char c = this->chars.front();
         this->chars.pop_front();
 
-        // Update line numbers
-        if (c == '\n') {
-            this->line++;
-            this->currentCol = 1;
-
-            // If no characters have been parsed, then we haven't started yet, update start positions.
-            if (updateStartColumn && this->buffer.empty()) {
-                this->startCol = 1;
-            }
-        } else {
-            this->currentCol++;
-
-            // If no characters have been parsed, then we haven't started yet, update start positions.
-            if (updateStartColumn && this->buffer.empty()) this->startCol++;
-        }
+        this->currentOffset++;
+        if (c == '\n') this->lineStarts.push_back(this->currentOffset);
+
+        // If no characters have been parsed, then we haven't started yet, update start positions.
+        if (updateStartColumn && this->buffer.empty()) this->startOffset = this->currentOffset;
     }
 }
 
@@ -169,29 +158,21 @@ Stream* Stream::repeatUntil(const std::regex& matcher, const int limit, const st
     }, limit, callback, eofError);
 }
 
-void Stream::returnToken(const std::function<TokenBuilder (const std::string& source)>& tokenProducer) {
-    this->result = tokenProducer(dequeToString(this->buffer))
-        .setLine(this->line)
-        .setStartCol(this->startCol)
-        .setEndCol(this->currentCol)
-    .build();
+void Stream::returnToken() {
+    this->result = dequeToString(this->buffer);
     this->buffer = std::deque<char>();
 
-    this->startCol = this->currentCol;
-}
-
-void Stream::returnToken() {
-    this->returnToken([](const std::string& source) {
-        return TokenBuilder(source);
-    });
+    this->startOffset = this->currentOffset;
 }
 
 void Stream::throwException(const std::string& message) const {
-    throw SyntaxException(message, this->line, this->startCol, this->currentCol);
+    const LineTable lines(this->lineStarts);
+    throw SyntaxException(message, lines.line(this->currentOffset), lines.column(this->startOffset),
+        lines.column(this->currentOffset));
 }
 
-std::experimental::optional<std::shared_ptr<const Token>> Stream::extractResult() {
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->result;
+std::experimental::optional<std::string> Stream::extractResult() {
+    std::experimental::optional<std::string> token = this->result;
 
     // If no token to return and there is still data to process, then something has gone wrong.
     if (!token && (!this->buffer.empty() || !this->chars.empty())) {
@@ -1,23 +1,26 @@
 #ifndef SANITY_STREAM_H
 #define SANITY_STREAM_H
 
+#include <cstdint>
 #include <deque>
 #include <queue>
-#include <memory>
 #include <regex>
 #include <functional>
+#include <string>
+#include <vector>
 #include <experimental/optional>
-#include "../models/token.h"
-#include "../models/token_builder.h"
 
 class Stream {
 private:
     std::deque<char> chars;
     std::deque<char> buffer;
-    std::experimental::optional<std::shared_ptr<const Token>> result;
-    int line = 1;
-    int startCol = 1;
-    int currentCol = 1;
+    std::experimental::optional<std::string> result;
+
+    // Positions are only tracked as offsets, and converted to lines and columns with a LineTable when an exception is
+    // thrown.
+    uint32_t startOffset = 0;
+    uint32_t currentOffset = 0;
+    std::vector<uint32_t> lineStarts = { 0 };
 
     void advanceChars(int numChars = 1, bool updateStartColumn = false);
 
@@ -31,7 +34,7 @@ public:
 
     /**
      * Ignores the next amount of characters in the stream. If updateStartColumn is true, then the Stream will assume
-     * that the values ignored are not associated with any Token, and the line numbers will be updated to skip over
+     * that the values ignored are not associated with any Token, and the start position will be updated to skip over
      * these characters.
      */
     Stream* ignore(int numChars = 1, bool updateStartColumn = false);
@@ -101,15 +104,8 @@ public:
             const std::experimental::optional<const std::string>& eofError = std::experimental::nullopt);
 
     /**
-     * Saves the current state of the buffer and will return a Token as provided by the producer of this state when
-     * extractResult() is called. All other functionality is blocked until the Token is extracted.
-     * @see #extractResult()
-     */
-    void returnToken(const std::function<TokenBuilder (const std::string& source)>& tokenProducer);
-
-    /**
-     * Saves the current state of the buffer and will return a standard Token with no special options of this state when
-     * extractResult() is called. All other functionality is blocked until the Token is extracted.
+     * Saves the current state of the buffer and will return the consumed text when extractResult() is called. All
+     * other functionality is blocked until the result is extracted.
      * @see #extractResult()
      */
     void returnToken();
@@ -121,11 +117,11 @@ public:
     void throwException(const std::string& message) const;
 
     /**
-     * Takes the token previously saved by returnToken() and returns it while resetting the current state of the stream
+     * Takes the text previously saved by returnToken() and returns it while resetting the current state of the stream
      * to continue processing the input. Returns std::experimental::nullopt if the input has reached EOF.
      * @see #returnToken()
      */
-    std::experimental::optional<std::shared_ptr<const Token>> extractResult();
+    std::experimental::optional<std::string> extractResult();
 
 private:
     /**
@@ -0,0 +1,135 @@
+#include <gflags/gflags.h>
+#include <chrono>
+#include <cstdio>
+#include <queue>
+#include <regex>
+#include <string>
+#include <vector>
+#include <experimental/optional>
+#include "inline_stream.h"
+#include "stream.h"
+#include "compiler/utils/queue_utils.h"
+
+DEFINE_int32(size_kb, 256, "Size of the generated source to tokenize, in kilobytes.");
+DEFINE_int32(runs, 3, "Number of times to tokenize the source with each stream, keeping the fastest.");
+
+// Generates a source of at least the given size which resembles machine-generated Sanity code.
+std::string generateSource(const size_t size) {
+    std::string source;
+    source.reserve(size + 256);
+    for (int i = 0; source.size() < size; ++i) {
+        source += "let value" + std::to_string(i) + ": int = " + std::to_string(i) + " * (value + 42) - other / 7;\n";
+        if (i % 8 == 0) source += "puts(\"Hello, \\\"World\\\"!\"); // Trailing comment\n";
+    }
+    return source;
+}
+
+// Tokenizes the source with the regex and std::function based Stream.
+std::vector<std::string> tokenizeStream(const std::string& source) {
+    static const std::regex whitespace("^[ \\t\\r\\n]");
+    static const std::regex comment("^//");
+    static const std::regex newline("^\\n");
+    static const std::regex identifierStart("^[a-zA-Z_]");
+    static const std::regex identifierChar("^[a-zA-Z0-9_]");
+    static const std::regex digit("^[0-9]");
+    static const std::regex quote("^\"");
+    static const std::regex backslash("^\\\\");
+    static const std::regex any("^[^]");
+
+    std::queue<char> chars = QueueUtils::queueify(source);
+    Stream stream(chars);
+
+    std::vector<std::string> tokens;
+    std::experimental::optional<std::string> token;
+    while ((token = stream.ignoreWhile(whitespace, 1, true /* updateStartColumn */)
+            ->match(comment, 2, [](Stream* stream) {
+                stream->ignoreUntil(newline, 1, true /* updateStartColumn */)->returnToken();
+            })->match(identifierStart, 1, [](Stream* stream) {
+                stream->consumeWhile(identifierChar, 1)->returnToken();
+            })->match(digit, 1, [](Stream* stream) {
+                stream->consumeWhile(digit, 1)->returnToken();
+            })->match(quote, 1, [](Stream* stream) {
+                stream->ignore()->repeatUntil(quote, 1, [](Stream* stream) {
+                    stream->match(backslash, 1, [](Stream* stream) {
+                        stream->ignore()->consume();
+                    }, [](Stream* stream) {
+                        stream->consume();
+                    });
+                }, std::string("Unterminated string."))->ignore()->returnToken();
+            })->match(any, 1, [](Stream* stream) {
+                stream->consume()->returnToken();
+            })->extractResult())) {
+        if (!token.value().empty()) tokens.push_back(token.value());
+    }
+    return tokens;
+}
+
+// Tokenizes the source with the same rules written for InlineStream.
+std::vector<std::string> tokenizeInlineStream(const std::string& source) {
+    InlineStream stream(source);
+
+    std::vector<std::string> tokens;
+    std::experimental::optional<std::string> token;
+    while ((token = stream.ignoreWhile(Matchers::Whitespace(), true /* updateStartColumn */)
+            ->match(Matchers::Text<'/', '/'>(), [](InlineStream* stream) {
+                stream->ignoreUntil(Matchers::Is<'\n'>(), true /* updateStartColumn */)->returnToken();
+            })->match(Matchers::IdentifierStart(), [](InlineStream* stream) {
+                stream->consumeWhile(Matchers::IdentifierChar())->returnToken();
+            })->match(Matchers::Digit(), [](InlineStream* stream) {
+                stream->consumeWhile(Matchers::Digit())->returnToken();
+            })->match(Matchers::Is<'\"'>(), [](InlineStream* stream) {
+                stream->ignore()->repeatUntil(Matchers::Is<'\"'>(), [](InlineStream* stream) {
+                    stream->match(Matchers::Is<'\\'>(), [](InlineStream* stream) {
+                        stream->ignore()->consume();
+                    }, [](InlineStream* stream) {
+                        stream->consume();
+                    });
+                }, std::string("Unterminated string."))->ignore()->returnToken();
+            })->match(Matchers::Any(), [](InlineStream* stream) {
+                stream->consume()->returnToken();
+            })->extractResult())) {
+        if (!token.value().empty()) tokens.push_back(token.value());
+    }
+    return tokens;
+}
+
+// Returns the fastest time, in seconds, taken by the given tokenization over the given number of runs, along with the
+// tokens it produced.
+template <typename Tokenize>
+double fastest(const int runs, Tokenize tokenize, std::vector<std::string>& tokens) {
+    double best = 0;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        tokens = tokenize();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+// Measures the same token rules written with Stream and with InlineStream.
+int main(int argc, char* argv[]) {
+    gflags::SetUsageMessage("Benchmarks tokenizing a generated source with Stream and InlineStream.");
+    gflags::ParseCommandLineFlags(&argc, &argv, true /* remove flags from argv */);
+
+    const std::string source = generateSource((size_t) FLAGS_size_kb * 1024);
+    const double megabytes = source.size() / (1024.0 * 1024.0);
+
+    std::vector<std::string> streamTokens;
+    std::vector<std::string> inlineTokens;
+    const double stream = fastest(FLAGS_runs, [&source]() { return tokenizeStream(source); }, streamTokens);
+    const double inlined = fastest(FLAGS_runs, [&source]() { return tokenizeInlineStream(source); }, inlineTokens);
+
+    if (streamTokens != inlineTokens) {
+        std::fprintf(stderr, "Stream and InlineStream produced different tokens.\n");
+        return 1;
+    }
+
+    std::printf("%-14s %10s %10s %10s %8s\n", "stream", "tokens", "seconds", "MB/s", "speedup");
+    std::printf("%-14s %10zu %10.4f %10.2f %8.2f\n", "Stream", streamTokens.size(), stream, megabytes / stream, 1.0);
+    std::printf("%-14s %10zu %10.4f %10.2f %8.2f\n", "InlineStream", inlineTokens.size(), inlined,
+        megabytes / inlined, stream / inlined);
+
+    return 0;
+}
\ No newline at end of file
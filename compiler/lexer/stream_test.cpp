@@ -25,14 +25,14 @@ TEST_F(StreamTestFixture, FrontReturnsFirstCharacter) {
 
 TEST_F(StreamTestFixture, IgnoresCharacters) {
     this->stream->ignore(3)->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("", token.value()->source);
+    ASSERT_EQ("", token.value());
 }
 
 TEST_F(StreamTestFixture, IgnoresWhileCharacterMatchesRegex) {
     this->stream->ignoreWhile(std::regex("^[a-z]"), 1)->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
     ASSERT_EQ('1', stream->front());
 }
@@ -86,24 +86,24 @@ TEST_F(StreamTestFixture, IgnoreUntilThrowsExceptionOnEofWhenCalledWithMessage)
 
 TEST_F(StreamTestFixture, ConsumesCharacters) {
     this->stream->consume(3)->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("abc", token.value()->source);
+    ASSERT_EQ("abc", token.value());
 }
 
 TEST_F(StreamTestFixture, ConsumesTheGivenCharacterWithoutAdvancing) {
     this->stream->consume('z')->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("z", token.value()->source);
+    ASSERT_EQ("z", token.value());
     ASSERT_EQ('a', stream->front());
 }
 
 TEST_F(StreamTestFixture, ConsumesWhileCharacterMatchesRegex) {
     this->stream->consumeWhile(std::regex("^[a-z]"), 1)->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("abc", token.value()->source);
+    ASSERT_EQ("abc", token.value());
 }
 
 TEST_F(StreamTestFixture, ConsumeWhileStopsOnNonMatchingRegex) {
@@ -160,9 +160,9 @@ TEST_F(StreamTestFixture, RepeatWhileInvokesCallbackWhileRegexMatches) {
     this->stream->repeatWhile(std::regex("^[a-z]"), 1, [](Stream* stream) {
         stream->consume();
     })->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("abc", token.value()->source);
+    ASSERT_EQ("abc", token.value());
 }
 
 TEST_F(StreamTestFixture, RepeatWhileDoesNotInvokeCallbackIfNoMatch) {
@@ -189,9 +189,9 @@ TEST_F(StreamTestFixture, RepeatUntilInvokesCallbackUntilRegexMatches) {
     this->stream->repeatUntil(std::regex("^[0-9]"), 1, [](Stream* stream) {
         stream->consume();
     })->returnToken();
-    std::experimental::optional<std::shared_ptr<const Token>> token = this->stream->extractResult();
+    std::experimental::optional<std::string> token = this->stream->extractResult();
 
-    ASSERT_EQ("abc", token.value()->source);
+    ASSERT_EQ("abc", token.value());
 }
 
 TEST_F(StreamTestFixture, RepeatUntilDoesNotInvokeCallbackIfMatch) {
@@ -215,8 +215,8 @@ TEST_F(StreamTestFixture, RepeatUntilThrowsExceptionOnEofWhenStreamEnds) {
 }
 
 TEST_F(StreamTestFixture, CallsAfterReturnTokenAreIgnoredUntilNextRun) {
-    std::queue<std::shared_ptr<const Token>> tokens;
-    std::experimental::optional<std::shared_ptr<const Token>> token;
+    std::queue<std::string> tokens;
+    std::experimental::optional<std::string> token;
     do {
         token = this->stream->match(std::regex("^[a-z]"), 1, [](Stream* stream) {
             stream->consumeWhile(std::regex("^[a-z]"), 1)->returnToken();
@@ -228,11 +228,22 @@ TEST_F(StreamTestFixture, CallsAfterReturnTokenAreIgnoredUntilNextRun) {
 
     ASSERT_EQ(2, tokens.size());
 
-    std::shared_ptr<const Token> first = tokens.front();
-    ASSERT_EQ("abc", first->source);
+    ASSERT_EQ("abc", tokens.front());
     tokens.pop();
 
-    std::shared_ptr<const Token> second = tokens.front();
-    ASSERT_EQ("123", second->source);
+    ASSERT_EQ("123", tokens.front());
     tokens.pop();
+}
+
+TEST(Stream, ReportsPositionOfExceptions) {
+    std::queue<char> q = QueueUtils::queueify("ab\ncd");
+    Stream stream(q);
+
+    stream.ignore(4, true /* updateStartColumn */)->consume();
+    try {
+        stream.throwException("Test");
+        FAIL();
+    } catch (const SyntaxException& ex) {
+        ASSERT_EQ(std::string("Syntax exception (line 2, col 2 -> 3): Test"), ex.what());
+    }
 }
\ No newline at end of file
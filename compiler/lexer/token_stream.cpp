@@ -0,0 +1,115 @@
+#include "token_stream.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "scanner.h"
+#include "compiler/models/diagnostics.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/source_text.h"
+#include "compiler/models/token.h"
+#include "compiler/models/token_list.h"
+#include "compiler/utils/spsc_queue.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+TokenStream::TokenStream(const std::experimental::string_view source) : SourceText(source), scanner(Scanner(source)) { }
+
+TokenStream::TokenStream(const std::experimental::string_view source, Diagnostics& diagnostics)
+    : TokenStream(source) {
+    this->scanner->report(diagnostics);
+}
+
+TokenStream::TokenStream(const TokenList& tokens) : TokenStream(tokens, 0) { }
+
+TokenStream::TokenStream(const TokenList& tokens, const size_t first)
+    : SourceText(tokens), span(tokens.data()), spanSize(tokens.size()), cursor(std::min(first, tokens.size())),
+      first(this->cursor) { }
+
+TokenStream::TokenStream(const std::experimental::string_view source, SpscQueue<std::vector<Token>>& chunks)
+    : SourceText(source), chunks(&chunks) { }
+
+// Pulls Tokens into the lookahead buffer until it holds at least the given number of them, returning false if the
+// source runs out first.
+bool TokenStream::fill(const size_t count) {
+    while (this->lookaheadSize < count) {
+        std::experimental::optional<Token> token;
+        if (this->scanner) {
+            token = this->scanner->next();
+        } else {
+            // Move on to the next chunk once the current one is used up, until the queue is closed.
+            while (this->cursor == this->spanSize && this->chunks) {
+                std::experimental::optional<std::vector<Token>> next = this->chunks->pop();
+                if (!next) {
+                    this->chunks = nullptr;
+                    break;
+                }
+
+                this->chunk = std::move(next.value());
+                this->span = this->chunk.data();
+                this->spanSize = this->chunk.size();
+                this->cursor = 0;
+            }
+
+            if (this->cursor != this->spanSize) token = this->span[this->cursor++];
+        }
+        if (!token) return false;
+
+        this->lookahead[(this->lookaheadStart + this->lookaheadSize) % MAX_LOOKAHEAD] = token.value();
+        this->lookaheadSize++;
+    }
+
+    return true;
+}
+
+// Peeks at a Token which is not simply the one the given distance after the cursor, because the lookahead buffer holds
+// Tokens or the replayed ones run out before it.
+std::experimental::optional<Token> TokenStream::peekSlow(const size_t ahead) {
+    if (ahead >= this->lookaheadSize && ahead - this->lookaheadSize < this->spanSize - this->cursor) {
+        return this->span[this->cursor + ahead - this->lookaheadSize];
+    }
+
+    if (ahead >= MAX_LOOKAHEAD) {
+        // Once there is nothing left to lex or take from the queue, anything past the replayed Tokens is the end.
+        if (!this->scanner && !this->chunks) return std::experimental::nullopt;
+
+        throw IllegalStateException("Cannot peek " + std::to_string(ahead) + " Tokens ahead, the maximum is "
+            + std::to_string(MAX_LOOKAHEAD - 1) + ".");
+    }
+
+    if (!this->fill(ahead + 1)) return std::experimental::nullopt;
+
+    return this->lookahead[(this->lookaheadStart + ahead) % MAX_LOOKAHEAD];
+}
+
+// Consumes the next Token from the lookahead buffer, or whichever source comes next once it is empty.
+std::experimental::optional<Token> TokenStream::nextSlow() {
+    if (!this->fill(1)) return std::experimental::nullopt;
+
+    const Token token = this->lookahead[this->lookaheadStart];
+    this->lookaheadStart = (this->lookaheadStart + 1) % MAX_LOOKAHEAD;
+    this->lookaheadSize--;
+    this->consumedCount++;
+
+    return token;
+}
+
+bool TokenStream::failed() const {
+    return this->scanner && this->scanner->failed();
+}
+
+void TokenStream::rewind(const size_t consumed) {
+    if (this->first == SIZE_MAX) {
+        throw IllegalStateException("Only a TokenStream replaying a TokenList can be rewound.");
+    }
+    if (consumed > this->consumedCount) {
+        throw IllegalStateException("Cannot rewind to " + std::to_string(consumed) + " Tokens consumed, only "
+            + std::to_string(this->consumedCount) + " have been.");
+    }
+
+    this->cursor = this->first + consumed;
+    this->lookaheadSize = 0;
+    this->consumedCount = consumed;
+}
\ No newline at end of file
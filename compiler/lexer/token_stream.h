@@ -0,0 +1,143 @@
+#ifndef SANITY_TOKEN_STREAM_H
+#define SANITY_TOKEN_STREAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "scanner.h"
+#include "../models/diagnostics.h"
+#include "../models/source_text.h"
+#include "../models/token.h"
+#include "../models/token_list.h"
+#include "../utils/spsc_queue.h"
+
+/**
+ * Cursor over the Tokens of a source which lexes them on demand. Only the Tokens which have been peeked at but not yet
+ * consumed are held in memory, so a parser pulling from a TokenStream can start as soon as the first Token is scanned
+ * and never needs more than a few Tokens of memory, regardless of the size of the source.
+ *
+ * A TokenStream can also replay an already lexed TokenList, or take chunks of Tokens from a queue filled by a lexer on
+ * another thread, so the same parser works over all of them. Replayed Tokens are read in place with an index rather
+ * than copied through the lookahead buffer, so they can be peeked at any distance ahead, and a TokenStream replaying a
+ * TokenList can be rewound to parse the same Tokens again.
+ */
+class TokenStream : public SourceText {
+public:
+    // Maximum number of Tokens which can be peeked at ahead of the next one.
+    static const size_t MAX_LOOKAHEAD = 4;
+
+private:
+    std::experimental::optional<Scanner> scanner;
+    SpscQueue<std::vector<Token>>* chunks = nullptr;
+    std::vector<Token> chunk;
+
+    // Tokens of the TokenList or chunk being replayed, of which those from the cursor onwards are yet to be consumed.
+    const Token* span = nullptr;
+    size_t spanSize = 0;
+    size_t cursor = 0;
+
+    // Index of the first Token replayed from a TokenList, or SIZE_MAX if the Tokens do not come from one.
+    size_t first = SIZE_MAX;
+
+    // Ring buffer of the Tokens which have been peeked at but not yet consumed.
+    std::array<Token, MAX_LOOKAHEAD> lookahead;
+    size_t lookaheadStart = 0;
+    size_t lookaheadSize = 0;
+
+    size_t consumedCount = 0;
+
+    bool fill(size_t count);
+    std::experimental::optional<Token> peekSlow(size_t ahead);
+    std::experimental::optional<Token> nextSlow();
+
+public:
+    /**
+     * Lex the given source text on demand. The viewed characters must outlive the TokenStream.
+     * @throws IllegalStateException if the source is too large to scan.
+     */
+    explicit TokenStream(std::experimental::string_view source);
+
+    /**
+     * Lex the given source text on demand, reporting a syntax error to the given Diagnostics rather than throwing it.
+     * The stream then ends at the error. The viewed characters and the Diagnostics must outlive the TokenStream.
+     * @throws IllegalStateException if the source is too large to scan.
+     */
+    TokenStream(std::experimental::string_view source, Diagnostics& diagnostics);
+
+    /**
+     * Replay the Tokens of the given TokenList, which must outlive the TokenStream.
+     */
+    explicit TokenStream(const TokenList& tokens);
+
+    /**
+     * Replay the Tokens of the given TokenList starting from the one at the given index. The TokenList must outlive the
+     * TokenStream.
+     */
+    TokenStream(const TokenList& tokens, size_t first);
+
+    /**
+     * Take the Tokens of the given source from the given queue, one chunk at a time, until it is closed. The viewed
+     * characters and the queue must outlive the TokenStream.
+     */
+    TokenStream(std::experimental::string_view source, SpscQueue<std::vector<Token>>& chunks);
+
+    /**
+     * Returns the Token the given number of Tokens after the next one without consuming anything, or
+     * std::experimental::nullopt if the source ends before it. Tokens being replayed can be peeked at any distance
+     * ahead, but Tokens still to be lexed or taken from the queue only up to MAX_LOOKAHEAD.
+     * @throws SyntaxException if the source cannot be lexed.
+     * @throws IllegalStateException if looking further ahead than MAX_LOOKAHEAD allows.
+     */
+    std::experimental::optional<Token> peek(const size_t ahead = 0) {
+        if (this->lookaheadSize == 0 && ahead < this->spanSize - this->cursor) return this->span[this->cursor + ahead];
+
+        return this->peekSlow(ahead);
+    }
+
+    /**
+     * Consumes and returns the next Token, or std::experimental::nullopt if there are no more Tokens.
+     * @throws SyntaxException if the source cannot be lexed.
+     */
+    std::experimental::optional<Token> next() {
+        if (this->lookaheadSize == 0 && this->cursor < this->spanSize) {
+            this->consumedCount++;
+            return this->span[this->cursor++];
+        }
+
+        return this->nextSlow();
+    }
+
+    /**
+     * Returns whether every Token has been consumed.
+     * @throws SyntaxException if the source cannot be lexed.
+     */
+    bool done() {
+        if (this->lookaheadSize == 0 && this->cursor < this->spanSize) return false;
+
+        return !this->fill(1);
+    }
+
+    /**
+     * Returns the number of Tokens consumed by next() so far.
+     */
+    size_t consumed() const {
+        return this->consumedCount;
+    }
+
+    /**
+     * Returns whether the stream ended early at a syntax error reported to Diagnostics.
+     */
+    bool failed() const;
+
+    /**
+     * Rewinds a TokenStream replaying a TokenList to when the given number of Tokens had been consumed, so they can be
+     * parsed again.
+     * @throws IllegalStateException if the Tokens are not replayed from a TokenList, or that many were never consumed.
+     */
+    void rewind(size_t consumed);
+};
+
+#endif //SANITY_TOKEN_STREAM_H
\ No newline at end of file
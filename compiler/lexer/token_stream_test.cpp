@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <experimental/string_view>
+#include "lexer.h"
+#include "token_stream.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/symbol.h"
+#include "compiler/models/token.h"
+#include "compiler/models/token_list.h"
+#include "compiler/utils/spsc_queue.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+typedef Exceptions::SyntaxException SyntaxException;
+
+TEST(TokenStream, IsDoneForEmptySource) {
+    TokenStream tokens("");
+
+    ASSERT_TRUE(tokens.done());
+    ASSERT_FALSE(tokens.peek());
+    ASSERT_FALSE(tokens.next());
+}
+
+TEST(TokenStream, ReturnsTokensInOrder) {
+    TokenStream tokens("let foo;");
+
+    ASSERT_EQ(Token::LET, tokens.next()->kind);
+    ASSERT_EQ("foo", tokens.text(tokens.next().value()));
+    ASSERT_EQ(Token::SEMICOLON, tokens.next()->kind);
+    ASSERT_FALSE(tokens.next());
+    ASSERT_TRUE(tokens.done());
+}
+
+TEST(TokenStream, PeeksWithoutConsuming) {
+    TokenStream tokens("a b c");
+
+    ASSERT_EQ("a", tokens.text(tokens.peek().value()));
+    ASSERT_EQ("c", tokens.text(tokens.peek(2).value()));
+    ASSERT_EQ("b", tokens.text(tokens.peek(1).value()));
+    ASSERT_FALSE(tokens.peek(3));
+
+    ASSERT_EQ("a", tokens.text(tokens.next().value()));
+    ASSERT_EQ("b", tokens.text(tokens.peek().value()));
+    ASSERT_EQ("c", tokens.text(tokens.peek(1).value()));
+}
+
+TEST(TokenStream, WrapsAroundItsLookahead) {
+    TokenStream tokens("0 1 2 3 4 5 6 7 8 9");
+
+    for (int i = 0; i < 10; ++i) {
+        if (i + 3 < 10) {
+            ASSERT_EQ(i + 3, tokens.integerValue(tokens.peek(3).value()));
+        }
+        ASSERT_EQ(i, tokens.integerValue(tokens.next().value()));
+    }
+    ASSERT_TRUE(tokens.done());
+}
+
+TEST(TokenStream, ThrowsWhenPeekingPastMaxLookahead) {
+    TokenStream tokens("a b c d e");
+
+    ASSERT_THROW(tokens.peek(TokenStream::MAX_LOOKAHEAD), IllegalStateException);
+}
+
+TEST(TokenStream, LexesOnlyWhatIsRequested) {
+    TokenStream tokens("a 'bad");
+
+    ASSERT_EQ("a", tokens.text(tokens.next().value()));
+    ASSERT_THROW(tokens.next(), SyntaxException);
+}
+
+TEST(TokenStream, LocatesStreamedTokens) {
+    TokenStream tokens("foo\n  bar");
+
+    tokens.next();
+    const Location location = tokens.location(tokens.next().value());
+    ASSERT_EQ(2, location.line);
+    ASSERT_EQ(3, location.startCol);
+    ASSERT_EQ(6, location.endCol);
+}
+
+TEST(TokenStream, ReplaysTokenList) {
+    const TokenList list = Lexer::tokenize("foo \"bar\"");
+    TokenStream tokens(list);
+
+    ASSERT_EQ("foo", tokens.text(tokens.peek().value()));
+    ASSERT_EQ("foo", tokens.text(tokens.next().value()));
+    ASSERT_EQ("bar", tokens.stringValue(tokens.next().value()));
+    ASSERT_TRUE(tokens.done());
+}
+
+TEST(TokenStream, ReplaysTokenListFromIndexAndCountsConsumedTokens) {
+    const TokenList list = Lexer::tokenize("foo bar baz");
+    TokenStream tokens(list, 1);
+
+    ASSERT_EQ("baz", tokens.text(tokens.peek(1).value()));
+    ASSERT_EQ(0, tokens.consumed());
+    ASSERT_EQ("bar", tokens.text(tokens.next().value()));
+    ASSERT_EQ(1, tokens.consumed());
+    ASSERT_EQ("baz", tokens.text(tokens.next().value()));
+    ASSERT_EQ(2, tokens.consumed());
+    ASSERT_TRUE(tokens.done());
+}
+
+TEST(TokenStream, PeeksReplayedTokensAnyDistanceAhead) {
+    const TokenList list = Lexer::tokenize("a b c d e f");
+    TokenStream tokens(list);
+
+    ASSERT_EQ("f", tokens.text(tokens.peek(5).value()));
+    ASSERT_FALSE(tokens.peek(6));
+    ASSERT_EQ(0, tokens.consumed());
+}
+
+TEST(TokenStream, RewindsReplayedTokenList) {
+    const TokenList list = Lexer::tokenize("foo bar baz");
+    TokenStream tokens(list, 1);
+
+    tokens.next();
+    tokens.next();
+    ASSERT_TRUE(tokens.done());
+
+    tokens.rewind(1);
+    ASSERT_EQ(1, tokens.consumed());
+    ASSERT_EQ("baz", tokens.text(tokens.next().value()));
+
+    tokens.rewind(0);
+    ASSERT_EQ("bar", tokens.text(tokens.next().value()));
+    ASSERT_THROW(tokens.rewind(2), IllegalStateException);
+}
+
+TEST(TokenStream, ThrowsWhenRewindingLexedSource) {
+    TokenStream tokens("foo bar");
+
+    tokens.next();
+    ASSERT_THROW(tokens.rewind(0), IllegalStateException);
+}
+
+TEST(TokenStream, TakesChunksFromQueue) {
+    const std::experimental::string_view source = "a b c";
+    SpscQueue<std::vector<Token>> chunks(4);
+    chunks.push({
+        Token{Token::IDENTIFIER, 0, 1, Symbols::intern("a")},
+        Token{Token::IDENTIFIER, 2, 1, Symbols::intern("b")},
+    });
+    chunks.push({ });
+    chunks.push({ Token{Token::IDENTIFIER, 4, 1, Symbols::intern("c")} });
+    chunks.close();
+
+    TokenStream tokens(source, chunks);
+
+    ASSERT_EQ("a", tokens.text(tokens.next().value()));
+    ASSERT_EQ("c", tokens.text(tokens.peek(1).value()));
+    ASSERT_EQ("b", tokens.text(tokens.next().value()));
+    ASSERT_EQ("c", tokens.text(tokens.next().value()));
+    ASSERT_TRUE(tokens.done());
+}
\ No newline at end of file
@@ -1,28 +1,42 @@
 #include <gflags/gflags.h>
+#include <algorithm>
 #include <iostream>
 #include <memory>
-#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
-#include "utils/file_utils.h"
+#include <experimental/optional>
+#include "batch/batch.h"
+#include "emitter/emitter.h"
 #include "generator/generator.h"
+#include "jit/jit.h"
 #include "lexer/lexer.h"
+#include "lexer/token_stream.h"
 #include "models/ast.h"
+#include "models/ast_interner.h"
+#include "models/compilation_session.h"
+#include "models/diagnostics.h"
 #include "models/exceptions.h"
-#include "models/globals.h"
+#include "models/flat_ast.h"
+#include "models/token_list.h"
+#include "optimizer/optimizer.h"
 #include "parser/parser.h"
-#include "llvm/IR/LLVMContext.h"
+#include "pipeline/pipeline.h"
+#include "utils/arena.h"
+#include "utils/source_buffer.h"
+#include "utils/thread_pool.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Module.h"
-#include "llvm/IR/Value.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/raw_ostream.h"
-
-// Declared in globals.h
-std::unique_ptr<llvm::LLVMContext> context = llvm::make_unique<llvm::LLVMContext>();
-llvm::IRBuilder<> builder(*context);
-std::unique_ptr<llvm::Module> module = llvm::make_unique<llvm::Module>("Sanity", *context);
-std::map<std::string, llvm::Value*> namedValues;
+#include "llvm/Target/TargetMachine.h"
 
 typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::FormatException FormatException;
+typedef Exceptions::IllegalStateException IllegalStateException;
 typedef Exceptions::ParseException ParseException;
 typedef Exceptions::RedeclaredException RedeclaredException;
 typedef Exceptions::SyntaxException SyntaxException;
@@ -30,44 +44,173 @@ typedef Exceptions::TypeException TypeException;
 typedef Exceptions::UndeclaredException UndeclaredException;
 
 DEFINE_string(input, "-", "Path to a file of Sanity source code to compile or \"-\" to use stdin.");
+DEFINE_bool(pipeline, false, "Run the lexer, parser and generator concurrently on separate threads. Functions must be "
+    "declared before they are called.");
+DEFINE_bool(stream, false, "Lex, parse and generate one top-level element at a time, freeing the AST of each one as "
+    "soon as it has been generated, so memory stays flat for huge sources. Functions must be declared before they are "
+    "called.");
+DEFINE_int32(lexer_threads, 1, "Number of threads to tokenize and parse large sources with. With more than one, the "
+    "whole source is tokenized before parsing starts.");
+DEFINE_bool(share_expressions, false, "Share a single AST node between identical side-effect-free expressions, and "
+    "generate the LLVM IR of each shared operation only once. Ignored with --pipeline.");
+DEFINE_int32(chunk_instructions, 0, "Outline top-level statements into internal functions of about this many "
+    "instructions each, rather than generating them all into main, so huge sources do not produce one huge function. "
+    "Zero generates everything into main.");
+DEFINE_int32(opt_level, 0, "Level to optimize the LLVM IR at, from 0 for none up to 3, like -O0 to -O3 of a C "
+    "compiler.");
+DEFINE_string(emit, "llvm-ir", "Format to write the compiled program in: \"llvm-ir\" for textual LLVM IR, \"bitcode\" "
+    "for binary LLVM IR, or \"asm\" or \"obj\" for assembly or an object file of the host generated in-process.");
+DEFINE_bool(run, false, "Compile the program into the memory of this process and run it straight away, exiting with "
+    "the status its main function returns, rather than writing it out. Ignores --emit.");
+DEFINE_string(link, "", "Comma-separated paths of shared libraries which define the extern functions of a program "
+    "run with --run. Those not found in any of them are looked up in the C library.");
+DEFINE_bool(emit_ast, false, "Write the parsed AST in a binary format instead of LLVM IR, so it can be cached and "
+    "compiled later with --load_ast.");
+DEFINE_bool(load_ast, false, "Read the input as an AST written by --emit_ast rather than as Sanity source code, "
+    "skipping lexing and parsing.");
+DEFINE_int32(jobs, 0, "Number of files to compile at once when given several, each on a single thread. Zero uses one "
+    "per hardware thread.");
+DEFINE_string(output_dir, "", "Directory to write the output of each of several files into, named after the file with "
+    "the extension of --emit. Each is written next to its file when empty.");
+
+// Prints every error collected in the given Diagnostics, returning the exit code of a failed compile.
+static int report(const Diagnostics& diagnostics) {
+    for (const Diagnostic& diagnostic : diagnostics.all()) {
+        std::cerr << diagnostic.describe() << std::endl;
+    }
+    return 1;
+}
+
+// Compiles each file named by the given arguments, or listed by those naming response files, into an output file of
+// its own. Errors are printed in the order the files were given, returning the exit code of the compile.
+static int compileBatch(const std::vector<std::string>& arguments, const Emitter::Format format) {
+    if (FLAGS_input != "-" || FLAGS_run || FLAGS_emit_ast || FLAGS_load_ast) {
+        std::cerr << "--input, --run, --emit_ast and --load_ast cannot be used when compiling several files."
+            << std::endl;
+        return 1;
+    }
+
+    Batch::Options options;
+    options.format = format;
+    options.optLevel = (unsigned) FLAGS_opt_level;
+    options.chunkInstructions = (size_t) FLAGS_chunk_instructions;
+    options.shareExpressions = FLAGS_share_expressions;
+    options.outputDirectory = FLAGS_output_dir;
+
+    try {
+        const std::vector<std::string> inputs = Batch::expand(arguments);
+        ThreadPool pool(FLAGS_jobs > 0 ? (size_t) FLAGS_jobs : std::max(1u, std::thread::hardware_concurrency()));
+
+        int status = 0;
+        for (const Batch::Result& result : Batch::compile(inputs, options, pool)) {
+            for (const std::string& error : result.errors) std::cerr << result.input << ": " << error << std::endl;
+            if (!result.errors.empty()) status = 1;
+        }
+        return status;
+    } catch (const FileNotFoundException& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    } catch (const IllegalStateException& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
 
 int main(int argc, char* argv[]) {
     const auto progName = std::string(argv[0]);
-    gflags::SetUsageMessage("Compiles Sanity source code to LLVM IR.\n$ cat <source>.sane | " + progName + " | lli");
+    gflags::SetUsageMessage("Compiles Sanity source code to LLVM IR or native code.\n$ cat <source>.sane | " + progName
+        + " | lli\n$ " + progName + " --emit=obj <source>.sane... @<file listing more sources>");
     gflags::ParseCommandLineFlags(&argc, &argv, true /* remove flags from argv */);
 
+    if (FLAGS_opt_level < 0 || FLAGS_opt_level > (int32_t) Optimizer::MAX_LEVEL) {
+        std::cerr << "--opt_level must be between 0 and " << Optimizer::MAX_LEVEL << "." << std::endl;
+        return 1;
+    }
+
+    const std::experimental::optional<Emitter::Format> format = Emitter::format(FLAGS_emit);
+    if (!format) {
+        std::cerr << "--emit must be one of llvm-ir, bitcode, asm or obj." << std::endl;
+        return 1;
+    }
+
+    // Any arguments left over once the flags are removed are files to compile together.
+    if (argc > 1) return compileBatch(std::vector<std::string>(argv + 1, argv + argc), format.value());
+
     const auto inputFile = FLAGS_input != "-" ? FLAGS_input : "/dev/stdin";
 
-    // Read file into a queue of characters.
-    std::queue<char> chars;
+    // Map the file into memory, or read it in bulk if it is a pipe.
+    std::unique_ptr<const SourceBuffer> source;
     try {
-        chars = FileUtils::readFileChars(inputFile);
+        source = SourceBuffer::open(inputFile);
     } catch (const FileNotFoundException& ex) {
         std::cerr << ex.what() << std::endl;
         return 1;
+    } catch (const IllegalStateException& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
     }
 
-    // Tokenize the characters.
-    std::queue<std::shared_ptr<const Token>> tokens;
+    // Everything generated from the source, which is freed along with it once compiled.
+    CompilationSession session("Sanity");
+
     try {
-        tokens = Lexer::tokenize(chars);
+        if (FLAGS_load_ast) {
+            // Skip lexing and parsing, generating the LLVM IR straight from the AST written by an earlier run.
+            Generator generator(session);
+            generator.outline((size_t) FLAGS_chunk_instructions);
+            generator.generate(FlatAST::File::read(source->view()));
+        } else if (FLAGS_pipeline && !FLAGS_emit_ast) {
+            // Lex, parse and generate the LLVM IR concurrently, handing over each statement as soon as it is parsed.
+            Pipeline::compile(session, source->view(), (size_t) FLAGS_chunk_instructions);
+        } else if (FLAGS_stream && !FLAGS_emit_ast) {
+            // Generate each extern declaration and statement as soon as it is parsed, keeping only one in memory.
+            Pipeline::stream(session, source->view(), (size_t) FLAGS_chunk_instructions);
+        } else {
+            // Errors are collected rather than thrown where possible, so every one found is reported at once.
+            Diagnostics diagnostics;
+            Arena arena;
+            AST::Interner interner(arena);
+            const AST::File* file;
+            if (FLAGS_lexer_threads > 1) {
+                // Tokenize chunks of the source in parallel, then parse runs of statements of the tokens in parallel.
+                // Interners are not thread-safe, so shared expressions are parsed serially.
+                ThreadPool pool((size_t) FLAGS_lexer_threads);
+                const TokenList tokens = Lexer::tokenize(source->view(), pool);
+                if (FLAGS_share_expressions) {
+                    TokenStream stream(tokens);
+                    file = Parser::parse(stream, interner, diagnostics);
+                } else {
+                    file = Parser::parse(tokens, arena, pool);
+                }
+            } else {
+                // Parse the tokens, lexing each one only when the parser asks for it.
+                TokenStream tokens(source->view(), diagnostics);
+                file = FLAGS_share_expressions
+                    ? Parser::parse(tokens, interner, diagnostics) : Parser::parse(tokens, arena, diagnostics);
+            }
+            if (!diagnostics.empty()) return report(diagnostics);
+
+            if (FLAGS_emit_ast) {
+                // Write the AST instead of the LLVM IR, to be compiled later with --load_ast.
+                file->flatten().write(llvm::outs());
+                return 0;
+            }
+
+            // Generate the LLVM IR.
+            Generator generator(session, FLAGS_share_expressions ? &interner : nullptr, &diagnostics);
+            generator.outline((size_t) FLAGS_chunk_instructions);
+            generator.generate(*file);
+            if (!diagnostics.empty()) return report(diagnostics);
+        }
+    } catch (const FormatException& ex) {
+        std::cerr << "FormatException: " << ex.what() << std::endl;
+        return 1;
     } catch (const SyntaxException& ex) {
         std::cerr << ex.what() << std::endl;
         return 1;
-    }
-
-    // Parse the tokens.
-    std::shared_ptr<const AST::File> file;
-    try {
-        file = Parser::parse(tokens);
     } catch (const ParseException& ex) {
         std::cerr << "ParseException: " << ex.what() << std::endl;
         return 1;
-    }
-
-    // Generate the LLVM IR.
-    try {
-        Generator::gen(*file);
     } catch (const RedeclaredException& ex) {
         std::cerr << "RedeclaredException: " << ex.what() << std::endl;
         return 1;
@@ -79,11 +222,33 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    // Verify the IR output.
-    llvm::verifyModule(*module);
+    // Verify the IR output, as optimizing, running or emitting invalid IR is undefined.
+    if (llvm::verifyModule(*session.module, &llvm::errs())) {
+        std::cerr << "Generated invalid LLVM IR." << std::endl;
+        return 1;
+    }
+
+    try {
+        // Optimize it at the requested level for the machine which will generate its code.
+        std::unique_ptr<llvm::TargetMachine> machine = FLAGS_run
+            ? Jit::machine((unsigned) FLAGS_opt_level) : Optimizer::hostMachine((unsigned) FLAGS_opt_level);
+        Optimizer::optimize(*session.module, *machine, (unsigned) FLAGS_opt_level);
+
+        if (FLAGS_run) {
+            // Run it in-process instead of writing it out.
+            llvm::SmallVector<llvm::StringRef, 4> paths;
+            llvm::SplitString(FLAGS_link, paths, ",");
+            std::vector<std::string> libraries;
+            for (const llvm::StringRef path : paths) libraries.push_back(path.str());
+            return Jit::run(std::move(session.module), std::move(machine), libraries);
+        }
 
-    // Just print the IR output for now.
-    module->print(llvm::outs(), nullptr);
+        // Write it out in the requested format.
+        Emitter::emit(*session.module, format.value(), *machine, llvm::outs());
+    } catch (const IllegalStateException& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
 
     // Completed successfully.
     return 0;
@@ -1,78 +1,251 @@
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
+#include <experimental/string_view>
 #include "compiler/models/ast.h"
-#include "compiler/models/token.h"
+#include "compiler/models/flat_ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
-#include "compiler/models/globals.h"
 #include "compiler/models/exceptions.h"
 
 typedef Exceptions::UndeclaredException UndeclaredException;
 
-AST::BinaryOpExpression::BinaryOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-        std::shared_ptr<const AST::Expression> rightExpr)
-    : leftExpr(std::move(leftExpr)), rightExpr(std::move(rightExpr)) { }
+// Returns the name of the given Symbol in a form LLVM's streams can print.
+static llvm::StringRef nameOf(const Symbol symbol) {
+    const std::experimental::string_view name = Symbols::name(symbol);
+    return llvm::StringRef(name.data(), name.size());
+}
+
+// Returns the number of operands of the given expression.
+static size_t operandCount(const AST::Expression& expr) {
+    switch (expr.kind()) {
+        case FlatAST::ADD_OP:
+        case FlatAST::SUB_OP:
+        case FlatAST::MUL_OP:
+        case FlatAST::DIV_OP:
+            return 2;
+        case FlatAST::FUNCTION_CALL:
+            return static_cast<const AST::FunctionCall&>(expr).arguments.size();
+        default:
+            return 0;
+    }
+}
+
+// Returns the operand of the given expression at the given index, which must be less than its operandCount().
+static const AST::Expression& operandAt(const AST::Expression& expr, const size_t index) {
+    if (expr.kind() == FlatAST::FUNCTION_CALL) return *static_cast<const AST::FunctionCall&>(expr).arguments[index];
 
-AST::AddOpExpression::AddOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-        std::shared_ptr<const AST::Expression> rightExpr)
-    : BinaryOpExpression(std::move(leftExpr), std::move(rightExpr)) { }
+    const auto& operation = static_cast<const AST::BinaryOpExpression&>(expr);
+    return index == 0 ? *operation.leftExpr : *operation.rightExpr;
+}
+
+void AST::walk(const Expression& root, IExpressionWalker& walker) {
+    // Expressions whose operands are being walked, each with the index of its next operand.
+    std::vector<std::pair<const Expression*, size_t>> frames;
+    if (walker.enter(root)) frames.emplace_back(&root, 0);
+
+    while (!frames.empty()) {
+        const Expression& expr = *frames.back().first;
+        const size_t index = frames.back().second++;
+        if (index == operandCount(expr)) {
+            frames.pop_back();
+            walker.leave(expr);
+            continue;
+        }
+
+        if (index != 0) walker.between(expr);
+        const Expression& operand = operandAt(expr, index);
+        if (walker.enter(operand)) frames.emplace_back(&operand, 0);
+    }
+}
+
+namespace {
+    // Adds walked expressions to a Builder, holding the Node of each one until its parent is added.
+    class Flattener : public AST::IExpressionWalker {
+    private:
+        FlatAST::Builder& builder;
+        std::vector<FlatAST::Node> nodes;
+
+    public:
+        explicit Flattener(FlatAST::Builder& builder) : builder(builder) { }
+
+        FlatAST::Node root() const {
+            return this->nodes.back();
+        }
+
+        bool enter(const AST::Expression& expr) override {
+            return true;
+        }
+
+        void between(const AST::Expression& expr) override { }
+
+        void leave(const AST::Expression& expr) override {
+            const size_t operands = operandCount(expr);
+            std::vector<FlatAST::Node> children(this->nodes.end() - operands, this->nodes.end());
+            this->nodes.resize(this->nodes.size() - operands);
+
+            switch (expr.kind()) {
+                case FlatAST::ADD_OP:
+                case FlatAST::SUB_OP:
+                case FlatAST::MUL_OP:
+                case FlatAST::DIV_OP:
+                    this->nodes.push_back(this->builder.add(expr.kind(), children[0], children[1]));
+                    return;
+                case FlatAST::FUNCTION_CALL:
+                    this->nodes.push_back(this->builder.add(FlatAST::FUNCTION_CALL,
+                        static_cast<const AST::FunctionCall&>(expr).callee, this->builder.list(children)));
+                    return;
+                default:
+                    this->nodes.push_back(expr.flatten(this->builder));
+                    return;
+            }
+        }
+    };
+
+    // Prints walked expressions, parenthesizing every operation.
+    class Printer : public AST::IExpressionWalker {
+    private:
+        llvm::raw_ostream& stream;
+
+    public:
+        explicit Printer(llvm::raw_ostream& stream) : stream(stream) { }
+
+        bool enter(const AST::Expression& expr) override {
+            switch (expr.kind()) {
+                case FlatAST::ADD_OP:
+                case FlatAST::SUB_OP:
+                case FlatAST::MUL_OP:
+                case FlatAST::DIV_OP:
+                    this->stream << "(";
+                    return true;
+                case FlatAST::FUNCTION_CALL:
+                    this->stream << nameOf(static_cast<const AST::FunctionCall&>(expr).callee) << "(";
+                    return true;
+                default:
+                    expr.print(this->stream);
+                    return false;
+            }
+        }
+
+        void between(const AST::Expression& expr) override {
+            switch (expr.kind()) {
+                case FlatAST::ADD_OP:
+                    this->stream << ") + (";
+                    return;
+                case FlatAST::SUB_OP:
+                    this->stream << ") - (";
+                    return;
+                case FlatAST::MUL_OP:
+                    this->stream << ") * (";
+                    return;
+                case FlatAST::DIV_OP:
+                    this->stream << ") / (";
+                    return;
+                default:
+                    this->stream << ", ";
+                    return;
+            }
+        }
+
+        void leave(const AST::Expression& expr) override {
+            this->stream << ")";
+        }
+    };
+}
+
+// Flattens the given operation or call, along with every operand beneath it.
+static FlatAST::Node flattenExpression(const AST::Expression& expr, FlatAST::Builder& builder) {
+    Flattener flattener(builder);
+    AST::walk(expr, flattener);
+    return flattener.root();
+}
+
+// Prints the given operation or call, along with every operand beneath it.
+static void printExpression(const AST::Expression& expr, llvm::raw_ostream& stream) {
+    Printer printer(stream);
+    AST::walk(expr, printer);
+}
+
+AST::BinaryOpExpression::BinaryOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr)
+    : leftExpr(leftExpr), rightExpr(rightExpr) { }
+
+AST::AddOpExpression::AddOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr)
+    : BinaryOpExpression(leftExpr, rightExpr) { }
 
 llvm::Value* AST::AddOpExpression::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::AddOpExpression::flatten(FlatAST::Builder& builder) const {
+    return flattenExpression(*this, builder);
+}
+
+FlatAST::Kind AST::AddOpExpression::kind() const {
+    return FlatAST::ADD_OP;
+}
+
 void AST::AddOpExpression::print(llvm::raw_ostream& stream) const {
-    stream << "(";
-    this->leftExpr->print(stream);
-    stream << ") + (";
-    this->rightExpr->print(stream);
-    stream << ")";
+    printExpression(*this, stream);
 }
 
-AST::SubOpExpression::SubOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-        std::shared_ptr<const AST::Expression> rightExpr)
-    : BinaryOpExpression(std::move(leftExpr), std::move(rightExpr)) { }
+AST::SubOpExpression::SubOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr)
+    : BinaryOpExpression(leftExpr, rightExpr) { }
 
 llvm::Value* AST::SubOpExpression::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::SubOpExpression::flatten(FlatAST::Builder& builder) const {
+    return flattenExpression(*this, builder);
+}
+
+FlatAST::Kind AST::SubOpExpression::kind() const {
+    return FlatAST::SUB_OP;
+}
+
 void AST::SubOpExpression::print(llvm::raw_ostream& stream) const {
-    stream << "(";
-    this->leftExpr->print(stream);
-    stream << ") - (";
-    this->rightExpr->print(stream);
-    stream << ")";
+    printExpression(*this, stream);
 }
 
-AST::MulOpExpression::MulOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-        std::shared_ptr<const AST::Expression> rightExpr)
-        : BinaryOpExpression(std::move(leftExpr), std::move(rightExpr)) { }
+AST::MulOpExpression::MulOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr)
+        : BinaryOpExpression(leftExpr, rightExpr) { }
 
 llvm::Value* AST::MulOpExpression::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::MulOpExpression::flatten(FlatAST::Builder& builder) const {
+    return flattenExpression(*this, builder);
+}
+
+FlatAST::Kind AST::MulOpExpression::kind() const {
+    return FlatAST::MUL_OP;
+}
+
 void AST::MulOpExpression::print(llvm::raw_ostream& stream) const {
-    stream << "(";
-    this->leftExpr->print(stream);
-    stream << ") * (";
-    this->rightExpr->print(stream);
-    stream << ")";
+    printExpression(*this, stream);
 }
 
-AST::DivOpExpression::DivOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-        std::shared_ptr<const AST::Expression> rightExpr)
-        : BinaryOpExpression(std::move(leftExpr), std::move(rightExpr)) { }
+AST::DivOpExpression::DivOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr)
+        : BinaryOpExpression(leftExpr, rightExpr) { }
 
 llvm::Value* AST::DivOpExpression::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::DivOpExpression::flatten(FlatAST::Builder& builder) const {
+    return flattenExpression(*this, builder);
+}
+
+FlatAST::Kind AST::DivOpExpression::kind() const {
+    return FlatAST::DIV_OP;
+}
+
 void AST::DivOpExpression::print(llvm::raw_ostream& stream) const {
-    stream << "(";
-    this->leftExpr->print(stream);
-    stream << ") / (";
-    this->rightExpr->print(stream);
-    stream << ")";
+    printExpression(*this, stream);
 }
 
 void AST::IntegerType::print(llvm::raw_ostream& stream) const {
@@ -83,6 +256,10 @@ llvm::IntegerType* AST::IntegerType::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::IntegerType::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::INTEGER_TYPE);
+}
+
 void AST::StringType::print(llvm::raw_ostream& stream) const {
     stream << "string";
 }
@@ -91,14 +268,27 @@ llvm::PointerType* AST::StringType::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
-AST::FunctionPrototype::FunctionPrototype(const std::vector<std::shared_ptr<const AST::Type>>& parameters,
-        std::shared_ptr<const AST::Type> returnType)
-    : parameters(parameters), returnType(std::move(returnType)) { }
+FlatAST::Node AST::StringType::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::STRING_TYPE);
+}
+
+AST::FunctionPrototype::FunctionPrototype(const ArenaList<const AST::Type*> parameters, const AST::Type* returnType)
+    : parameters(parameters), returnType(returnType) { }
 
 llvm::FunctionType* AST::FunctionPrototype::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::FunctionPrototype::flatten(FlatAST::Builder& builder) const {
+    std::vector<FlatAST::Node> parameters;
+    for (const auto& param : this->parameters) {
+        parameters.push_back(param->flatten(builder));
+    }
+    const FlatAST::Node returnType = this->returnType->flatten(builder);
+
+    return builder.add(FlatAST::FUNCTION_PROTOTYPE, returnType, builder.list(parameters));
+}
+
 void AST::FunctionPrototype::print(llvm::raw_ostream& stream) const {
     stream << "(";
     if (!this->parameters.empty()) this->parameters[0]->print(stream);
@@ -110,54 +300,79 @@ void AST::FunctionPrototype::print(llvm::raw_ostream& stream) const {
     this->returnType->print(stream);
 }
 
-AST::Function::Function(const std::string& name, std::shared_ptr<const AST::FunctionPrototype> type)
-    : name(name), type(std::move(type)) { }
+AST::Function::Function(const Symbol name, const AST::FunctionPrototype* type)
+    : name(name), type(type) { }
 
 llvm::Function* AST::Function::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::Function::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::FUNCTION, this->name, this->type->flatten(builder));
+}
+
 void AST::Function::print(llvm::raw_ostream& stream) const {
-    stream << "extern " << this->name << ": ";
+    stream << "extern " << nameOf(this->name) << ": ";
     this->type->print(stream);
     stream << ";";
 }
 
-AST::StatementExpression::StatementExpression(std::shared_ptr<const AST::Expression> expr) : expr(std::move(expr)) { }
+AST::StatementExpression::StatementExpression(const AST::Expression* expr) : expr(expr) { }
 
 void AST::StatementExpression::generate(IGenerator& generator) const {
     generator.generate(*this);
 }
 
+FlatAST::Node AST::StatementExpression::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::STATEMENT_EXPRESSION, this->expr->flatten(builder));
+}
+
 void AST::StatementExpression::print(llvm::raw_ostream& stream) const {
     this->expr->print(stream);
     stream << ";";
 }
 
-AST::StatementLet::StatementLet(std::shared_ptr<const Token> name, std::shared_ptr<const AST::Type> type,
-        std::shared_ptr<const AST::Expression> expr)
-    : name(name->source), type(std::move(type)), expr(std::move(expr)) { }
+AST::StatementLet::StatementLet(const Symbol name, const AST::Type* type, const AST::Expression* expr)
+    : name(name), type(type), expr(expr) { }
 
 void AST::StatementLet::generate(IGenerator& generator) const {
     generator.generate(*this);
 }
 
+FlatAST::Node AST::StatementLet::flatten(FlatAST::Builder& builder) const {
+    const FlatAST::Node type = this->type->flatten(builder);
+    const FlatAST::Node expr = this->expr->flatten(builder);
+    return builder.add(FlatAST::STATEMENT_LET, this->name, builder.extra({ type, expr }));
+}
+
 void AST::StatementLet::print(llvm::raw_ostream& stream) const {
-    stream << "let " << this->name << ": ";
+    stream << "let " << nameOf(this->name) << ": ";
     this->type->print(stream);
     stream << " = ";
     this->expr->print(stream);
     stream << ";";
 }
 
-AST::File::File(std::vector<std::shared_ptr<const AST::Function>> funcs,
-        std::vector<std::shared_ptr<const AST::Statement>> statements)
-    : funcs(std::move(funcs)), statements(std::move(statements)) { }
+AST::File::File(const ArenaList<const AST::Function*> funcs, const ArenaList<const AST::Statement*> statements)
+    : funcs(funcs), statements(statements) { }
 
 llvm::Function* AST::File::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::File AST::File::flatten() const {
+    FlatAST::Builder builder;
+    for (const auto& func : this->funcs) {
+        builder.func(func->flatten(builder));
+    }
+
+    for (const auto& stmt : this->statements) {
+        builder.statement(stmt->flatten(builder));
+    }
+
+    return builder.finish();
+}
+
 void AST::File::print(llvm::raw_ostream& stream) const {
     for (const auto& func : this->funcs) {
         func->print(stream);
@@ -170,60 +385,93 @@ void AST::File::print(llvm::raw_ostream& stream) const {
     }
 }
 
-AST::CharLiteral::CharLiteral(std::shared_ptr<const Token> value) : value(value->source[0]) { }
+AST::CharLiteral::CharLiteral(const char value) : value(value) { }
 
 llvm::Value* AST::CharLiteral::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::CharLiteral::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::CHAR_LITERAL, (uint32_t) (unsigned char) this->value);
+}
+
+FlatAST::Kind AST::CharLiteral::kind() const {
+    return FlatAST::CHAR_LITERAL;
+}
+
 void AST::CharLiteral::print(llvm::raw_ostream& stream) const {
     stream << "\'" << this->value << "\'";
 }
 
-AST::IntegerLiteral::IntegerLiteral(std::shared_ptr<const Token> value) : value(std::stoi(value->source)) { }
+AST::IntegerLiteral::IntegerLiteral(const int32_t value) : value(value) { }
 
 llvm::Value* AST::IntegerLiteral::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::IntegerLiteral::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::INTEGER_LITERAL, (uint32_t) this->value);
+}
+
+FlatAST::Kind AST::IntegerLiteral::kind() const {
+    return FlatAST::INTEGER_LITERAL;
+}
+
 void AST::IntegerLiteral::print(llvm::raw_ostream& stream) const {
     stream << this->value;
 }
 
-AST::StringLiteral::StringLiteral(std::shared_ptr<const Token> value) : value(value->source) { }
+AST::StringLiteral::StringLiteral(const std::experimental::string_view value) : value(value) { }
 
 llvm::Value* AST::StringLiteral::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::StringLiteral::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::STRING_LITERAL, builder.text(this->value), (uint32_t) this->value.size());
+}
+
+FlatAST::Kind AST::StringLiteral::kind() const {
+    return FlatAST::STRING_LITERAL;
+}
+
 void AST::StringLiteral::print(llvm::raw_ostream& stream) const {
-    stream << "\"" << this->value << "\"";
+    stream << "\"" << llvm::StringRef(this->value.data(), this->value.size()) << "\"";
 }
 
-AST::FunctionCall::FunctionCall(std::shared_ptr<const Token> callee,
-        const std::vector<std::shared_ptr<const AST::Expression>> arguments)
-    : callee(callee->source), arguments(arguments) { }
+AST::FunctionCall::FunctionCall(const Symbol callee, const ArenaList<const AST::Expression*> arguments)
+    : callee(callee), arguments(arguments) { }
 
 llvm::Value* AST::FunctionCall::generate(IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::FunctionCall::flatten(FlatAST::Builder& builder) const {
+    return flattenExpression(*this, builder);
+}
+
+FlatAST::Kind AST::FunctionCall::kind() const {
+    return FlatAST::FUNCTION_CALL;
+}
+
 void AST::FunctionCall::print(llvm::raw_ostream& stream) const {
-    stream << this->callee << "(";
-    if (!this->arguments.empty()) this->arguments[0]->print(stream);
-    for (unsigned int i = 1; i < this->arguments.size(); ++i) {
-        stream << ", ";
-        this->arguments[i]->print(stream);
-    }
-    stream << ")";
+    printExpression(*this, stream);
 }
 
-AST::IdentifierExpr::IdentifierExpr(const std::shared_ptr<const Token> name) : name(name->source) { }
+AST::IdentifierExpr::IdentifierExpr(const Symbol name) : name(name) { }
 
 llvm::Value* AST::IdentifierExpr::generate(AST::IGenerator& generator) const {
     return generator.generate(*this);
 }
 
+FlatAST::Node AST::IdentifierExpr::flatten(FlatAST::Builder& builder) const {
+    return builder.add(FlatAST::IDENTIFIER_EXPR, this->name);
+}
+
+FlatAST::Kind AST::IdentifierExpr::kind() const {
+    return FlatAST::IDENTIFIER_EXPR;
+}
+
 void AST::IdentifierExpr::print(llvm::raw_ostream& stream) const {
-    stream << this->name;
+    stream << nameOf(this->name);
 }
\ No newline at end of file
@@ -1,15 +1,19 @@
 #ifndef SANITY_AST_H
 #define SANITY_AST_H
 
-#include <string>
-#include <memory>
-#include <vector>
-#include "compiler/models/token.h"
+#include <cstdint>
+#include <experimental/string_view>
+#include "compiler/models/flat_ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Value.h"
 
 /**
  * Holds all the different class representing the different elements of an abstract syntax tree representing Sanity.
+ *
+ * Nodes are allocated in an Arena and linked by plain pointers, so they need no destructors and a whole tree is freed
+ * at once with its Arena.
  */
 namespace AST {
     // Forward declare all AST types for the visitor.
@@ -59,60 +63,96 @@ namespace AST {
     class Expression : public Element {
     public:
         virtual llvm::Value* generate(IGenerator& generator) const = 0;
+
+        virtual FlatAST::Node flatten(FlatAST::Builder& builder) const = 0;
+
+        // Returns the kind of node the expression is flattened into, which tells walk() what its operands are.
+        virtual FlatAST::Kind kind() const = 0;
+    };
+
+    /**
+     * Visitor of the expressions walked by walk(). enter() is called on an expression before its operands, which are
+     * skipped along with leave() if it returns false. between() is called before each operand after the first, and
+     * leave() once every operand has been walked.
+     */
+    class IExpressionWalker {
+    public:
+        virtual bool enter(const Expression& expr) = 0;
+        virtual void between(const Expression& expr) = 0;
+        virtual void leave(const Expression& expr) = 0;
     };
 
+    /**
+     * Walks the given expression and every operand beneath it over an explicit stack rather than by recursion. The
+     * parser builds expressions nested as deeply as memory allows, so passes over them must not use the native stack.
+     */
+    void walk(const Expression& root, IExpressionWalker& walker);
+
     class BinaryOpExpression : public Expression {
     public:
-        std::shared_ptr<const AST::Expression> leftExpr;
-        std::shared_ptr<const AST::Expression> rightExpr;
+        const AST::Expression* leftExpr;
+        const AST::Expression* rightExpr;
 
-        BinaryOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-                std::shared_ptr<const AST::Expression> rightExpr);
+        BinaryOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr);
     };
 
     class AddOpExpression : public BinaryOpExpression {
     public:
-        AddOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-                std::shared_ptr<const AST::Expression> rightExpr);
+        AddOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class SubOpExpression : public BinaryOpExpression {
     public:
-        SubOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-                std::shared_ptr<const AST::Expression> rightExpr);
+        SubOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class MulOpExpression : public BinaryOpExpression {
     public:
-        MulOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-                std::shared_ptr<const AST::Expression> rightExpr);
+        MulOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class DivOpExpression : public BinaryOpExpression {
     public:
-        DivOpExpression(std::shared_ptr<const AST::Expression> leftExpr,
-                std::shared_ptr<const AST::Expression> rightExpr);
+        DivOpExpression(const AST::Expression* leftExpr, const AST::Expression* rightExpr);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class Type : public Element {
     public:
         virtual llvm::Type* generate(IGenerator& generator) const = 0;
+
+        virtual FlatAST::Node flatten(FlatAST::Builder& builder) const = 0;
     };
 
     class IntegerType : public Type {
@@ -121,6 +161,8 @@ namespace AST {
 
         llvm::IntegerType* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
@@ -130,73 +172,88 @@ namespace AST {
 
         llvm::PointerType* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class FunctionPrototype : public Type {
     public:
-        const std::vector<std::shared_ptr<const Type>> parameters;
-        const std::shared_ptr<const Type> returnType;
+        const ArenaList<const Type*> parameters;
+        const Type* const returnType;
 
-        FunctionPrototype(const std::vector<std::shared_ptr<const Type>>& parameters, std::shared_ptr<const Type> returnType);
+        FunctionPrototype(ArenaList<const Type*> parameters, const Type* returnType);
 
         llvm::FunctionType* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class Function : public Element {
     public:
-        const std::string name;
-        std::shared_ptr<const FunctionPrototype> type;
+        const Symbol name;
+        const FunctionPrototype* type;
 
-        Function(const std::string& name, std::shared_ptr<const FunctionPrototype> type);
+        Function(Symbol name, const FunctionPrototype* type);
 
         llvm::Function* generate(IGenerator& generator) const;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class Statement : public Element {
     public:
         virtual void generate(IGenerator& generator) const = 0;
+
+        virtual FlatAST::Node flatten(FlatAST::Builder& builder) const = 0;
     };
 
     class StatementExpression : public Statement {
     public:
-        std::shared_ptr<const Expression> expr;
+        const Expression* expr;
 
-        explicit StatementExpression(std::shared_ptr<const Expression> expr);
+        explicit StatementExpression(const Expression* expr);
 
         void generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class StatementLet : public Statement {
     public:
-        const std::string name;
-        std::shared_ptr<const Type> type;
-        std::shared_ptr<const Expression> expr;
+        const Symbol name;
+        const Type* type;
+        const Expression* expr;
 
-        StatementLet(std::shared_ptr<const Token> name, std::shared_ptr<const Type> type,
-                std::shared_ptr<const Expression> expr);
+        StatementLet(Symbol name, const Type* type, const Expression* expr);
 
         void generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class File : public Element {
     public:
-        const std::vector<std::shared_ptr<const Function>> funcs;
-        const std::vector<std::shared_ptr<const Statement>> statements;
+        const ArenaList<const Function*> funcs;
+        const ArenaList<const Statement*> statements;
 
-        File(std::vector<std::shared_ptr<const Function>> funcs,
-            std::vector<std::shared_ptr<const Statement>> statements);
+        File(ArenaList<const Function*> funcs, ArenaList<const Statement*> statements);
 
         llvm::Function* generate(IGenerator& generator) const;
 
+        /**
+         * Copies the File into the flat form of the AST.
+         */
+        FlatAST::File flatten() const;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
@@ -204,10 +261,14 @@ namespace AST {
     public:
         const char value;
 
-        explicit CharLiteral(std::shared_ptr<const Token> value);
+        explicit CharLiteral(char value);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
@@ -215,45 +276,60 @@ namespace AST {
     public:
         const int32_t value;
 
-        explicit IntegerLiteral(std::shared_ptr<const Token> value);
+        explicit IntegerLiteral(int32_t value);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class StringLiteral : public Expression {
     public:
-        const std::string value;
+        const std::experimental::string_view value;
 
-        explicit StringLiteral(std::shared_ptr<const Token> value);
+        explicit StringLiteral(std::experimental::string_view value);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class FunctionCall : public Expression {
     public:
-        const std::string callee;
-        const std::vector<std::shared_ptr<const Expression>> arguments;
+        const Symbol callee;
+        const ArenaList<const Expression*> arguments;
 
-        FunctionCall(std::shared_ptr<const Token> callee,
-            std::vector<std::shared_ptr<const Expression>> arguments);
+        FunctionCall(Symbol callee, ArenaList<const Expression*> arguments);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 
     class IdentifierExpr : public Expression {
     public:
-        const std::string name;
+        const Symbol name;
 
-        explicit IdentifierExpr(std::shared_ptr<const Token> name);
+        explicit IdentifierExpr(Symbol name);
 
         llvm::Value* generate(IGenerator& generator) const override;
 
+        FlatAST::Node flatten(FlatAST::Builder& builder) const override;
+
+        FlatAST::Kind kind() const override;
+
         void print(llvm::raw_ostream& stream) const override;
     };
 };
@@ -0,0 +1,46 @@
+#include "ast_interner.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <experimental/string_view>
+#include "compiler/models/ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
+
+size_t AST::Interner::KeyHash::operator()(const Key& key) const {
+    const size_t hash = std::hash<uintptr_t>()(key.left) * 31 + std::hash<uintptr_t>()(key.right);
+    return hash * 31 + key.kind;
+}
+
+AST::Interner::Interner(Arena& arena) : nodeArena(arena) { }
+
+const AST::CharLiteral* AST::Interner::charLiteral(const char value) {
+    return this->intern<CharLiteral>(Key { CHAR_LITERAL, (uintptr_t) (unsigned char) value, 0 }, value);
+}
+
+const AST::IntegerLiteral* AST::Interner::integerLiteral(const int32_t value) {
+    return this->intern<IntegerLiteral>(Key { INTEGER_LITERAL, (uintptr_t) (uint32_t) value, 0 }, value);
+}
+
+const AST::IdentifierExpr* AST::Interner::identifierExpr(const Symbol name) {
+    return this->intern<IdentifierExpr>(Key { IDENTIFIER_EXPR, name, 0 }, name);
+}
+
+const AST::StringLiteral* AST::Interner::stringLiteral(const std::experimental::string_view value) {
+    const auto found = this->strings.find(value);
+    if (found != this->strings.end()) return found->second;
+
+    // Keyed by the copy in the Arena, since the given value may not outlive the Interner.
+    const StringLiteral* literal = this->nodeArena.make<StringLiteral>(this->nodeArena.text(value));
+    this->strings.emplace(literal->value, literal);
+    this->sharedNodes.insert(literal);
+    return literal;
+}
+
+bool AST::Interner::shared(const Expression* expr) const {
+    return this->sharedNodes.count(expr) != 0;
+}
+
+size_t AST::Interner::size() const {
+    return this->sharedNodes.size();
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef SANITY_AST_INTERNER_H
+#define SANITY_AST_INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <experimental/string_view>
+#include "compiler/models/ast.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
+
+namespace AST {
+    /**
+     * Hash-consing constructor for side-effect-free expressions. Constructing an expression which is structurally
+     * identical to one constructed before returns the earlier node instead of allocating another, so an expression
+     * repeated throughout a file is only stored once, and two shared expressions are identical exactly when their
+     * pointers are equal.
+     *
+     * Literals and identifiers are always shared, as are operations whose operands are both shared. Function calls have
+     * side effects, so neither they nor any operation containing one are ever shared, and each gets a node of its own.
+     * Since every operand of a shared operation is itself shared, operations are compared by the pointers of their
+     * operands rather than by walking them.
+     *
+     * Nodes are placed in the given Arena, which must outlive the Interner. Like Arenas, Interners are not thread-safe.
+     */
+    class Interner {
+    private:
+        enum Kind : uint8_t {
+            ADD_OP,
+            SUB_OP,
+            MUL_OP,
+            DIV_OP,
+            CHAR_LITERAL,
+            INTEGER_LITERAL,
+            IDENTIFIER_EXPR,
+        };
+
+        // Kind of node along with its operands or value, which identifies a shared node.
+        class Key {
+        public:
+            Kind kind;
+            uintptr_t left;
+            uintptr_t right;
+
+            bool operator==(const Key& other) const {
+                return this->kind == other.kind && this->left == other.left && this->right == other.right;
+            }
+        };
+
+        class KeyHash {
+        public:
+            size_t operator()(const Key& key) const;
+        };
+
+        Arena& nodeArena;
+        std::unordered_map<Key, const Expression*, KeyHash> nodes;
+        std::unordered_map<std::experimental::string_view, const StringLiteral*> strings;
+        std::unordered_set<const Expression*> sharedNodes;
+
+        static Kind kindOf(const AddOpExpression*) { return ADD_OP; }
+        static Kind kindOf(const SubOpExpression*) { return SUB_OP; }
+        static Kind kindOf(const MulOpExpression*) { return MUL_OP; }
+        static Kind kindOf(const DivOpExpression*) { return DIV_OP; }
+
+        // Returns the shared node of the given Key, constructing it from the given arguments if there is none yet.
+        template <typename Node, typename... Args>
+        const Node* intern(const Key& key, Args&&... args) {
+            const auto found = this->nodes.find(key);
+            if (found != this->nodes.end()) return static_cast<const Node*>(found->second);
+
+            const Node* node = this->nodeArena.make<Node>(std::forward<Args>(args)...);
+            this->nodes.emplace(key, node);
+            this->sharedNodes.insert(node);
+            return node;
+        }
+
+    public:
+        explicit Interner(Arena& arena);
+
+        Interner(const Interner&) = delete;
+        Interner& operator=(const Interner&) = delete;
+
+        Arena& arena() {
+            return this->nodeArena;
+        }
+
+        const CharLiteral* charLiteral(char value);
+        const IntegerLiteral* integerLiteral(int32_t value);
+        const IdentifierExpr* identifierExpr(Symbol name);
+
+        /**
+         * Returns the shared StringLiteral of the given value, copying the value into the Arena the first time it is
+         * seen.
+         */
+        const StringLiteral* stringLiteral(std::experimental::string_view value);
+
+        /**
+         * Returns the Operation, one of the four binary operations, of the given operands. It is only shared if both
+         * operands are.
+         */
+        template <typename Operation>
+        const Operation* operation(const Expression* leftExpr, const Expression* rightExpr) {
+            if (!this->shared(leftExpr) || !this->shared(rightExpr)) {
+                return this->nodeArena.make<Operation>(leftExpr, rightExpr);
+            }
+
+            const Key key = { kindOf((const Operation*) nullptr), (uintptr_t) leftExpr, (uintptr_t) rightExpr };
+            return this->intern<Operation>(key, leftExpr, rightExpr);
+        }
+
+        /**
+         * Returns whether the given expression is shared, in which case it is free of side effects and any identical
+         * expression constructed by this Interner is the very same node.
+         */
+        bool shared(const Expression* expr) const;
+
+        /**
+         * Returns the number of distinct shared nodes constructed.
+         */
+        size_t size() const;
+    };
+};
+
+#endif //SANITY_AST_INTERNER_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "ast_interner.h"
+#include "symbol.h"
+#include "compiler/utils/arena.h"
+#include "llvm/Support/raw_ostream.h"
+
+TEST(Interner, SharesIdenticalLiteralsAndIdentifiers) {
+    Arena arena;
+    AST::Interner interner(arena);
+
+    ASSERT_EQ(interner.integerLiteral(1), interner.integerLiteral(1));
+    ASSERT_NE(interner.integerLiteral(1), interner.integerLiteral(-1));
+    ASSERT_EQ(interner.charLiteral('a'), interner.charLiteral('a'));
+    ASSERT_EQ(interner.identifierExpr(Symbols::intern("foo")), interner.identifierExpr(Symbols::intern("foo")));
+    ASSERT_NE(interner.identifierExpr(Symbols::intern("foo")), interner.identifierExpr(Symbols::intern("bar")));
+    ASSERT_EQ(5, interner.size());
+}
+
+TEST(Interner, SharesStringLiteralsByValue) {
+    Arena arena;
+    AST::Interner interner(arena);
+    std::string value = "Hello";
+
+    const AST::StringLiteral* literal = interner.stringLiteral(value);
+    value[0] = 'J';
+
+    ASSERT_EQ("Hello", literal->value);
+    ASSERT_EQ(literal, interner.stringLiteral("Hello"));
+    ASSERT_NE(literal, interner.stringLiteral("Jello"));
+}
+
+TEST(Interner, SharesIdenticalOperations) {
+    Arena arena;
+    AST::Interner interner(arena);
+
+    const AST::Expression* product = interner.operation<AST::MulOpExpression>(
+        interner.identifierExpr(Symbols::intern("a")), interner.identifierExpr(Symbols::intern("b")));
+    const AST::Expression* sum = interner.operation<AST::AddOpExpression>(product, interner.integerLiteral(1));
+
+    ASSERT_EQ(sum, interner.operation<AST::AddOpExpression>(
+        interner.operation<AST::MulOpExpression>(
+            interner.identifierExpr(Symbols::intern("a")), interner.identifierExpr(Symbols::intern("b"))),
+        interner.integerLiteral(1)));
+    ASSERT_NE(sum, interner.operation<AST::SubOpExpression>(product, interner.integerLiteral(1)));
+    ASSERT_NE(sum, interner.operation<AST::AddOpExpression>(interner.integerLiteral(1), product));
+    ASSERT_TRUE(interner.shared(sum));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    sum->print(ss);
+    ASSERT_EQ("((a) * (b)) + (1)", ss.str());
+}
+
+TEST(Interner, NeverSharesFunctionCalls) {
+    Arena arena;
+    AST::Interner interner(arena);
+    const AST::FunctionCall call(Symbols::intern("getchar"), ArenaList<const AST::Expression*>());
+
+    const AST::Expression* first = interner.operation<AST::AddOpExpression>(&call, interner.integerLiteral(1));
+    const AST::Expression* second = interner.operation<AST::AddOpExpression>(&call, interner.integerLiteral(1));
+
+    ASSERT_NE(first, second);
+    ASSERT_FALSE(interner.shared(first));
+    ASSERT_FALSE(interner.shared(&call));
+}
\ No newline at end of file
@@ -1,16 +1,15 @@
 #include <gtest/gtest.h>
 #include "ast.h"
-#include "globals.h"
-#include "token.h"
-#include "token_builder.h"
+#include "symbol.h"
+#include "compiler/utils/arena.h"
 #include "llvm/Support/raw_ostream.h"
 
 TEST(AST, AddOpExpressionPrints) {
-    const auto leftValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto addition = AST::AddOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 1;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 2;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto addition = AST::AddOpExpression(&leftExpr, &rightExpr);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -19,11 +18,11 @@ TEST(AST, AddOpExpressionPrints) {
 }
 
 TEST(AST, SubOpExpressionPrints) {
-    const auto leftValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto subtraction = AST::SubOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 2;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 1;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto subtraction = AST::SubOpExpression(&leftExpr, &rightExpr);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -32,11 +31,11 @@ TEST(AST, SubOpExpressionPrints) {
 }
 
 TEST(AST, MulOpExpressionPrints) {
-    const auto leftValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto multiplication = AST::MulOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 1;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 2;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto multiplication = AST::MulOpExpression(&leftExpr, &rightExpr);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -45,11 +44,11 @@ TEST(AST, MulOpExpressionPrints) {
 }
 
 TEST(AST, DivOpExpressionPrints) {
-    const auto leftValue = TokenBuilder("2").setIntegerLiteral(true).build();
-    const auto leftExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(leftValue));
-    const auto rightValue = TokenBuilder("1").setIntegerLiteral(true).build();
-    const auto rightExpr = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(rightValue));
-    const auto division = AST::DivOpExpression(leftExpr, rightExpr);
+    const int32_t leftValue = 2;
+    const AST::IntegerLiteral leftExpr(leftValue);
+    const int32_t rightValue = 1;
+    const AST::IntegerLiteral rightExpr(rightValue);
+    const auto division = AST::DivOpExpression(&leftExpr, &rightExpr);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -76,9 +75,10 @@ TEST(AST, StringTypePrints) {
 }
 
 TEST(AST, FunctionPrototypePrints) {
-    const auto integer = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ integer, integer });
-    const auto proto = AST::FunctionPrototype(params, integer);
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer, &integer }));
+    const auto proto = AST::FunctionPrototype(params, &integer);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -87,11 +87,11 @@ TEST(AST, FunctionPrototypePrints) {
 }
 
 TEST(AST, FunctionPrints) {
-    const auto integer = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ integer, integer });
-    const auto proto = std::make_shared<const AST::FunctionPrototype>(AST::FunctionPrototype(
-            params, integer /* returnType */));
-    const auto func = AST::Function("test", proto);
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer, &integer }));
+    const AST::FunctionPrototype proto(params, &integer /* returnType */);
+    const auto func = AST::Function(Symbols::intern("test"), &proto);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -100,9 +100,9 @@ TEST(AST, FunctionPrints) {
 }
 
 TEST(AST, StatementExpressionPrints) {
-    std::shared_ptr<const Token> token = TokenBuilder("a").setCharLiteral(true).build();
-    const auto character = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(token));
-    const auto stmt = AST::StatementExpression(character);
+    const char value = 'a';
+    const AST::CharLiteral character(value);
+    const auto stmt = AST::StatementExpression(&character);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -111,11 +111,11 @@ TEST(AST, StatementExpressionPrints) {
 }
 
 TEST(AST, StatementLetPrints) {
-    std::shared_ptr<const Token> name = TokenBuilder("foo").build();
-    std::shared_ptr<const Token> valueToken = TokenBuilder("1").build();
-    const auto type = std::make_shared<const AST::IntegerType>(AST::IntegerType());
-    const auto value = std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(valueToken));
-    const auto stmt = AST::StatementLet(name, type, value);
+    const Symbol name = Symbols::intern("foo");
+    const int32_t literalValue = 1;
+    const AST::IntegerType type;
+    const AST::IntegerLiteral value(literalValue);
+    const auto stmt = AST::StatementLet(name, &type, &value);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -124,21 +124,22 @@ TEST(AST, StatementLetPrints) {
 }
 
 TEST(AST, FilePrints) {
-    const auto params = std::vector<std::shared_ptr<const AST::Type>>({ std::make_shared<const AST::IntegerType>(AST::IntegerType()) });
-    const auto returnValue = std::make_shared<AST::IntegerType>(AST::IntegerType());
-    const auto externDeclType = std::make_shared<const AST::FunctionPrototype>(AST::FunctionPrototype(params, returnValue));
-    const auto externDecl = std::make_shared<const AST::Function>(AST::Function("putchar", externDeclType));
-
-    std::shared_ptr<const Token> char1Token = TokenBuilder("a").setCharLiteral(true).build();
-    const auto char1 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(char1Token));
-    const auto firstStmt = std::make_shared<const AST::StatementExpression>(AST::StatementExpression(char1));
-
-    std::shared_ptr<const Token> char2Token = TokenBuilder("b").setCharLiteral(true).build();
-    const auto char2 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(char2Token));
-    const auto secondStmt = std::make_shared<const AST::StatementExpression>(AST::StatementExpression(char2));
-
-    const std::vector<std::shared_ptr<const AST::Function>> externDecls = {externDecl};
-    const std::vector<std::shared_ptr<const AST::Statement>> stmts = {firstStmt, secondStmt};
+    Arena arena;
+    const AST::IntegerType integer;
+    const auto params = arena.list(std::vector<const AST::Type*>({ &integer }));
+    const AST::FunctionPrototype externDeclType(params, &integer);
+    const AST::Function externDecl(Symbols::intern("putchar"), &externDeclType);
+
+    const char char1Value = 'a';
+    const AST::CharLiteral char1(char1Value);
+    const AST::StatementExpression firstStmt(&char1);
+
+    const char char2Value = 'b';
+    const AST::CharLiteral char2(char2Value);
+    const AST::StatementExpression secondStmt(&char2);
+
+    const auto externDecls = arena.list(std::vector<const AST::Function*>({ &externDecl }));
+    const auto stmts = arena.list(std::vector<const AST::Statement*>({ &firstStmt, &secondStmt }));
     const auto file = AST::File(externDecls, stmts);
 
     std::string str;
@@ -148,13 +149,13 @@ TEST(AST, FilePrints) {
 }
 
 TEST(AST, CharLiteralParsesToChar) {
-    std::shared_ptr<const Token> token = TokenBuilder("a").setCharLiteral(true).build();
-    ASSERT_EQ('a', AST::CharLiteral(token).value);
+    const char value = 'a';
+    ASSERT_EQ('a', AST::CharLiteral(value).value);
 }
 
 TEST(AST, CharLiteralPrints) {
-    std::shared_ptr<const Token> token = TokenBuilder("a").setCharLiteral(true).build();
-    const auto literal = AST::CharLiteral(token);
+    const char value = 'a';
+    const auto literal = AST::CharLiteral(value);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -163,13 +164,13 @@ TEST(AST, CharLiteralPrints) {
 }
 
 TEST(AST, IntegerLiteralParsesToInteger) {
-    std::shared_ptr<const Token> token = TokenBuilder("1234").setIntegerLiteral(true).build();
-    ASSERT_EQ(1234, AST::IntegerLiteral(token).value);
+    const int32_t value = 1234;
+    ASSERT_EQ(1234, AST::IntegerLiteral(value).value);
 }
 
 TEST(AST, IntegerLiteralPrints) {
-    std::shared_ptr<const Token> token = TokenBuilder("1234").setIntegerLiteral(true).build();
-    const auto literal = AST::IntegerLiteral(token);
+    const int32_t value = 1234;
+    const auto literal = AST::IntegerLiteral(value);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -178,8 +179,8 @@ TEST(AST, IntegerLiteralPrints) {
 }
 
 TEST(AST, StringLiteralPrints) {
-    std::shared_ptr<const Token> token = TokenBuilder("abc123").setStringLiteral(true).build();
-    const auto literal = AST::StringLiteral(token);
+    const std::string value = "abc123";
+    const auto literal = AST::StringLiteral(value);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -188,12 +189,13 @@ TEST(AST, StringLiteralPrints) {
 }
 
 TEST(AST, FunctionCallPrints) {
-    const std::shared_ptr<const Token> callee = TokenBuilder("test").build();
-    const std::shared_ptr<const Token> charLiteral1 = TokenBuilder("a").setCharLiteral(true).build();
-    const auto arg1 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(charLiteral1));
-    const std::shared_ptr<const Token> charLiteral2 = TokenBuilder("b").setCharLiteral(true).build();
-    const auto arg2 = std::make_shared<const AST::CharLiteral>(AST::CharLiteral(charLiteral2));
-    const std::vector<std::shared_ptr<const AST::Expression>> args({ arg1, arg2 });
+    const Symbol callee = Symbols::intern("test");
+    const char charLiteral1 = 'a';
+    const AST::CharLiteral arg1(charLiteral1);
+    const char charLiteral2 = 'b';
+    const AST::CharLiteral arg2(charLiteral2);
+    Arena arena;
+    const auto args = arena.list(std::vector<const AST::Expression*>({ &arg1, &arg2 }));
 
     const auto func = AST::FunctionCall(callee, args);
 
@@ -204,7 +206,7 @@ TEST(AST, FunctionCallPrints) {
 }
 
 TEST(AST, IdentifierExprPrints) {
-    const std::shared_ptr<const Token> name = TokenBuilder("test").build();
+    const Symbol name = Symbols::intern("test");
     const auto identifier = AST::IdentifierExpr(name);
 
     std::string str;
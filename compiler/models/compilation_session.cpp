@@ -0,0 +1,8 @@
+#include "compilation_session.h"
+
+#include <string>
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/Module.h"
+
+CompilationSession::CompilationSession(const std::string& name)
+    : module(llvm::make_unique<llvm::Module>(name, this->context)), builder(this->context) { }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef SANITY_COMPILATION_SESSION_H
+#define SANITY_COMPILATION_SESSION_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Value.h"
+#include "compiler/models/symbol.h"
+
+/**
+ * State of a single compilation: the LLVM context owning its types and constants, the module generated into, the
+ * builder inserting into it and the value of each variable in scope. Sessions share nothing with each other, so
+ * separate sources can be compiled at the same time on separate threads as long as each has a session of its own, and
+ * nothing is left behind from one compilation to the next.
+ */
+class CompilationSession {
+public:
+    // Declared first so it is destroyed last, after everything else here which refers to it.
+    llvm::LLVMContext context;
+
+    // Null once moved out to be run, such as by the JIT. It must still not outlive its session's context.
+    std::unique_ptr<llvm::Module> module;
+    llvm::IRBuilder<> builder;
+    std::unordered_map<Symbol, llvm::Value*> namedValues;
+
+    /**
+     * Starts a session with an empty module of the given name.
+     */
+    explicit CompilationSession(const std::string& name);
+
+    CompilationSession(const CompilationSession&) = delete;
+    CompilationSession& operator=(const CompilationSession&) = delete;
+};
+
+#endif //SANITY_COMPILATION_SESSION_H
\ No newline at end of file
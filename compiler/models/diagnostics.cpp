@@ -0,0 +1,42 @@
+#include "diagnostics.h"
+#include <string>
+#include <utility>
+#include "exceptions.h"
+
+typedef Exceptions::AssertionException AssertionException;
+typedef Exceptions::ParseException ParseException;
+typedef Exceptions::RedeclaredException RedeclaredException;
+typedef Exceptions::SyntaxException SyntaxException;
+typedef Exceptions::TypeException TypeException;
+typedef Exceptions::UndeclaredException UndeclaredException;
+
+Diagnostic::Diagnostic(const Kind kind, std::string message, const int line, const int startCol, const int endCol)
+    : kind(kind), message(std::move(message)), line(line), startCol(startCol), endCol(endCol) { }
+
+void Diagnostic::raise() const {
+    switch (this->kind) {
+        case SYNTAX: throw SyntaxException(this->message, this->line, this->startCol, this->endCol);
+        case PARSE: throw ParseException(this->message);
+        case REDECLARED: throw RedeclaredException(this->message);
+        case TYPE: throw TypeException(this->message);
+        case UNDECLARED: throw UndeclaredException(this->message);
+    }
+
+    throw AssertionException("Unknown Diagnostic kind: " + std::to_string(this->kind));
+}
+
+std::string Diagnostic::describe() const {
+    switch (this->kind) {
+        case SYNTAX: return SyntaxException(this->message, this->line, this->startCol, this->endCol).what();
+        case PARSE: return "ParseException: " + this->message;
+        case REDECLARED: return "RedeclaredException: " + this->message;
+        case TYPE: return "TypeException: " + this->message;
+        case UNDECLARED: return "UndeclaredException: " + this->message;
+    }
+
+    throw AssertionException("Unknown Diagnostic kind: " + std::to_string(this->kind));
+}
+
+void Diagnostics::report(Diagnostic diagnostic) {
+    this->diagnosticList.push_back(std::move(diagnostic));
+}
\ No newline at end of file
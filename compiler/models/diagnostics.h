@@ -0,0 +1,110 @@
+#ifndef SANITY_DIAGNOSTICS_H
+#define SANITY_DIAGNOSTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <experimental/optional>
+
+/**
+ * Compile error passed around as a value rather than thrown. Each kind stands for one of the exceptions a compile can
+ * otherwise throw, so callers can switch between the two freely.
+ */
+class Diagnostic {
+public:
+    enum Kind : uint8_t {
+        SYNTAX,
+        PARSE,
+        REDECLARED,
+        TYPE,
+        UNDECLARED,
+    };
+
+    Kind kind;
+    std::string message;
+
+    // Location of a SYNTAX error, which its exception formats into its message. Unused by every other kind.
+    int line;
+    int startCol;
+    int endCol;
+
+    Diagnostic(Kind kind, std::string message, int line = 0, int startCol = 0, int endCol = 0);
+
+    /**
+     * Throws the exception this Diagnostic stands for.
+     * @throws SyntaxException
+     * @throws ParseException
+     * @throws RedeclaredException
+     * @throws TypeException
+     * @throws UndeclaredException
+     */
+    [[noreturn]] void raise() const;
+
+    /**
+     * Returns the Diagnostic as the compiler prints it, the same as it prints the exception it stands for.
+     */
+    std::string describe() const;
+};
+
+/**
+ * Sink which collects every Diagnostic reported during a compile, so that a phase can report an error and carry on to
+ * find the next one rather than stopping at the first.
+ */
+class Diagnostics {
+private:
+    std::vector<Diagnostic> diagnosticList;
+
+public:
+    void report(Diagnostic diagnostic);
+
+    bool empty() const {
+        return this->diagnosticList.empty();
+    }
+
+    size_t size() const {
+        return this->diagnosticList.size();
+    }
+
+    // Every Diagnostic reported so far, in the order they were reported.
+    const std::vector<Diagnostic>& all() const {
+        return this->diagnosticList;
+    }
+};
+
+/**
+ * Either a value or the Diagnostic which prevented it from being produced, for operations which stop at their first
+ * error and report it without throwing.
+ */
+template <typename T>
+class Result {
+private:
+    std::experimental::optional<T> result;
+    std::experimental::optional<Diagnostic> diagnostic;
+
+public:
+    Result(T value) : result(std::move(value)) { }
+    Result(Diagnostic diagnostic) : diagnostic(std::move(diagnostic)) { }
+
+    bool ok() const {
+        return static_cast<bool>(this->result);
+    }
+
+    /**
+     * Returns the value, or throws the exception the Diagnostic stands for if there is none.
+     */
+    T& value() {
+        if (!this->result) this->diagnostic->raise();
+        return *this->result;
+    }
+
+    /**
+     * Returns the Diagnostic, which must only be called when there is no value.
+     */
+    const Diagnostic& error() const {
+        return *this->diagnostic;
+    }
+};
+
+#endif //SANITY_DIAGNOSTICS_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "diagnostics.h"
+#include "exceptions.h"
+
+typedef Exceptions::ParseException ParseException;
+typedef Exceptions::RedeclaredException RedeclaredException;
+typedef Exceptions::SyntaxException SyntaxException;
+typedef Exceptions::TypeException TypeException;
+typedef Exceptions::UndeclaredException UndeclaredException;
+
+TEST(Diagnostic, RaisesExceptionOfItsKind) {
+    ASSERT_THROW(Diagnostic(Diagnostic::SYNTAX, "Bad character").raise(), SyntaxException);
+    ASSERT_THROW(Diagnostic(Diagnostic::PARSE, "Bad token").raise(), ParseException);
+    ASSERT_THROW(Diagnostic(Diagnostic::REDECLARED, "Declared twice").raise(), RedeclaredException);
+    ASSERT_THROW(Diagnostic(Diagnostic::TYPE, "Type mismatch").raise(), TypeException);
+    ASSERT_THROW(Diagnostic(Diagnostic::UNDECLARED, "Not declared").raise(), UndeclaredException);
+}
+
+TEST(Diagnostic, DescribesItselfLikeItsException) {
+    const Diagnostic syntax(Diagnostic::SYNTAX, "Bad character", 2, 3, 4);
+    const Diagnostic type(Diagnostic::TYPE, "Type mismatch");
+
+    ASSERT_EQ(std::string(SyntaxException("Bad character", 2, 3, 4).what()), syntax.describe());
+    ASSERT_EQ("TypeException: Type mismatch", type.describe());
+}
+
+TEST(Diagnostics, CollectsEveryReportInOrder) {
+    Diagnostics diagnostics;
+    ASSERT_TRUE(diagnostics.empty());
+
+    diagnostics.report(Diagnostic(Diagnostic::PARSE, "First"));
+    diagnostics.report(Diagnostic(Diagnostic::TYPE, "Second"));
+
+    ASSERT_EQ(2, diagnostics.size());
+    ASSERT_EQ("First", diagnostics.all()[0].message);
+    ASSERT_EQ(Diagnostic::TYPE, diagnostics.all()[1].kind);
+}
+
+TEST(Result, HoldsValueOrDiagnostic) {
+    Result<std::string> value(std::string("value"));
+    Result<std::string> error(Diagnostic(Diagnostic::PARSE, "Bad token"));
+
+    ASSERT_TRUE(value.ok());
+    ASSERT_EQ("value", value.value());
+    ASSERT_FALSE(error.ok());
+    ASSERT_EQ("Bad token", error.error().message);
+    ASSERT_THROW(error.value(), ParseException);
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 typedef Exceptions::AssertionException AssertionException;
 typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::FormatException FormatException;
 typedef Exceptions::IllegalStateException IllegalStateException;
 typedef Exceptions::ParseException ParseException;
 typedef Exceptions::RedeclaredException RedeclaredException;
@@ -24,6 +25,12 @@ const char* FileNotFoundException::what() const noexcept {
     return this->message.c_str();
 }
 
+FormatException::FormatException(const std::string& message): message(message) { }
+
+const char* FormatException::what() const noexcept {
+    return this->message.c_str();
+}
+
 IllegalStateException::IllegalStateException(const std::string& reason) : reason(reason) { }
 
 const char* IllegalStateException::what() const noexcept {
@@ -31,6 +31,17 @@ namespace Exceptions {
         const char* what() const noexcept override;
     };
 
+    /**
+     * Exception to throw when serialized data is malformed or was written in an unsupported version of its format.
+     */
+    struct FormatException : public std::exception {
+        const std::string message;
+
+        explicit FormatException(const std::string& message);
+
+        const char* what() const noexcept override;
+    };
+
     /**
      * Exception to throw when an illegal state is detected which makes it impossible to continue.
      */
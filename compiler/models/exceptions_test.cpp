@@ -2,6 +2,7 @@
 #include "exceptions.h"
 
 typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::FormatException FormatException;
 typedef Exceptions::IllegalStateException IllegalStateException;
 typedef Exceptions::ParseException ParseException;
 typedef Exceptions::RedeclaredException RedeclaredException;
@@ -14,6 +15,11 @@ TEST(Exceptions, FileNotFoundExceptionExists) {
     SUCCEED(); // If this compiles and executes, then we're good.
 }
 
+TEST(Exceptions, FormatExceptionExists) {
+    FormatException("Bad format");
+    SUCCEED(); // If this compiles and executes, then we're good.
+}
+
 TEST(Exceptions, IllegalStateExceptionExists) {
     IllegalStateException("Bad state");
     SUCCEED(); // If this compiles and executes, then we're good.
@@ -0,0 +1,432 @@
+#include "flat_ast.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <experimental/string_view>
+#include "compiler/models/exceptions.h"
+#include "compiler/models/symbol.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+typedef Exceptions::AssertionException AssertionException;
+typedef Exceptions::FormatException FormatException;
+
+// Returns the name of the given Symbol in a form LLVM's streams can print.
+static llvm::StringRef nameOf(const Symbol symbol) {
+    const std::experimental::string_view name = Symbols::name(symbol);
+    return llvm::StringRef(name.data(), name.size());
+}
+
+// First word of the binary format, which also tells apart Files written with the other byte order.
+static const uint32_t MAGIC = 0x54534153; // "SAST" when written little-endian.
+
+// Returns whether the lhs of the given kind of node is a Symbol.
+static bool namesSymbol(const FlatAST::Kind kind) {
+    return kind == FlatAST::FUNCTION || kind == FlatAST::STATEMENT_LET || kind == FlatAST::FUNCTION_CALL
+        || kind == FlatAST::IDENTIFIER_EXPR;
+}
+
+bool FlatAST::isExpression(const Kind kind) {
+    switch (kind) {
+        case FlatAST::ADD_OP:
+        case FlatAST::SUB_OP:
+        case FlatAST::MUL_OP:
+        case FlatAST::DIV_OP:
+        case FlatAST::CHAR_LITERAL:
+        case FlatAST::INTEGER_LITERAL:
+        case FlatAST::STRING_LITERAL:
+        case FlatAST::FUNCTION_CALL:
+        case FlatAST::IDENTIFIER_EXPR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the operator of the given kind of binary operation.
+static const char* operatorOf(const FlatAST::Kind kind) {
+    switch (kind) {
+        case FlatAST::ADD_OP: return "+";
+        case FlatAST::SUB_OP: return "-";
+        case FlatAST::MUL_OP: return "*";
+        default: return "/";
+    }
+}
+
+// Returns whether the given kind of node is a type.
+static bool isType(const FlatAST::Kind kind) {
+    return kind == FlatAST::INTEGER_TYPE || kind == FlatAST::STRING_TYPE || kind == FlatAST::FUNCTION_PROTOTYPE;
+}
+
+template <typename T>
+static void writeArray(llvm::raw_ostream& stream, const T* items, const size_t count) {
+    stream.write((const char*) items, count * sizeof(T));
+}
+
+// Copies the given number of items from the front of the given data into the given vector or string, removing them
+// from the data.
+template <typename Array>
+static void readArray(std::experimental::string_view& data, Array& items, const size_t count) {
+    typedef typename Array::value_type T;
+    if (data.size() / sizeof(T) < count) throw FormatException("AST data is truncated.");
+
+    items.resize(count);
+    if (count != 0) std::memcpy(&items[0], data.data(), count * sizeof(T));
+    data.remove_prefix(count * sizeof(T));
+}
+
+size_t FlatAST::File::bytes() const {
+    return this->kinds.capacity() * sizeof(Kind)
+        + this->lhsOperands.capacity() * sizeof(uint32_t)
+        + this->rhsOperands.capacity() * sizeof(uint32_t)
+        + this->extraOperands.capacity() * sizeof(uint32_t)
+        + this->textData.capacity()
+        + this->funcList.capacity() * sizeof(Node)
+        + this->statementList.capacity() * sizeof(Node);
+}
+
+void FlatAST::File::print(llvm::raw_ostream& stream) const {
+    for (const Node func : this->funcList) {
+        this->print(stream, func);
+        stream << "\n";
+    }
+
+    for (const Node stmt : this->statementList) {
+        this->print(stream, stmt);
+        stream << "\n";
+    }
+}
+
+void FlatAST::File::print(llvm::raw_ostream& stream, const Node node) const {
+    switch (this->kind(node)) {
+        case ADD_OP:
+        case SUB_OP:
+        case MUL_OP:
+        case DIV_OP:
+        case FUNCTION_CALL:
+            this->printExpression(stream, node);
+            return;
+        case INTEGER_TYPE:
+            stream << "int";
+            return;
+        case STRING_TYPE:
+            stream << "string";
+            return;
+        case FUNCTION_PROTOTYPE:
+            this->printList(stream, this->rhs(node));
+            stream << " -> ";
+            this->print(stream, this->lhs(node));
+            return;
+        case FUNCTION:
+            stream << "extern " << nameOf(this->lhs(node)) << ": ";
+            this->print(stream, this->rhs(node));
+            stream << ";";
+            return;
+        case STATEMENT_EXPRESSION:
+            this->print(stream, this->lhs(node));
+            stream << ";";
+            return;
+        case STATEMENT_LET:
+            stream << "let " << nameOf(this->lhs(node)) << ": ";
+            this->print(stream, this->extra(this->rhs(node)));
+            stream << " = ";
+            this->print(stream, this->extra(this->rhs(node) + 1));
+            stream << ";";
+            return;
+        case CHAR_LITERAL:
+            stream << "\'" << (char) this->lhs(node) << "\'";
+            return;
+        case INTEGER_LITERAL:
+            stream << (int32_t) this->lhs(node);
+            return;
+        case STRING_LITERAL: {
+            const std::experimental::string_view value = this->text(node);
+            stream << "\"" << llvm::StringRef(value.data(), value.size()) << "\"";
+            return;
+        }
+        case IDENTIFIER_EXPR:
+            stream << nameOf(this->lhs(node));
+            return;
+    }
+
+    throw AssertionException("Unknown kind of node " + std::to_string(this->kind(node)) + ".");
+}
+
+// Prints the given operation or call over an explicit stack rather than by recursion, so however deeply it is nested
+// it cannot overflow the native one.
+void FlatAST::File::printExpression(llvm::raw_ostream& stream, const Node root) const {
+    // Expressions being printed, each with the index of its next operand.
+    std::vector<std::pair<Node, size_t>> frames;
+    frames.emplace_back(root, 0);
+
+    while (!frames.empty()) {
+        const Node node = frames.back().first;
+        const size_t index = frames.back().second++;
+        switch (this->kind(node)) {
+            case ADD_OP:
+            case SUB_OP:
+            case MUL_OP:
+            case DIV_OP:
+                if (index == 0) {
+                    stream << "(";
+                    frames.emplace_back(this->lhs(node), 0);
+                } else if (index == 1) {
+                    stream << ") " << operatorOf(this->kind(node)) << " (";
+                    frames.emplace_back(this->rhs(node), 0);
+                } else {
+                    stream << ")";
+                    frames.pop_back();
+                }
+                break;
+            case FUNCTION_CALL: {
+                const NodeList arguments = this->list(this->rhs(node));
+                if (index == 0) stream << nameOf(this->lhs(node)) << "(";
+                if (index == arguments.size()) {
+                    stream << ")";
+                    frames.pop_back();
+                } else {
+                    if (index != 0) stream << ", ";
+                    frames.emplace_back(arguments[index], 0);
+                }
+                break;
+            }
+            default:
+                this->print(stream, node);
+                frames.pop_back();
+                break;
+        }
+    }
+}
+
+// Prints the list of Nodes at the given index in extra, comma separated in parentheses.
+void FlatAST::File::printList(llvm::raw_ostream& stream, const uint32_t index) const {
+    const NodeList nodes = this->list(index);
+
+    stream << "(";
+    if (nodes.size() != 0) this->print(stream, nodes[0]);
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        stream << ", ";
+        this->print(stream, nodes[i]);
+    }
+    stream << ")";
+}
+
+FlatAST::Node FlatAST::Builder::add(const Kind kind, const uint32_t lhs, const uint32_t rhs) {
+    this->file.kinds.push_back(kind);
+    this->file.lhsOperands.push_back(lhs);
+    this->file.rhsOperands.push_back(rhs);
+    return (Node) (this->file.kinds.size() - 1);
+}
+
+uint32_t FlatAST::Builder::extra(const std::initializer_list<uint32_t> operands) {
+    const auto index = (uint32_t) this->file.extraOperands.size();
+    this->file.extraOperands.insert(this->file.extraOperands.end(), operands);
+    return index;
+}
+
+uint32_t FlatAST::Builder::list(const std::vector<Node>& nodes) {
+    const auto index = (uint32_t) this->file.extraOperands.size();
+    this->file.extraOperands.push_back((uint32_t) nodes.size());
+    this->file.extraOperands.insert(this->file.extraOperands.end(), nodes.begin(), nodes.end());
+    return index;
+}
+
+uint32_t FlatAST::Builder::text(const std::experimental::string_view text) {
+    const auto offset = (uint32_t) this->file.textData.size();
+    this->file.textData.append(text.data(), text.size());
+    return offset;
+}
+
+void FlatAST::Builder::func(const Node func) {
+    this->file.funcList.push_back(func);
+}
+
+void FlatAST::Builder::statement(const Node statement) {
+    this->file.statementList.push_back(statement);
+}
+
+FlatAST::File FlatAST::Builder::finish() {
+    File file = std::move(this->file);
+    this->file = File();
+    return file;
+}
+
+// The binary format is a header of nine words followed by the arrays of the File, each copied byte for byte in the
+// byte order of the machine which wrote it. Words come first and bytes last, so no array needs padding to be aligned:
+//
+// header: MAGIC, FORMAT_VERSION, node count, extra count, text size, func count, statement count, symbol count and
+//     symbol text size.
+// words: lhs, rhs, extra, funcs, statements, then the end offset of each symbol's name in the symbol text.
+// bytes: kinds, text, then the symbol text.
+//
+// Symbols are only meaningful within the process which interned them, so each one is written as an index into a table
+// of the names of every Symbol the File uses.
+void FlatAST::File::write(llvm::raw_ostream& stream) const {
+    std::unordered_map<Symbol, uint32_t> indexes;
+    std::vector<uint32_t> symbolEnds;
+    std::string symbolText;
+    std::vector<uint32_t> lhs = this->lhsOperands;
+    for (size_t node = 0; node < this->kinds.size(); ++node) {
+        if (!namesSymbol(this->kinds[node])) continue;
+
+        const auto inserted = indexes.emplace(lhs[node], (uint32_t) indexes.size());
+        if (inserted.second) {
+            const std::experimental::string_view name = Symbols::name(lhs[node]);
+            symbolText.append(name.data(), name.size());
+            symbolEnds.push_back((uint32_t) symbolText.size());
+        }
+        lhs[node] = inserted.first->second;
+    }
+
+    const uint32_t header[] = {
+        MAGIC, FORMAT_VERSION, (uint32_t) this->kinds.size(), (uint32_t) this->extraOperands.size(),
+        (uint32_t) this->textData.size(), (uint32_t) this->funcList.size(), (uint32_t) this->statementList.size(),
+        (uint32_t) symbolEnds.size(), (uint32_t) symbolText.size(),
+    };
+    writeArray(stream, header, sizeof(header) / sizeof(header[0]));
+    writeArray(stream, lhs.data(), lhs.size());
+    writeArray(stream, this->rhsOperands.data(), this->rhsOperands.size());
+    writeArray(stream, this->extraOperands.data(), this->extraOperands.size());
+    writeArray(stream, this->funcList.data(), this->funcList.size());
+    writeArray(stream, this->statementList.data(), this->statementList.size());
+    writeArray(stream, symbolEnds.data(), symbolEnds.size());
+    writeArray(stream, this->kinds.data(), this->kinds.size());
+    writeArray(stream, this->textData.data(), this->textData.size());
+    writeArray(stream, symbolText.data(), symbolText.size());
+}
+
+FlatAST::File FlatAST::File::read(std::experimental::string_view data) {
+    std::vector<uint32_t> header;
+    readArray(data, header, 9);
+    if (header[0] != MAGIC) throw FormatException("AST data does not start with the expected magic number.");
+    if (header[1] != FORMAT_VERSION) {
+        throw FormatException("AST data is in version " + std::to_string(header[1])
+            + " of the format, but only version " + std::to_string(FORMAT_VERSION) + " is supported.");
+    }
+
+    File file;
+    std::vector<uint32_t> symbolEnds;
+    std::string symbolText;
+    readArray(data, file.lhsOperands, header[2]);
+    readArray(data, file.rhsOperands, header[2]);
+    readArray(data, file.extraOperands, header[3]);
+    readArray(data, file.funcList, header[5]);
+    readArray(data, file.statementList, header[6]);
+    readArray(data, symbolEnds, header[7]);
+    readArray(data, file.kinds, header[2]);
+    readArray(data, file.textData, header[4]);
+    readArray(data, symbolText, header[8]);
+    if (!data.empty()) throw FormatException("AST data has " + std::to_string(data.size()) + " trailing bytes.");
+
+    std::vector<Symbol> symbols;
+    uint32_t start = 0;
+    for (const uint32_t end : symbolEnds) {
+        if (end < start || end > symbolText.size()) throw FormatException("AST data has a malformed symbol table.");
+
+        symbols.push_back(Symbols::intern(std::experimental::string_view(symbolText.data() + start, end - start)));
+        start = end;
+    }
+
+    for (size_t node = 0; node < file.kinds.size(); ++node) {
+        if (file.kinds[node] > IDENTIFIER_EXPR) {
+            throw FormatException("AST data has a node of unknown kind " + std::to_string(file.kinds[node]) + ".");
+        }
+        if (!namesSymbol(file.kinds[node])) continue;
+
+        if (file.lhsOperands[node] >= symbols.size()) throw FormatException("AST data names an unknown symbol.");
+        file.lhsOperands[node] = symbols[file.lhsOperands[node]];
+    }
+
+    file.validate();
+    return file;
+}
+
+// Throws a FormatException unless every node refers only to nodes, extra operands and text which exist, in the order
+// the nodes of a File are stored in. Passes can then walk a File read from anywhere without checking it themselves.
+void FlatAST::File::validate() const {
+    // Top-level elements are stored one after another, the extern declarations first.
+    std::vector<Node> roots = this->funcList;
+    roots.insert(roots.end(), this->statementList.begin(), this->statementList.end());
+    for (size_t i = 0; i < roots.size(); ++i) {
+        if (roots[i] >= this->kinds.size()) throw FormatException("AST data has a top-level node out of range.");
+        if (i != 0 && roots[i] <= roots[i - 1]) throw FormatException("AST data has top-level nodes out of order.");
+
+        const Kind kind = this->kinds[roots[i]];
+        if (i < this->funcList.size() ? kind != FUNCTION : kind != STATEMENT_EXPRESSION && kind != STATEMENT_LET) {
+            throw FormatException("AST data has a top-level node of kind " + std::to_string(kind) + ".");
+        }
+    }
+
+    size_t root = 0;
+    Node start = 0; // First node of the top-level element being checked.
+    for (Node node = 0; node < this->kinds.size(); ++node) {
+        // Children come before their parents. The values of expressions are only kept for the element being generated,
+        // so an expression must also be in the same element as its parent, whereas types can be shared.
+        const auto checkChild = [this, node, start](const uint32_t child, bool (*allowed)(Kind)) {
+            if (child >= node) throw FormatException("AST data has a node whose child does not come before it.");
+            if (!allowed(this->kinds[child])) {
+                throw FormatException("AST data has a child node of kind " + std::to_string(this->kinds[child]) + ".");
+            }
+            if (isExpression(this->kinds[child]) && child < start) {
+                throw FormatException("AST data has an expression used outside of its top-level element.");
+            }
+        };
+        const auto checkExtra = [this](const uint32_t index, const size_t count) {
+            if (index > this->extraOperands.size() || count > this->extraOperands.size() - index) {
+                throw FormatException("AST data has operands out of range of extra.");
+            }
+        };
+        const auto checkList = [this, &checkChild, &checkExtra](const uint32_t index, bool (*allowed)(Kind)) {
+            checkExtra(index, 1);
+            checkExtra(index + 1, this->extraOperands[index]);
+            for (const Node child : this->list(index)) checkChild(child, allowed);
+        };
+
+        const uint32_t lhs = this->lhsOperands[node];
+        const uint32_t rhs = this->rhsOperands[node];
+        switch (this->kinds[node]) {
+            case ADD_OP:
+            case SUB_OP:
+            case MUL_OP:
+            case DIV_OP:
+                checkChild(lhs, isExpression);
+                checkChild(rhs, isExpression);
+                break;
+            case FUNCTION_PROTOTYPE:
+                checkChild(lhs, isType);
+                checkList(rhs, isType);
+                break;
+            case FUNCTION:
+                checkChild(rhs, [](const Kind kind) { return kind == FUNCTION_PROTOTYPE; });
+                break;
+            case STATEMENT_EXPRESSION:
+                checkChild(lhs, isExpression);
+                break;
+            case STATEMENT_LET:
+                checkExtra(rhs, 2);
+                checkChild(this->extraOperands[rhs], isType);
+                checkChild(this->extraOperands[rhs + 1], isExpression);
+                break;
+            case STRING_LITERAL:
+                if (lhs > this->textData.size() || rhs > this->textData.size() - lhs) {
+                    throw FormatException("AST data has a string literal out of range of its text.");
+                }
+                break;
+            case FUNCTION_CALL:
+                checkList(rhs, isExpression);
+                break;
+            default:
+                break;
+        }
+
+        if (root < roots.size() && node == roots[root]) {
+            start = node + 1;
+            ++root;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef SANITY_FLAT_AST_H
+#define SANITY_FLAT_AST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <experimental/string_view>
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+/**
+ * Flat form of the abstract syntax tree, in which every node is an index into parallel arrays of its kind and two
+ * operands rather than an object linked to its children by pointers. Nodes are stored in post-order, with every node
+ * after its children and every top-level element right after the one before it, so passes which only need to see
+ * children before their parents can walk the arrays front to back.
+ */
+namespace FlatAST {
+    typedef uint32_t Node;
+
+    // Version of the binary format written by File::write(). It must be bumped whenever the format or the meaning of
+    // any Kind changes, so stale cached Files are rejected rather than misread.
+    const uint32_t FORMAT_VERSION = 1;
+
+    // Kinds of node, along with what their operands hold. A list in extra is stored as its size followed by its Nodes.
+    enum Kind : uint8_t {
+        ADD_OP, // lhs: left expression, rhs: right expression
+        SUB_OP, // lhs: left expression, rhs: right expression
+        MUL_OP, // lhs: left expression, rhs: right expression
+        DIV_OP, // lhs: left expression, rhs: right expression
+        INTEGER_TYPE,
+        STRING_TYPE,
+        FUNCTION_PROTOTYPE, // lhs: return type, rhs: index in extra of the list of parameter types
+        FUNCTION, // lhs: name, rhs: prototype
+        STATEMENT_EXPRESSION, // lhs: expression
+        STATEMENT_LET, // lhs: name, rhs: index in extra of the type followed by the expression
+        CHAR_LITERAL, // lhs: character
+        INTEGER_LITERAL, // lhs: value
+        STRING_LITERAL, // lhs: offset in text, rhs: length
+        FUNCTION_CALL, // lhs: callee, rhs: index in extra of the list of arguments
+        IDENTIFIER_EXPR, // lhs: name
+    };
+
+    /**
+     * Returns whether nodes of the given kind are expressions, which have a value.
+     */
+    bool isExpression(Kind kind);
+
+    /**
+     * View of a list of Nodes held in a File.
+     */
+    class NodeList {
+    private:
+        const Node* nodes;
+        size_t count;
+
+    public:
+        NodeList(const Node* nodes, const size_t count) : nodes(nodes), count(count) { }
+
+        size_t size() const {
+            return this->count;
+        }
+
+        Node operator[](const size_t index) const {
+            return this->nodes[index];
+        }
+
+        const Node* begin() const {
+            return this->nodes;
+        }
+
+        const Node* end() const {
+            return this->nodes + this->count;
+        }
+    };
+
+    class Builder;
+
+    /**
+     * Extern declarations and statements of a source file, along with all of their nodes.
+     */
+    class File {
+        friend class Builder;
+
+    private:
+        std::vector<Kind> kinds;
+        std::vector<uint32_t> lhsOperands;
+        std::vector<uint32_t> rhsOperands;
+        std::vector<uint32_t> extraOperands;
+        std::string textData;
+        std::vector<Node> funcList;
+        std::vector<Node> statementList;
+
+        void print(llvm::raw_ostream& stream, Node node) const;
+        void printExpression(llvm::raw_ostream& stream, Node root) const;
+        void printList(llvm::raw_ostream& stream, uint32_t index) const;
+        void validate() const;
+
+    public:
+        size_t size() const {
+            return this->kinds.size();
+        }
+
+        Kind kind(const Node node) const {
+            return this->kinds[node];
+        }
+
+        uint32_t lhs(const Node node) const {
+            return this->lhsOperands[node];
+        }
+
+        uint32_t rhs(const Node node) const {
+            return this->rhsOperands[node];
+        }
+
+        uint32_t extra(const uint32_t index) const {
+            return this->extraOperands[index];
+        }
+
+        /**
+         * Returns the list of Nodes stored at the given index in extra.
+         */
+        NodeList list(const uint32_t index) const {
+            return NodeList(&this->extraOperands[index] + 1, this->extraOperands[index]);
+        }
+
+        /**
+         * Returns the value of the given STRING_LITERAL.
+         */
+        std::experimental::string_view text(const Node node) const {
+            return std::experimental::string_view(this->textData).substr(this->lhs(node), this->rhs(node));
+        }
+
+        // FUNCTION Nodes of the extern declarations, in order.
+        const std::vector<Node>& funcs() const {
+            return this->funcList;
+        }
+
+        // Statement Nodes, in order.
+        const std::vector<Node>& statements() const {
+            return this->statementList;
+        }
+
+        /**
+         * Returns the number of bytes of memory held by the File.
+         */
+        size_t bytes() const;
+
+        /**
+         * Prints the File in the same form as the AST::File it was flattened from.
+         */
+        void print(llvm::raw_ostream& stream) const;
+
+        /**
+         * Writes the File in a compact binary format which read() loads back, so a parsed file can be cached and
+         * compiled later without lexing or parsing its source again.
+         */
+        void write(llvm::raw_ostream& stream) const;
+
+        /**
+         * Loads a File written by write(), such as from a memory-mapped file. The arrays are copied out in bulk, then
+         * every node is checked to refer only to children, extra operands and text which exist, and the nodes which
+         * name a Symbol have their names interned in this process.
+         * @throws FormatException if the data is truncated, malformed or written in another version of the format.
+         */
+        static File read(std::experimental::string_view data);
+    };
+
+    /**
+     * Appends nodes to a File. Each node must be added after its children.
+     */
+    class Builder {
+    private:
+        File file;
+
+    public:
+        Node add(Kind kind, uint32_t lhs = 0, uint32_t rhs = 0);
+
+        /**
+         * Appends the given operands to extra, returning the index of the first one.
+         */
+        uint32_t extra(std::initializer_list<uint32_t> operands);
+
+        /**
+         * Appends a list of the given Nodes to extra, returning its index.
+         */
+        uint32_t list(const std::vector<Node>& nodes);
+
+        /**
+         * Appends the given text, returning its offset.
+         */
+        uint32_t text(std::experimental::string_view text);
+
+        void func(Node func);
+        void statement(Node statement);
+
+        /**
+         * Returns the File built so far, leaving the Builder empty.
+         */
+        File finish();
+    };
+};
+
+#endif //SANITY_FLAT_AST_H
\ No newline at end of file
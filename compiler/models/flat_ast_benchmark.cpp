@@ -0,0 +1,86 @@
+#include <gflags/gflags.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "ast.h"
+#include "compilation_session.h"
+#include "flat_ast.h"
+#include "symbol.h"
+#include "token_list.h"
+#include "compiler/generator/generator.h"
+#include "compiler/lexer/lexer.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+#include "llvm/Support/raw_ostream.h"
+
+DEFINE_int32(nodes, 1000000, "Approximate number of AST nodes in the generated source.");
+DEFINE_int32(runs, 3, "Number of times to traverse each AST, keeping the fastest.");
+
+// Generates a source which parses to at least the given number of nodes.
+std::string generateSource(const size_t nodes) {
+    std::string source = "extern putchar: (int) -> int;\nlet v0: int = 1;\n";
+    size_t count = 7;
+    for (size_t i = 1; count < nodes; ++i) {
+        const std::string a = "v" + std::to_string(i / 2);
+        const std::string b = "v" + std::to_string(i / 3);
+        const std::string c = "v" + std::to_string(i - 1);
+        source += "let v" + std::to_string(i) + ": int = " + a + " * (" + b + " + 42) - " + c + " / 7;\n";
+        count += 11;
+        if (i % 8 == 0) {
+            source += "putchar(v" + std::to_string(i) + ");\n";
+            count += 3;
+        }
+    }
+    return source;
+}
+
+// Returns the fastest time, in seconds, taken by the given traversal over the given number of runs.
+template <typename Traverse>
+double fastest(const int runs, Traverse traverse) {
+    double best = 0;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        traverse();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+// Generates the given File into a new session.
+template <typename File>
+void generate(const File& file) {
+    CompilationSession session("Benchmark");
+    Generator::gen(session, file);
+}
+
+// Measures printing and generating the same source from the pointer tree and from the flat AST.
+int main(int argc, char* argv[]) {
+    gflags::SetUsageMessage("Benchmarks traversing a generated source as an AST tree and as a flat AST.");
+    gflags::ParseCommandLineFlags(&argc, &argv, true /* remove flags from argv */);
+
+    const std::string source = generateSource((size_t) FLAGS_nodes);
+    const TokenList tokens = Lexer::tokenize(source);
+    Arena arena;
+    const AST::File* tree = Parser::parse(tokens, arena);
+    const FlatAST::File flat = tree->flatten();
+
+    llvm::raw_null_ostream null;
+    const double treePrint = fastest(FLAGS_runs, [&null, tree]() { tree->print(null); });
+    const double flatPrint = fastest(FLAGS_runs, [&null, &flat]() { flat.print(null); });
+    const double treeGenerate = fastest(FLAGS_runs, [tree]() { generate(*tree); });
+    const double flatGenerate = fastest(FLAGS_runs, [&flat]() { generate(flat); });
+
+    const double nodes = (double) flat.size();
+    const size_t treeBytes = arena.slabCount() * Arena::SLAB_SIZE;
+    std::printf("%zu nodes\n\n", flat.size());
+    std::printf("%-6s %12s %14s %14s %10s\n", "ast", "bytes", "print seconds", "gen seconds", "bytes/node");
+    std::printf("%-6s %12zu %14.4f %14.4f %10.2f\n", "tree", treeBytes, treePrint, treeGenerate, treeBytes / nodes);
+    std::printf("%-6s %12zu %14.4f %14.4f %10.2f\n", "flat", flat.bytes(), flatPrint, flatGenerate,
+        flat.bytes() / nodes);
+
+    return 0;
+}
\ No newline at end of file
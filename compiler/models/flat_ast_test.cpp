@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "flat_ast.h"
+#include "exceptions.h"
+#include "symbol.h"
+#include "compiler/utils/arena.h"
+#include "llvm/Support/raw_ostream.h"
+
+typedef Exceptions::FormatException FormatException;
+
+TEST(FlatAST, StoresChildrenBeforeParents) {
+    FlatAST::Builder builder;
+    const FlatAST::Node left = builder.add(FlatAST::INTEGER_LITERAL, 1);
+    const FlatAST::Node right = builder.add(FlatAST::INTEGER_LITERAL, 2);
+    const FlatAST::Node addition = builder.add(FlatAST::ADD_OP, left, right);
+    builder.statement(builder.add(FlatAST::STATEMENT_EXPRESSION, addition));
+
+    const FlatAST::File file = builder.finish();
+
+    ASSERT_EQ(4, file.size());
+    ASSERT_EQ(FlatAST::ADD_OP, file.kind(2));
+    ASSERT_EQ(0, file.lhs(2));
+    ASSERT_EQ(1, file.rhs(2));
+    ASSERT_EQ(std::vector<FlatAST::Node>({ 3 }), file.statements());
+}
+
+TEST(FlatAST, StoresListsAndText) {
+    FlatAST::Builder builder;
+    const FlatAST::Node arg1 = builder.add(FlatAST::CHAR_LITERAL, 'a');
+    const FlatAST::Node arg2 = builder.add(FlatAST::STRING_LITERAL, builder.text("abc123"), 6);
+    const FlatAST::Node call = builder.add(FlatAST::FUNCTION_CALL, Symbols::intern("test"), builder.list({ arg1, arg2 }));
+
+    const FlatAST::File file = builder.finish();
+
+    const FlatAST::NodeList args = file.list(file.rhs(call));
+    ASSERT_EQ(2, args.size());
+    ASSERT_EQ(arg1, args[0]);
+    ASSERT_EQ(arg2, args[1]);
+    ASSERT_EQ("abc123", file.text(arg2).to_string());
+}
+
+TEST(FlatAST, LeavesBuilderEmptyOnFinish) {
+    FlatAST::Builder builder;
+    builder.add(FlatAST::INTEGER_TYPE);
+    builder.finish();
+
+    ASSERT_EQ(0, builder.finish().size());
+}
+
+TEST(FlatAST, FlattensAndPrintsLikeTree) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const AST::StringType string;
+    const AST::FunctionPrototype proto(arena.list(std::vector<const AST::Type*>({ &integer, &string })), &integer);
+    const AST::Function func(Symbols::intern("test"), &proto);
+
+    const AST::IntegerLiteral one(1);
+    const AST::IntegerLiteral two(-2);
+    const AST::IdentifierExpr foo(Symbols::intern("foo"));
+    const AST::MulOpExpression multiplication(&two, &foo);
+    const AST::SubOpExpression subtraction(&one, &multiplication);
+    const AST::StatementLet let(Symbols::intern("bar"), &integer, &subtraction);
+
+    const AST::CharLiteral character('a');
+    const AST::StringLiteral text("Hello");
+    const AST::FunctionCall call(Symbols::intern("test"),
+        arena.list(std::vector<const AST::Expression*>({ &character, &text })));
+    const AST::StatementExpression stmt(&call);
+
+    const AST::File tree(arena.list(std::vector<const AST::Function*>({ &func })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &stmt })));
+    const FlatAST::File file = tree.flatten();
+
+    std::string treeStr;
+    llvm::raw_string_ostream treeStream(treeStr);
+    tree.print(treeStream);
+    std::string flatStr;
+    llvm::raw_string_ostream flatStream(flatStr);
+    file.print(flatStream);
+    ASSERT_EQ(treeStream.str(), flatStream.str());
+
+    ASSERT_EQ(1, file.funcs().size());
+    ASSERT_EQ(2, file.statements().size());
+    ASSERT_EQ(file.size() - 1, file.statements().back());
+    ASSERT_LT(file.funcs().back(), file.statements().front());
+}
+
+// Returns a File of each kind of node which needs more than its kind to be stored.
+FlatAST::File sampleFile() {
+    FlatAST::Builder builder;
+    const FlatAST::Node integer = builder.add(FlatAST::INTEGER_TYPE);
+    const FlatAST::Node proto = builder.add(FlatAST::FUNCTION_PROTOTYPE, integer, builder.list({ integer }));
+    builder.func(builder.add(FlatAST::FUNCTION, Symbols::intern("serialized"), proto));
+
+    const FlatAST::Node character = builder.add(FlatAST::CHAR_LITERAL, 'a');
+    const FlatAST::Node text = builder.add(FlatAST::STRING_LITERAL, builder.text("Hello"), 5);
+    const FlatAST::Node call = builder.add(FlatAST::FUNCTION_CALL, Symbols::intern("serialized"),
+        builder.list({ character, text }));
+    const FlatAST::Node name = builder.add(FlatAST::IDENTIFIER_EXPR, Symbols::intern("name"));
+    const FlatAST::Node addition = builder.add(FlatAST::ADD_OP, call, name);
+    const uint32_t operands = builder.extra({ integer, addition });
+    builder.statement(builder.add(FlatAST::STATEMENT_LET, Symbols::intern("result"), operands));
+
+    return builder.finish();
+}
+
+std::string write(const FlatAST::File& file) {
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file.write(ss);
+    return ss.str();
+}
+
+std::string print(const FlatAST::File& file) {
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file.print(ss);
+    return ss.str();
+}
+
+TEST(FlatAST, ReadsBackWrittenFile) {
+    const FlatAST::File file = sampleFile();
+
+    const FlatAST::File read = FlatAST::File::read(write(file));
+
+    ASSERT_EQ(file.size(), read.size());
+    ASSERT_EQ(print(file), print(read));
+    ASSERT_EQ(file.funcs(), read.funcs());
+    ASSERT_EQ(file.statements(), read.statements());
+    ASSERT_EQ(Symbols::intern("result"), read.lhs(read.statements()[0]));
+    ASSERT_EQ(0, FlatAST::File::read(write(FlatAST::File())).size());
+}
+
+TEST(FlatAST, FlattensAndPrintsDeeplyNestedExpressionsWithoutRecursion) {
+    Arena arena;
+    const AST::Expression* expr = arena.make<AST::IntegerLiteral>(0);
+    for (int i = 1; i < 100000; ++i) {
+        expr = i % 2 == 0
+            ? (const AST::Expression*) arena.make<AST::SubOpExpression>(expr, arena.make<AST::IntegerLiteral>(i))
+            : arena.make<AST::FunctionCall>(Symbols::intern("nested"),
+                arena.list(std::vector<const AST::Expression*>({ expr })));
+    }
+    const AST::StatementExpression stmt(expr);
+    const AST::File tree(ArenaList<const AST::Function*>(), arena.list(std::vector<const AST::Statement*>({ &stmt })));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    tree.print(ss);
+    ASSERT_EQ(ss.str(), print(tree.flatten()));
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingMalformedData) {
+    const std::string data = write(sampleFile());
+    std::string otherVersion = data;
+    otherVersion[4] = (char) (FlatAST::FORMAT_VERSION + 1);
+    std::string unknownSymbol = data;
+    unknownSymbol[9 * 4 + 2 * 4] = 100; // Name of the extern declaration, the third node.
+
+    ASSERT_THROW(FlatAST::File::read("SAS"), FormatException);
+    ASSERT_THROW(FlatAST::File::read("XAST" + data.substr(4)), FormatException);
+    ASSERT_THROW(FlatAST::File::read(otherVersion), FormatException);
+    ASSERT_THROW(FlatAST::File::read(data.substr(0, data.size() - 1)), FormatException);
+    ASSERT_THROW(FlatAST::File::read(data + " "), FormatException);
+    ASSERT_THROW(FlatAST::File::read(unknownSymbol), FormatException);
+}
+
+// Writes out and reads back the File being built, which may be malformed as a Builder does not check what it is given.
+FlatAST::File readBack(FlatAST::Builder& builder) {
+    return FlatAST::File::read(write(builder.finish()));
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingChildNotBeforeParent) {
+    FlatAST::Builder forward;
+    const FlatAST::Node literal = forward.add(FlatAST::INTEGER_LITERAL, 1);
+    forward.statement(forward.add(FlatAST::STATEMENT_EXPRESSION, literal + 2));
+    forward.add(FlatAST::INTEGER_LITERAL, 2);
+    FlatAST::Builder self;
+    const FlatAST::Node addition = self.add(FlatAST::ADD_OP, self.add(FlatAST::INTEGER_LITERAL, 1), 1);
+    self.statement(self.add(FlatAST::STATEMENT_EXPRESSION, addition));
+
+    ASSERT_THROW(readBack(forward), FormatException);
+    ASSERT_THROW(readBack(self), FormatException);
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingChildOfWrongKind) {
+    FlatAST::Builder typeAsValue;
+    const FlatAST::Node integer = typeAsValue.add(FlatAST::INTEGER_TYPE);
+    typeAsValue.statement(typeAsValue.add(FlatAST::STATEMENT_EXPRESSION, integer));
+    FlatAST::Builder sharedValue;
+    const FlatAST::Node literal = sharedValue.add(FlatAST::INTEGER_LITERAL, 1);
+    sharedValue.statement(sharedValue.add(FlatAST::STATEMENT_EXPRESSION, literal));
+    sharedValue.statement(sharedValue.add(FlatAST::STATEMENT_EXPRESSION, literal));
+
+    ASSERT_THROW(readBack(typeAsValue), FormatException);
+    ASSERT_THROW(readBack(sharedValue), FormatException);
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingExtraOutOfRange) {
+    FlatAST::Builder listIndex;
+    listIndex.statement(listIndex.add(FlatAST::STATEMENT_EXPRESSION,
+        listIndex.add(FlatAST::FUNCTION_CALL, Symbols::intern("test"), 100)));
+    FlatAST::Builder listCount;
+    const FlatAST::Node literal = listCount.add(FlatAST::INTEGER_LITERAL, 1);
+    const uint32_t args = listCount.extra({ 2, literal });
+    listCount.statement(listCount.add(FlatAST::STATEMENT_EXPRESSION,
+        listCount.add(FlatAST::FUNCTION_CALL, Symbols::intern("test"), args)));
+    FlatAST::Builder letOperands;
+    const FlatAST::Node integer = letOperands.add(FlatAST::INTEGER_TYPE);
+    const uint32_t operands = letOperands.extra({ integer });
+    letOperands.statement(letOperands.add(FlatAST::STATEMENT_LET, Symbols::intern("test"), operands));
+
+    ASSERT_THROW(readBack(listIndex), FormatException);
+    ASSERT_THROW(readBack(listCount), FormatException);
+    ASSERT_THROW(readBack(letOperands), FormatException);
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingTextOutOfRange) {
+    FlatAST::Builder length;
+    length.statement(length.add(FlatAST::STATEMENT_EXPRESSION,
+        length.add(FlatAST::STRING_LITERAL, length.text("Hi"), 3)));
+    FlatAST::Builder offset;
+    offset.text("Hi");
+    offset.statement(offset.add(FlatAST::STATEMENT_EXPRESSION, offset.add(FlatAST::STRING_LITERAL, 3, 0)));
+
+    ASSERT_THROW(readBack(length), FormatException);
+    ASSERT_THROW(readBack(offset), FormatException);
+}
+
+TEST(FlatAST, ThrowsFormatExceptionReadingRootsOutOfOrder) {
+    FlatAST::Builder statements;
+    const FlatAST::Node first = statements.add(FlatAST::STATEMENT_EXPRESSION,
+        statements.add(FlatAST::INTEGER_LITERAL, 1));
+    const FlatAST::Node second = statements.add(FlatAST::STATEMENT_EXPRESSION,
+        statements.add(FlatAST::INTEGER_LITERAL, 2));
+    statements.statement(second);
+    statements.statement(first);
+    FlatAST::Builder funcAfterStatement;
+    funcAfterStatement.statement(funcAfterStatement.add(FlatAST::STATEMENT_EXPRESSION,
+        funcAfterStatement.add(FlatAST::INTEGER_LITERAL, 1)));
+    const FlatAST::Node integer = funcAfterStatement.add(FlatAST::INTEGER_TYPE);
+    const FlatAST::Node proto = funcAfterStatement.add(FlatAST::FUNCTION_PROTOTYPE, integer,
+        funcAfterStatement.list({ }));
+    funcAfterStatement.func(funcAfterStatement.add(FlatAST::FUNCTION, Symbols::intern("test"), proto));
+    FlatAST::Builder wrongKind;
+    wrongKind.statement(wrongKind.add(FlatAST::INTEGER_LITERAL, 1));
+
+    ASSERT_THROW(readBack(statements), FormatException);
+    ASSERT_THROW(readBack(funcAfterStatement), FormatException);
+    ASSERT_THROW(readBack(wrongKind), FormatException);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "line_table.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <experimental/string_view>
+
+LineTable::LineTable(const std::experimental::string_view source) : lineStarts({ 0 }) {
+    const char* const begin = source.data();
+    const char* const end = begin + source.size();
+    for (const char* c = begin; c != end; ++c) {
+        c = (const char*) std::memchr(c, '\n', (size_t) (end - c));
+        if (!c) break;
+        this->lineStarts.push_back((uint32_t) (c - begin + 1));
+    }
+}
+
+LineTable::LineTable(std::vector<uint32_t> lineStarts) : lineStarts(std::move(lineStarts)) { }
+
+int LineTable::line(const uint32_t offset) const {
+    // Find the last line starting at or before the offset.
+    return (int) (std::upper_bound(this->lineStarts.begin(), this->lineStarts.end(), offset)
+        - this->lineStarts.begin());
+}
+
+int LineTable::column(const uint32_t offset) const {
+    return (int) (offset - this->lineStarts[this->line(offset) - 1] + 1);
+}
+
+Location LineTable::locate(const uint32_t offset, const uint32_t length) const {
+    const int startCol = this->column(offset);
+    return Location{this->line(offset), startCol, startCol + (int) length};
+}
\ No newline at end of file
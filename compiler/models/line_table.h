@@ -0,0 +1,55 @@
+#ifndef SANITY_LINE_TABLE_H
+#define SANITY_LINE_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include <experimental/string_view>
+
+/**
+ * Line and column numbers of a range of source text. Both are 1-based, and the end column is exclusive.
+ */
+class Location {
+public:
+    const int line;
+    const int startCol;
+    const int endCol;
+};
+
+/**
+ * Table of the offsets at which each line of a source starts. Building it is a single pass over the source, after which
+ * the line and column of any offset can be found with a binary search, so positions only need to be tracked as byte
+ * offsets until a line or column is actually needed.
+ */
+class LineTable {
+private:
+    std::vector<uint32_t> lineStarts;
+
+public:
+    /**
+     * Builds the table by finding every newline in the given source.
+     */
+    explicit LineTable(std::experimental::string_view source);
+
+    /**
+     * Builds the table from the offsets at which each line starts, in increasing order. The first line must start at
+     * offset 0.
+     */
+    explicit LineTable(std::vector<uint32_t> lineStarts);
+
+    /**
+     * Returns the line the given offset is on.
+     */
+    int line(uint32_t offset) const;
+
+    /**
+     * Returns the column of the given offset within its line.
+     */
+    int column(uint32_t offset) const;
+
+    /**
+     * Returns the location of the given range of source, which must not span multiple lines.
+     */
+    Location locate(uint32_t offset, uint32_t length) const;
+};
+
+#endif //SANITY_LINE_TABLE_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "line_table.h"
+
+TEST(LineTable, FindsLinesOfOffsets) {
+    const LineTable lines("ab\ncd\n\nef");
+
+    ASSERT_EQ(1, lines.line(0));
+    ASSERT_EQ(1, lines.line(2)); // The newline itself is on the line it ends.
+    ASSERT_EQ(2, lines.line(3));
+    ASSERT_EQ(3, lines.line(6));
+    ASSERT_EQ(4, lines.line(7));
+    ASSERT_EQ(4, lines.line(9)); // End of the source.
+}
+
+TEST(LineTable, FindsColumnsOfOffsets) {
+    const LineTable lines("ab\ncd\n\nef");
+
+    ASSERT_EQ(1, lines.column(0));
+    ASSERT_EQ(2, lines.column(1));
+    ASSERT_EQ(1, lines.column(3));
+    ASSERT_EQ(2, lines.column(4));
+    ASSERT_EQ(1, lines.column(6));
+    ASSERT_EQ(3, lines.column(9));
+}
+
+TEST(LineTable, LocatesRanges) {
+    const LineTable lines("foo\n  bar");
+    const Location location = lines.locate(6, 3);
+
+    ASSERT_EQ(2, location.line);
+    ASSERT_EQ(3, location.startCol);
+    ASSERT_EQ(6, location.endCol);
+}
+
+TEST(LineTable, BuildsFromLineStarts) {
+    const LineTable lines(std::vector<uint32_t>({ 0, 3, 6 }));
+
+    ASSERT_EQ(2, lines.line(4));
+    ASSERT_EQ(2, lines.column(4));
+}
\ No newline at end of file
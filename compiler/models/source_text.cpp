@@ -0,0 +1,67 @@
+#include "source_text.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "line_table.h"
+#include "token.h"
+
+SourceText::SourceText(const std::experimental::string_view source) : source(source) { }
+
+std::experimental::string_view SourceText::text(const Token& token) const {
+    return this->source.substr(token.offset, token.length);
+}
+
+char SourceText::charValue(const Token& token) const {
+    // Skip the opening quote, and resolve the escape sequence if there is one.
+    const char* literal = this->source.data() + token.offset + 1;
+    return literal[0] == '\\' ? unescape(literal[1]) : literal[0];
+}
+
+std::experimental::optional<int32_t> SourceText::integerValue(const Token& token) const {
+    // strtoll() saturates rather than throwing when a literal overflows even 64 bits, and sets errno instead.
+    const std::string text = this->text(token).to_string();
+    errno = 0;
+    const long long value = std::strtoll(text.c_str(), nullptr, 10);
+    if (errno == ERANGE || value > std::numeric_limits<int32_t>::max()) return std::experimental::nullopt;
+
+    return (int32_t) value;
+}
+
+std::string SourceText::stringValue(const Token& token) const {
+    // Strip the quotes.
+    const std::experimental::string_view literal = this->source.substr(token.offset + 1, token.length - 2);
+
+    // Most strings contain no escape sequences, and can be copied directly.
+    if (literal.find('\\') == std::experimental::string_view::npos) return literal.to_string();
+
+    std::string value;
+    value.reserve(literal.size());
+    for (size_t i = 0; i < literal.size(); ++i) {
+        value.push_back(literal[i] == '\\' ? unescape(literal[++i]) : literal[i]);
+    }
+
+    return value;
+}
+
+Location SourceText::location(const Token& token) const {
+    if (!this->lines) this->lines = std::make_shared<const LineTable>(this->source);
+
+    return this->lines->locate(token.offset, token.length);
+}
+
+char SourceText::unescape(const char controlChar) {
+    switch (controlChar) {
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 't': return '\t';
+        case '\'': return '\'';
+        case '\"': return '\"';
+        case '\\': return '\\';
+        default: return '\0';
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef SANITY_SOURCE_TEXT_H
+#define SANITY_SOURCE_TEXT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "line_table.h"
+#include "token.h"
+
+/**
+ * Source that Tokens were lexed from, used to look up the text, literal values and locations of those Tokens. The
+ * source is viewed rather than copied, so it must outlive the SourceText.
+ */
+class SourceText {
+private:
+    std::experimental::string_view source;
+    mutable std::shared_ptr<const LineTable> lines; // Only built once a location is requested.
+
+public:
+    explicit SourceText(std::experimental::string_view source);
+
+    /**
+     * Returns the source text of the given Token exactly as written, including the quotes of literals.
+     */
+    std::experimental::string_view text(const Token& token) const;
+
+    /**
+     * Returns the value of the given char literal Token, with its escape sequence (if any) resolved.
+     */
+    char charValue(const Token& token) const;
+
+    /**
+     * Returns the value of the given integer literal Token, or std::experimental::nullopt if it does not fit in 32 bits.
+     */
+    std::experimental::optional<int32_t> integerValue(const Token& token) const;
+
+    /**
+     * Returns the value of the given string literal Token, with its escape sequences resolved.
+     */
+    std::string stringValue(const Token& token) const;
+
+    /**
+     * Returns the line and columns of the given Token. The first call builds a LineTable of the entire source, so this
+     * is not safe to call from multiple threads at once.
+     */
+    Location location(const Token& token) const;
+
+    /**
+     * Returns the value of the given control char (the one that comes after the backslash, so the "n" in "\n") in an
+     * escape sequence, or '\0' if it is not a valid escape sequence.
+     */
+    static char unescape(char controlChar);
+};
+
+#endif //SANITY_SOURCE_TEXT_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "line_table.h"
+#include "source_text.h"
+#include "symbol.h"
+#include "token.h"
+
+TEST(SourceText, ReturnsTextOfTokens) {
+    const SourceText source("foo 'a'");
+
+    ASSERT_EQ("foo", source.text(Token{Token::IDENTIFIER, 0, 3, Symbols::intern("foo")}));
+    ASSERT_EQ("\'a\'", source.text(Token{Token::CHAR_LITERAL, 4, 3, Symbols::NONE}));
+}
+
+TEST(SourceText, ReturnsCharValues) {
+    const SourceText source(R"('a' '\n' '\'')");
+
+    ASSERT_EQ('a', source.charValue(Token{Token::CHAR_LITERAL, 0, 3, Symbols::NONE}));
+    ASSERT_EQ('\n', source.charValue(Token{Token::CHAR_LITERAL, 4, 4, Symbols::NONE}));
+    ASSERT_EQ('\'', source.charValue(Token{Token::CHAR_LITERAL, 9, 4, Symbols::NONE}));
+}
+
+TEST(SourceText, ReturnsIntegerValues) {
+    const SourceText source("1234");
+
+    ASSERT_EQ(1234, source.integerValue(Token{Token::INTEGER_LITERAL, 0, 4, Symbols::NONE}));
+}
+
+TEST(SourceText, ReturnsStringValues) {
+    const SourceText source(R"("abc" "a\tb\\" "")");
+
+    ASSERT_EQ("abc", source.stringValue(Token{Token::STRING_LITERAL, 0, 5, Symbols::NONE}));
+    ASSERT_EQ("a\tb\\", source.stringValue(Token{Token::STRING_LITERAL, 6, 8, Symbols::NONE}));
+    ASSERT_EQ("", source.stringValue(Token{Token::STRING_LITERAL, 15, 2, Symbols::NONE}));
+}
+
+TEST(SourceText, LocatesTokens) {
+    const SourceText source("foo\n  bar");
+
+    const Location location = source.location(Token{Token::IDENTIFIER, 6, 3, Symbols::intern("bar")});
+    ASSERT_EQ(2, location.line);
+    ASSERT_EQ(3, location.startCol);
+    ASSERT_EQ(6, location.endCol);
+}
+
+TEST(SourceText, Unescapes) {
+    ASSERT_EQ('\n', SourceText::unescape('n'));
+    ASSERT_EQ('\\', SourceText::unescape('\\'));
+    ASSERT_EQ('\0', SourceText::unescape('z'));
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "symbol.h"
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <experimental/string_view>
+#include "exceptions.h"
+
+typedef Exceptions::AssertionException AssertionException;
+
+namespace {
+    class SymbolTable {
+    private:
+        std::mutex mutex;
+        std::deque<std::string> names; // Deque so existing names are never moved and views of them stay valid.
+        std::unordered_map<std::experimental::string_view, Symbol> symbols;
+
+    public:
+        SymbolTable() {
+            // Must be interned in the same order as the constants in symbol.h.
+            if (this->intern("") != Symbols::NONE || this->intern("let") != Symbols::LET
+                    || this->intern("extern") != Symbols::EXTERN || this->intern("int") != Symbols::INT
+                    || this->intern("string") != Symbols::STRING) {
+                throw AssertionException("Keywords interned out of order.");
+            }
+        }
+
+        Symbol intern(const std::experimental::string_view name) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            const auto existing = this->symbols.find(name);
+            if (existing != this->symbols.end()) return existing->second;
+
+            const auto symbol = (Symbol) this->names.size();
+            this->names.emplace_back(name.data(), name.size());
+            this->symbols.emplace(this->names.back(), symbol);
+            return symbol;
+        }
+
+        std::experimental::string_view name(const Symbol symbol) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            if (symbol >= this->names.size()) throw AssertionException("Unknown symbol: " + std::to_string(symbol));
+            return this->names[symbol];
+        }
+    };
+
+    SymbolTable& table() {
+        static SymbolTable table;
+        return table;
+    }
+}
+
+Symbol Symbols::intern(const std::experimental::string_view name) {
+    // Each thread caches the Symbols it has already seen, so threads lexing in parallel rarely contend on the table's
+    // lock. The cache is keyed by the table's own copies of the names, which are never freed.
+    thread_local std::unordered_map<std::experimental::string_view, Symbol> cache;
+
+    const auto cached = cache.find(name);
+    if (cached != cache.end()) return cached->second;
+
+    const Symbol symbol = table().intern(name);
+    cache.emplace(table().name(symbol), symbol);
+    return symbol;
+}
+
+std::experimental::string_view Symbols::name(const Symbol symbol) {
+    return table().name(symbol);
+}
\ No newline at end of file
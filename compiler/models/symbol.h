@@ -0,0 +1,38 @@
+#ifndef SANITY_SYMBOL_H
+#define SANITY_SYMBOL_H
+
+#include <cstdint>
+#include <experimental/string_view>
+
+/**
+ * Interned identifier. Two Symbols are equal if and only if the names they were interned from are equal, so names can
+ * be compared and hashed as integers.
+ */
+typedef uint32_t Symbol;
+
+/**
+ * Global table of interned Symbols, shared by the lexer, parser and generator. Symbols are never freed, so the names
+ * they refer to are valid for the lifetime of the process. Safe to use from multiple threads.
+ */
+namespace Symbols {
+    // Symbol of the empty name, used by Tokens which are not interned.
+    const Symbol NONE = 0;
+
+    // Keywords, interned up front so they can be used as constants.
+    const Symbol LET = 1;
+    const Symbol EXTERN = 2;
+    const Symbol INT = 3;
+    const Symbol STRING = 4;
+
+    /**
+     * Returns the Symbol for the given name, interning it if it has not been seen before.
+     */
+    Symbol intern(std::experimental::string_view name);
+
+    /**
+     * Returns the name the given Symbol was interned from.
+     */
+    std::experimental::string_view name(Symbol symbol);
+}
+
+#endif //SANITY_SYMBOL_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "symbol.h"
+
+TEST(Symbols, InternsKeywordsUpFront) {
+    ASSERT_EQ(Symbols::NONE, Symbols::intern(""));
+    ASSERT_EQ(Symbols::LET, Symbols::intern("let"));
+    ASSERT_EQ(Symbols::EXTERN, Symbols::intern("extern"));
+    ASSERT_EQ(Symbols::INT, Symbols::intern("int"));
+    ASSERT_EQ(Symbols::STRING, Symbols::intern("string"));
+}
+
+TEST(Symbols, InternsEqualNamesToTheSameSymbol) {
+    const std::string first = "foo";
+    const std::string second = "foo";
+
+    ASSERT_EQ(Symbols::intern(first), Symbols::intern(second));
+    ASSERT_NE(Symbols::intern("foo"), Symbols::intern("bar"));
+}
+
+TEST(Symbols, ReturnsNameOfSymbol) {
+    std::string name = "baz";
+    const Symbol symbol = Symbols::intern(name);
+    name = "changed"; // Symbol table should have its own copy.
+
+    ASSERT_EQ("baz", Symbols::name(symbol));
+}
+
+TEST(Symbols, InternsFromMultipleThreads) {
+    std::vector<Symbol> symbols(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        threads.emplace_back([&symbols, i]() {
+            for (int j = 0; j < 1000; ++j) Symbols::intern("thread" + std::to_string(j));
+            symbols[i] = Symbols::intern("shared");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (const Symbol symbol : symbols) ASSERT_EQ(symbols[0], symbol);
+    ASSERT_EQ("shared", Symbols::name(symbols[0]));
+}
\ No newline at end of file
@@ -1,12 +1,32 @@
 #include "compiler/models/token.h"
+#include <string>
+#include "compiler/models/exceptions.h"
 
-Token::Token(const std::string& source, const int line, const int startCol, const int endCol, const bool isCharLiteral,
-        const bool isIntegerLiteral, const bool isStringLiteral)
-    : source(source), line(line), startCol(startCol), endCol(endCol), isCharLiteral(isCharLiteral),
-        isIntegerLiteral(isIntegerLiteral), isStringLiteral(isStringLiteral) { }
+typedef Exceptions::AssertionException AssertionException;
 
-std::ostream& operator<<(std::ostream& stream, const Token& token) {
-    stream << token.source;
-    if (token.isCharLiteral) stream << std::string(" (char literal)");
-    return stream;
+const char* Token::describe(const Token::Kind kind) {
+    switch (kind) {
+        case IDENTIFIER: return "identifier";
+        case LET: return "let";
+        case EXTERN: return "extern";
+        case INT: return "int";
+        case STRING: return "string";
+        case CHAR_LITERAL: return "char literal";
+        case INTEGER_LITERAL: return "integer literal";
+        case STRING_LITERAL: return "string literal";
+        case LEFT_PAREN: return "(";
+        case RIGHT_PAREN: return ")";
+        case COMMA: return ",";
+        case COLON: return ":";
+        case SEMICOLON: return ";";
+        case EQUALS: return "=";
+        case PLUS: return "+";
+        case MINUS: return "-";
+        case STAR: return "*";
+        case SLASH: return "/";
+        case ARROW: return "->";
+        case PUNCTUATION: return "punctuation";
+    }
+
+    throw AssertionException("Unknown Token kind: " + std::to_string(kind));
 }
\ No newline at end of file
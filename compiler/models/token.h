@@ -1,26 +1,61 @@
 #ifndef SANITY_TOKEN_H
 #define SANITY_TOKEN_H
 
-#include <string>
+#include <cstdint>
+#include "symbol.h"
 
+/**
+ * A single lexed Token. Tokens only record what kind of Token they are and where they are in the source, so they are
+ * small enough to be passed by value and stored contiguously in a TokenList, which can look up their text, literal
+ * values and locations when they are needed.
+ * @see TokenList
+ */
 class Token {
 public:
-    const std::string source;
-    const int line;
-    const int startCol;
-    const int endCol;
-    const bool isCharLiteral;
-    const bool isIntegerLiteral;
-    const bool isStringLiteral;
+    enum Kind : uint8_t {
+        IDENTIFIER,
+
+        // Keywords
+        LET,
+        EXTERN,
+        INT,
+        STRING,
+
+        // Literals
+        CHAR_LITERAL,
+        INTEGER_LITERAL,
+        STRING_LITERAL,
+
+        // Punctuation
+        LEFT_PAREN,
+        RIGHT_PAREN,
+        COMMA,
+        COLON,
+        SEMICOLON,
+        EQUALS,
+        PLUS,
+        MINUS,
+        STAR,
+        SLASH,
+        ARROW,
+        PUNCTUATION, // Any other single character.
+    };
+
+    Kind kind;
+
+    // Byte offset of the Token in the source, including the quotes of char and string literals.
+    uint32_t offset;
+
+    // Number of bytes of source the Token spans, including the quotes of char and string literals.
+    uint32_t length;
+
+    // Interned text of identifiers and keywords, Symbols::NONE for every other kind of Token.
+    Symbol symbol;
 
     /**
-     * Construct a Token with the given values. This API kind of sucks, so use TokenBuilder instead.
-     * @see TokenBuilder
+     * Returns a human readable description of the given kind of Token, for use in error messages.
      */
-    Token(const std::string& source, int line, int startCol, int endCol, bool isCharLiteral, bool isIntegerLiteral,
-            bool isStringLiteral);
-
-    friend std::ostream& operator<<(std::ostream&, const Token&);
+    static const char* describe(Kind kind);
 };
 
-#endif //SANITY_TOKEN_H
+#endif //SANITY_TOKEN_H
\ No newline at end of file
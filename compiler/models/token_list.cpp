@@ -0,0 +1,8 @@
+#include "token_list.h"
+#include <vector>
+#include <experimental/string_view>
+#include "source_text.h"
+#include "token.h"
+
+TokenList::TokenList(const std::experimental::string_view source, std::vector<Token> tokens)
+    : SourceText(source), tokens(std::move(tokens)) { }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SANITY_TOKEN_LIST_H
+#define SANITY_TOKEN_LIST_H
+
+#include <vector>
+#include <experimental/string_view>
+#include "source_text.h"
+#include "token.h"
+
+/**
+ * Contiguous list of all the Tokens lexed from a single source, along with that source so the text, literal values and
+ * locations of the Tokens can be looked up. The source is viewed rather than copied, so it must outlive the TokenList.
+ */
+class TokenList : public SourceText {
+private:
+    std::vector<Token> tokens;
+
+public:
+    TokenList(std::experimental::string_view source, std::vector<Token> tokens);
+
+    size_t size() const {
+        return this->tokens.size();
+    }
+
+    bool empty() const {
+        return this->tokens.empty();
+    }
+
+    const Token& operator[](const size_t index) const {
+        return this->tokens[index];
+    }
+
+    const Token* data() const {
+        return this->tokens.data();
+    }
+
+    std::vector<Token>::const_iterator begin() const {
+        return this->tokens.begin();
+    }
+
+    std::vector<Token>::const_iterator end() const {
+        return this->tokens.end();
+    }
+};
+
+#endif //SANITY_TOKEN_LIST_H
\ No newline at end of file
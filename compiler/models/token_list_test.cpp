@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "symbol.h"
+#include "token.h"
+#include "token_list.h"
+
+TEST(TokenList, ReturnsTextOfTokens) {
+    const TokenList tokens("foo 'a'", {
+        Token{Token::IDENTIFIER, 0, 3, Symbols::intern("foo")},
+        Token{Token::CHAR_LITERAL, 4, 3, Symbols::NONE},
+    });
+
+    ASSERT_EQ(2, tokens.size());
+    ASSERT_EQ("foo", tokens.text(tokens[0]));
+    ASSERT_EQ("\'a\'", tokens.text(tokens[1]));
+}
+
+TEST(TokenList, IteratesTokensInOrder) {
+    const TokenList tokens("a b c", {
+        Token{Token::IDENTIFIER, 0, 1, Symbols::intern("a")},
+        Token{Token::IDENTIFIER, 2, 1, Symbols::intern("b")},
+        Token{Token::IDENTIFIER, 4, 1, Symbols::intern("c")},
+    });
+
+    std::vector<uint32_t> offsets;
+    for (const Token& token : tokens) offsets.push_back(token.offset);
+
+    ASSERT_EQ(std::vector<uint32_t>({ 0, 2, 4 }), offsets);
+}
\ No newline at end of file
@@ -1,51 +1,15 @@
 #include <gtest/gtest.h>
-#include <sstream>
+#include <string>
 #include "token.h"
-#include "token_builder.h"
 
-TEST(Token, SavesSourceText) {
-    const auto token = TokenBuilder("test").build();
-
-    ASSERT_EQ("test", token->source);
-}
-
-TEST(Token, PrintsSourceText) {
-    const auto token = TokenBuilder("test").build();
-    auto stream = std::ostringstream();
-
-    stream << *token;
-
-    ASSERT_EQ("test", stream.str());
-}
-
-TEST(Token, SavesLineAndColumnState) {
-    const auto token = TokenBuilder("a")
-        .setLine(1)
-        .setStartCol(2)
-        .setEndCol(3)
-    .build();
-
-    ASSERT_EQ(1, token->line);
-    ASSERT_EQ(2, token->startCol);
-    ASSERT_EQ(3, token->endCol);
-}
-
-TEST(Token, SavesCharLiteralState) {
-    const auto charToken = TokenBuilder("a")
-        .setCharLiteral(true)
-    .build();
-    ASSERT_TRUE(charToken->isCharLiteral);
-
-    const auto nonCharToken = TokenBuilder("test").build();
-    ASSERT_FALSE(nonCharToken->isCharLiteral);
+TEST(Token, FitsInFourWords) {
+    ASSERT_LE(sizeof(Token), 4 * sizeof(uint32_t));
 }
 
-TEST(Token, SavesIntegerLiteralState) {
-    const auto intToken = TokenBuilder("1234")
-        .setIntegerLiteral(true)
-    .build();
-    ASSERT_TRUE(intToken->isIntegerLiteral);
-
-    const auto nonIntToken = TokenBuilder("test").build();
-    ASSERT_FALSE(nonIntToken->isIntegerLiteral);
+TEST(Token, DescribesKinds) {
+    ASSERT_EQ(std::string("identifier"), Token::describe(Token::IDENTIFIER));
+    ASSERT_EQ(std::string("let"), Token::describe(Token::LET));
+    ASSERT_EQ(std::string("char literal"), Token::describe(Token::CHAR_LITERAL));
+    ASSERT_EQ(std::string(";"), Token::describe(Token::SEMICOLON));
+    ASSERT_EQ(std::string("->"), Token::describe(Token::ARROW));
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "optimizer.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include "compiler/models/exceptions.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+namespace {
+    // Code generation level of each optimization level.
+    const llvm::CodeGenOpt::Level CODE_GEN_LEVELS[] = {
+        llvm::CodeGenOpt::None, llvm::CodeGenOpt::Less, llvm::CodeGenOpt::Default, llvm::CodeGenOpt::Aggressive,
+    };
+
+    // Registering the host target is not safe to race with itself, so it is only done once whichever thread gets here.
+    std::once_flag hostInitialized;
+
+    void checkLevel(const unsigned level) {
+        if (level > Optimizer::MAX_LEVEL) {
+            throw IllegalStateException("Optimization level " + std::to_string(level) + " is not between 0 and "
+                + std::to_string(Optimizer::MAX_LEVEL) + ".");
+        }
+    }
+}
+
+std::unique_ptr<llvm::TargetMachine> Optimizer::hostMachine(const unsigned level) {
+    const llvm::CodeGenOpt::Level codeGen = codeGenLevel(level);
+
+    std::call_once(hostInitialized, []() {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+    });
+
+    const std::string triple = llvm::sys::getDefaultTargetTriple();
+    std::string error;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (!target) throw IllegalStateException("Cannot generate code for " + triple + ": " + error);
+
+    // Like llc, target a generic CPU of the host's architecture. Position-independent code links into both static and
+    // position-independent executables.
+    std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(triple, "generic", "" /* Features */,
+        llvm::TargetOptions(), llvm::Reloc::PIC_));
+    machine->setOptLevel(codeGen);
+    return machine;
+}
+
+void Optimizer::optimize(llvm::Module& module, llvm::TargetMachine& machine, const unsigned level) {
+    checkLevel(level);
+    module.setTargetTriple(machine.getTargetTriple().str());
+    module.setDataLayout(machine.createDataLayout());
+    if (level == 0) return;
+
+    // Configure the pipelines like clang does, which only inlines functions by their cost from -O2 upwards. The
+    // vectorizers and unrollers weigh instructions by the costs of the machine, and calls to the C library are only
+    // simplified when it is known to define them.
+    llvm::PassManagerBuilder pipeline;
+    pipeline.OptLevel = level;
+    pipeline.LibraryInfo = new llvm::TargetLibraryInfoImpl(llvm::Triple(module.getTargetTriple()));
+    pipeline.Inliner = level > 1
+        ? llvm::createFunctionInliningPass(level, 0 /* SizeOptLevel */) : llvm::createAlwaysInlinerPass();
+    pipeline.LoopVectorize = level > 1;
+    pipeline.SLPVectorize = level > 1;
+
+    // Simplify each function on its own first, then optimize the module as a whole.
+    llvm::legacy::FunctionPassManager functionPasses(&module);
+    functionPasses.add(llvm::createTargetTransformInfoWrapperPass(machine.getTargetIRAnalysis()));
+    pipeline.populateFunctionPassManager(functionPasses);
+    functionPasses.doInitialization();
+    for (llvm::Function& function : module) functionPasses.run(function);
+    functionPasses.doFinalization();
+
+    llvm::legacy::PassManager modulePasses;
+    modulePasses.add(llvm::createTargetTransformInfoWrapperPass(machine.getTargetIRAnalysis()));
+    pipeline.populateModulePassManager(modulePasses);
+    modulePasses.run(module);
+}
+
+llvm::CodeGenOpt::Level Optimizer::codeGenLevel(const unsigned level) {
+    checkLevel(level);
+    return CODE_GEN_LEVELS[level];
+}
\ No newline at end of file
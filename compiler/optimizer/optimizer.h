@@ -0,0 +1,41 @@
+#ifndef SANITY_OPTIMIZER_H
+#define SANITY_OPTIMIZER_H
+
+#include <memory>
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Target/TargetMachine.h"
+
+/**
+ * Runs LLVM's standard optimizations over the IR generated for a Sanity program, so the program performs like the
+ * equivalent C compiled at the same level.
+ */
+namespace Optimizer {
+    // Highest optimization level, as in -O3.
+    const unsigned MAX_LEVEL = 3;
+
+    /**
+     * Returns a TargetMachine generating code for a generic CPU of the host's architecture at the given level, from 0
+     * up to MAX_LEVEL, so the code it writes out runs on any other machine like it.
+     * @throws IllegalStateException if code cannot be generated for the host or the level is above MAX_LEVEL.
+     */
+    std::unique_ptr<llvm::TargetMachine> hostMachine(unsigned level);
+
+    /**
+     * Optimizes the given module in place at the given level, from 0 for no optimization up to MAX_LEVEL. Runs the same
+     * function and module pass pipelines as C compilers built on LLVM do at that level, which promote memory to
+     * registers, combine instructions, number values globally, inline functions and propagate constants among others.
+     * The module is retargeted at the given machine first, whose data layout, C library and costs of instructions the
+     * passes then optimize for, so the machine generating code for the module should be the same one.
+     * @throws IllegalStateException if the level is above MAX_LEVEL.
+     */
+    void optimize(llvm::Module& module, llvm::TargetMachine& machine, unsigned level);
+
+    /**
+     * Returns how hard to optimize machine code generated at the given level, from 0 up to MAX_LEVEL.
+     * @throws IllegalStateException if the level is above MAX_LEVEL.
+     */
+    llvm::CodeGenOpt::Level codeGenLevel(unsigned level);
+}
+
+#endif //SANITY_OPTIMIZER_H
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "optimizer.h"
+#include "compiler/generator/generator.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/symbol.h"
+#include "compiler/utils/arena.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+// Generates "let value: int = getchar(); putchar(value * 1 + 0); putchar(value * 1 + 0);" in the module of the given
+// session, outlining each statement into a chunk of its own, then optimizes it at the given level for the host and
+// returns the IR printed.
+std::string optimizeModule(CompilationSession& session, const unsigned level) {
+    Arena arena;
+    const AST::IntegerType integer;
+    const AST::FunctionPrototype getcharProto(ArenaList<const AST::Type*>(), &integer /* returnType */);
+    const AST::Function getchar(Symbols::intern("getchar"), &getcharProto);
+    const AST::FunctionPrototype putcharProto(arena.list(std::vector<const AST::Type*>({ &integer })), &integer);
+    const AST::Function putchar(Symbols::intern("putchar"), &putcharProto);
+
+    const AST::FunctionCall read(Symbols::intern("getchar"), ArenaList<const AST::Expression*>());
+    const AST::StatementLet let(Symbols::intern("value"), &integer, &read);
+    const AST::IdentifierExpr value(Symbols::intern("value"));
+    const AST::IntegerLiteral zero(0);
+    const AST::IntegerLiteral one(1);
+    const AST::MulOpExpression product(&value, &one);
+    const AST::AddOpExpression sum(&product, &zero);
+    const AST::FunctionCall write(Symbols::intern("putchar"), arena.list(std::vector<const AST::Expression*>({ &sum })));
+    const AST::StatementExpression stmt(&write);
+
+    const AST::File file(arena.list(std::vector<const AST::Function*>({ &getchar, &putchar })),
+        arena.list(std::vector<const AST::Statement*>({ &let, &stmt, &stmt })));
+    Generator generator(session);
+    generator.outline(1);
+    generator.generate(file);
+
+    Optimizer::optimize(*session.module, *Optimizer::hostMachine(level), level);
+    EXPECT_FALSE(llvm::verifyModule(*session.module, &llvm::errs()));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    session.module->print(ss, nullptr);
+    return ss.str();
+}
+
+TEST(Optimizer, LeavesModuleUnchangedAtLevelZero) {
+    CompilationSession session("Optimizer Test");
+    const std::string ir = optimizeModule(session, 0);
+
+    ASSERT_NE(std::string::npos, ir.find(" = mul "));
+    ASSERT_NE(std::string::npos, ir.find(" = add "));
+}
+
+TEST(Optimizer, RetargetsModuleAtMachine) {
+    for (unsigned level = 0; level <= Optimizer::MAX_LEVEL; ++level) {
+        CompilationSession session("Optimizer Test");
+        optimizeModule(session, level);
+
+        const std::unique_ptr<llvm::TargetMachine> machine = Optimizer::hostMachine(level);
+        ASSERT_EQ(machine->getTargetTriple().str(), session.module->getTargetTriple());
+        ASSERT_EQ(machine->createDataLayout(), session.module->getDataLayout());
+    }
+}
+
+TEST(Optimizer, SimplifiesArithmetic) {
+    for (unsigned level = 1; level <= Optimizer::MAX_LEVEL; ++level) {
+        CompilationSession session("Optimizer Test");
+        const std::string ir = optimizeModule(session, level);
+
+        ASSERT_EQ(std::string::npos, ir.find(" = mul "));
+        ASSERT_EQ(std::string::npos, ir.find(" = add "));
+        ASSERT_NE(std::string::npos, ir.find("call i32 @putchar"));
+    }
+}
+
+TEST(Optimizer, KeepsOutlinedChunksSeparate) {
+    CompilationSession session("Optimizer Test");
+    optimizeModule(session, Optimizer::MAX_LEVEL);
+
+    for (const std::string name : { "main.chunk0", "main.chunk1", "main.chunk2" }) {
+        const llvm::Function* chunk = session.module->getFunction(name);
+        ASSERT_NE(nullptr, chunk);
+        ASSERT_FALSE(chunk->use_empty());
+    }
+}
+
+TEST(Optimizer, ThrowsIllegalStateExceptionAboveMaxLevel) {
+    CompilationSession session("Optimizer Test");
+    ASSERT_THROW(optimizeModule(session, Optimizer::MAX_LEVEL + 1), IllegalStateException);
+    ASSERT_THROW(Optimizer::hostMachine(Optimizer::MAX_LEVEL + 1), IllegalStateException);
+}
\ No newline at end of file
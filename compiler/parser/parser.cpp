@@ -1,111 +1,292 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
-#include <memory>
+#include <future>
 #include <sstream>
+#include <string>
+#include <vector>
+#include <experimental/optional>
 #include "parser.h"
+#include "compiler/lexer/token_stream.h"
 #include "compiler/models/ast.h"
+#include "compiler/models/ast_interner.h"
+#include "compiler/models/diagnostics.h"
 #include "compiler/models/token.h"
+#include "compiler/models/token_list.h"
 #include "compiler/models/exceptions.h"
-#include "compiler/models/globals.h"
+#include "compiler/utils/arena.h"
+#include "compiler/utils/thread_pool.h"
 
-typedef Exceptions::AssertionException AssertionException;
 typedef Exceptions::ParseException ParseException;
 
-Parser::Parser(std::queue<std::shared_ptr<const Token>>& tokens) {
-    this->tokens = tokens;
+namespace {
+    // Tokens are only split into segments of at least this many Tokens, smaller ones are not worth the overhead.
+    const size_t MIN_SEGMENT_SIZE = 16 * 1024;
+
+    // Number of segments to split the Tokens into per thread, so threads which finish early can take another segment.
+    const size_t SEGMENTS_PER_THREAD = 4;
+
+    // Run of whole top-level elements, which is parsed into its own Arena since Arenas are not thread-safe.
+    class Segment {
+    public:
+        size_t first;
+        size_t end;
+        Arena arena;
+        std::vector<const AST::Function*> externDecls;
+        std::vector<const AST::Statement*> statements;
+        std::exception_ptr error;
+    };
+
+    // Returns the indexes at which to split the given Tokens into about the given number of segments, including the
+    // first and last. Each split is just after a semicolon outside of any parentheses.
+    std::vector<size_t> split(const TokenList& tokens, const size_t segments) {
+        std::vector<size_t> boundaries = { 0 };
+        if (segments <= 1) {
+            boundaries.push_back(tokens.size());
+            return boundaries;
+        }
+
+        const Token* data = tokens.data();
+        const size_t target = tokens.size() / segments;
+        int64_t depth = 0;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            switch (data[i].kind) {
+                case Token::LEFT_PAREN:
+                    ++depth;
+                    break;
+                case Token::RIGHT_PAREN:
+                    --depth;
+                    break;
+                case Token::SEMICOLON:
+                    if (depth == 0 && i + 1 - boundaries.back() >= target && i + 1 < tokens.size()) {
+                        boundaries.push_back(i + 1);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        boundaries.push_back(tokens.size());
+        return boundaries;
+    }
+    // Binary operator spelled by a kind of Token. Supporting another one only takes a new entry in BINARY_OPERATORS.
+    class BinaryOperator {
+    public:
+        Token::Kind token;
+        int precedence; // Higher precedences bind tighter.
+        const AST::Expression* (*make)(Arena& arena, const AST::Expression* leftExpr,
+            const AST::Expression* rightExpr);
+        const AST::Expression* (*intern)(AST::Interner& interner, const AST::Expression* leftExpr,
+            const AST::Expression* rightExpr);
+    };
+
+    template <typename Expression>
+    const AST::Expression* make(Arena& arena, const AST::Expression* leftExpr, const AST::Expression* rightExpr) {
+        return arena.make<Expression>(leftExpr, rightExpr);
+    }
+
+    template <typename Expression>
+    const AST::Expression* intern(AST::Interner& interner, const AST::Expression* leftExpr,
+            const AST::Expression* rightExpr) {
+        return interner.operation<Expression>(leftExpr, rightExpr);
+    }
+
+    const BinaryOperator BINARY_OPERATORS[] = {
+        { Token::PLUS, 1, make<AST::AddOpExpression>, intern<AST::AddOpExpression> },
+        { Token::MINUS, 1, make<AST::SubOpExpression>, intern<AST::SubOpExpression> },
+        { Token::STAR, 2, make<AST::MulOpExpression>, intern<AST::MulOpExpression> },
+        { Token::SLASH, 2, make<AST::DivOpExpression>, intern<AST::DivOpExpression> },
+    };
+
+    // Returns the binary operator spelled by the given kind of Token, or nullptr if there is none.
+    const BinaryOperator* binaryOperator(const Token::Kind kind) {
+        for (const BinaryOperator& op : BINARY_OPERATORS) {
+            if (op.token == kind) return &op;
+        }
+
+        return nullptr;
+    }
+}
+
+Parser::Parser(TokenStream& tokens, Arena& arena, AST::Interner* interner, Diagnostics* diagnostics)
+    : tokens(tokens), arena(arena), interner(interner), diagnostics(diagnostics) { }
+
+// Returns whether the next Token is of the given kind, without consuming it.
+bool Parser::peek(const Token::Kind kind) {
+    const std::experimental::optional<Token> next = this->tokens.peek();
+    return next && next->kind == kind;
 }
 
-std::shared_ptr<const Token> Parser::match(const std::function<bool (std::shared_ptr<const Token>&)>& matcher,
-        const std::string& expected) {
-    if (this->tokens.empty()) {
-        throw ParseException("Expected \"" + expected + "\", but got EOF.");
+// Consumes and returns the next Token, which must be of the given kind. If it is not, the error is raised and nothing
+// is consumed. Nothing is consumed either once the current element has failed, so the skip past it starts at the error.
+Token Parser::match(const Token::Kind expected) {
+    if (this->failed) return Token();
+
+    const std::experimental::optional<Token> next = this->tokens.peek();
+    if (!next || next->kind != expected) {
+        this->unexpected(next, Token::describe(expected));
+        return Token();
     }
 
-    std::shared_ptr<const Token> token = this->tokens.front();
-    if (matcher(token)) {
-        this->tokens.pop();
-        return token;
-    } else {
-        std::ostringstream ss;
-        ss << "Expected \"" << expected << "\", but got \"" << token->source << "\" (line " << token->line
-           << ", col " << token->startCol << " -> " << token->endCol << ")";
+    this->tokens.next();
+    return next.value();
+}
+
+// Consumes and returns the next Token, whatever kind it is.
+Token Parser::match() {
+    if (this->failed) return Token();
 
-        throw ParseException(ss.str());
+    const std::experimental::optional<Token> next = this->tokens.next();
+    if (!next) {
+        this->unexpected(next, "ShouldNeverPrint");
+        return Token();
     }
-};
 
-std::shared_ptr<const Token> Parser::match(const std::string& expected) {
-    return this->match([&expected](std::shared_ptr<const Token>& token) { return token->source == expected; }, expected);
-};
+    return next.value();
+}
+
+// Raises the error of the given Token, or the end of the source, being found where the expected one should be.
+void Parser::unexpected(const std::experimental::optional<Token>& token, const char* expected) {
+    if (!token) {
+        // When the source ended early at a syntax error, that error already explains what went wrong.
+        if (this->tokens.failed()) {
+            this->failed = true;
+            return;
+        }
 
-std::shared_ptr<const Token> Parser::match() {
-    return this->match([](std::shared_ptr<const Token>& token) { return true; }, "ShouldNeverPrint");
+        this->fail("Expected \"" + std::string(expected) + "\", but got EOF.");
+        return;
+    }
+
+    const Location location = this->tokens.location(token.value());
+
+    std::ostringstream ss;
+    ss << "Expected \"" << expected << "\", but got \"" << this->tokens.text(token.value()) << "\" (line "
+       << location.line << ", col " << location.startCol << " -> " << location.endCol << ")";
+
+    this->fail(ss.str());
+}
+
+// Throws a ParseException of the given message, or reports it to the Diagnostics if there are any. Only the first error
+// of each top-level element is reported, since the rest are likely caused by it.
+void Parser::fail(const std::string& message) {
+    if (!this->diagnostics) throw ParseException(message);
+
+    if (!this->failed) this->diagnostics->report(Diagnostic(Diagnostic::PARSE, message));
+    this->failed = true;
 }
 
 // <file> ::= <externDecl> <block>
 //          | <statement> <block>
 //          | ø
-std::shared_ptr<const AST::File> Parser::file() {
-    std::vector<std::shared_ptr<const AST::Function>> externDecls;
-    std::vector<std::shared_ptr<const AST::Statement>> statements;
+const AST::File* Parser::file() {
+    std::vector<const AST::Function*> externDecls;
+    std::vector<const AST::Statement*> statements;
 
-    while (!this->tokens.empty()) {
-        if (this->tokens.front()->source == "extern") {
-            externDecls.push_back(this->externDecl());
-        } else {
-            statements.push_back(this->statement());
-        }
+    this->topLevel(
+        [&externDecls](const AST::Function* externDecl) { externDecls.push_back(externDecl); },
+        [&statements](const AST::Statement* statement) { statements.push_back(statement); });
+
+    return this->arena.make<AST::File>(this->arena.list(externDecls), this->arena.list(statements));
+}
+
+// Parses each <externDecl> and <statement> of a <file> in order.
+void Parser::topLevel(const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement) {
+    while (this->element(onExternDecl, onStatement)) { }
+}
+
+// Parses the next <externDecl> or <statement> of a <file>, returning false if there are none left.
+//
+// When errors are reported to Diagnostics, an element which fails to parse is skipped up to and including the next
+// semicolon, and parsing carries on from there without calling either callback for it.
+bool Parser::element(const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement) {
+    if (this->tokens.done()) return false;
+
+    if (this->peek(Token::EXTERN)) {
+        const AST::Function* externDecl = this->externDecl();
+        if (externDecl) onExternDecl(externDecl);
+    } else {
+        const AST::Statement* statement = this->statement();
+        if (statement) onStatement(statement);
     }
 
-    return std::make_shared<const AST::File>(AST::File(externDecls, statements));
+    if (this->failed) {
+        std::experimental::optional<Token> skipped;
+        while ((skipped = this->tokens.next()) && skipped->kind != Token::SEMICOLON) { }
+        this->failed = false;
+    }
+    return true;
 }
 
 // <externDecl> ::= extern <name>: <func-type> ;
-std::shared_ptr<const AST::Function> Parser::externDecl() {
-    this->match("extern");
-    std::shared_ptr<const Token> name = this->match([](std::shared_ptr<const Token> token) {
-        return !token->isCharLiteral;
-    }, "extern");
-    this->match(":");
-    std::shared_ptr<const AST::FunctionPrototype> type = this->funcType();
-    this->match(";");
-
-    return std::make_shared<const AST::Function>(AST::Function(name->source, type));
+const AST::Function* Parser::externDecl() {
+    this->match(Token::EXTERN);
+    const Token name = this->match(Token::IDENTIFIER);
+    this->match(Token::COLON);
+    const AST::FunctionPrototype* type = this->funcType();
+    if (this->failed) return nullptr;
+
+    this->match(Token::SEMICOLON);
+    if (this->failed) return nullptr;
+
+    return this->arena.make<AST::Function>(name.symbol, type);
 }
 
 // <statement> ::= let <name> : <type> = <expression> ;
 //               | <expression> ;
-std::shared_ptr<const AST::Statement> Parser::statement() {
-    if (this->tokens.front()->source == "let") {
-        this->match("let");
-        std::shared_ptr<const Token> name = this->match(/* name */);
-        this->match(":");
-        std::shared_ptr<const AST::Type> type = this->type();
-        this->match("=");
-        std::shared_ptr<const AST::Expression> expr = this->expression();
-        this->match(";");
-        return std::make_shared<const AST::StatementLet>(AST::StatementLet(name, type, expr));
+const AST::Statement* Parser::statement() {
+    if (this->peek(Token::LET)) {
+        this->match(Token::LET);
+        const Token name = this->match(Token::IDENTIFIER);
+        this->match(Token::COLON);
+        const AST::Type* type = this->type();
+        if (this->failed) return nullptr;
+
+        this->match(Token::EQUALS);
+        const AST::Expression* expr = this->expression();
+        this->match(Token::SEMICOLON);
+        if (this->failed) return nullptr;
+
+        return this->arena.make<AST::StatementLet>(name.symbol, type, expr);
     } else {
-        std::shared_ptr<const AST::Expression> expr = this->expression();
-        this->match(";");
-        return std::make_shared<const AST::StatementExpression>(AST::StatementExpression(expr));
+        const AST::Expression* expr = this->expression();
+        this->match(Token::SEMICOLON);
+        if (this->failed) return nullptr;
+
+        return this->arena.make<AST::StatementExpression>(expr);
     }
 }
 
 // <type> ::= int
 //          | <func-type>
-std::shared_ptr<const AST::Type> Parser::type() {
-    if (this->tokens.empty()) throw ParseException("Expected a type, but got EOF.");
-
-    if (this->tokens.front()->source == "int") {
-        this->match(/* int type */);
-        return std::make_shared<AST::IntegerType>(AST::IntegerType());
-    } else if (this->tokens.front()->source == "string") {
-        this->match(/* string type */);
-        return std::make_shared<AST::StringType>(AST::StringType());
-    } else if (this->tokens.front()->source == "(") {
-        return this->funcType();
-    } else {
-        throw ParseException("Expected a type, but got \"" + this->tokens.front()->source + "\"");
+const AST::Type* Parser::type() {
+    const std::experimental::optional<Token> next = this->tokens.peek();
+    if (!next) {
+        if (this->tokens.failed()) {
+            this->failed = true;
+        } else {
+            this->fail("Expected a type, but got EOF.");
+        }
+        return nullptr;
+    }
+
+    switch (next->kind) {
+        case Token::INT:
+            this->match();
+            return this->arena.make<AST::IntegerType>();
+        case Token::STRING:
+            this->match();
+            return this->arena.make<AST::StringType>();
+        case Token::LEFT_PAREN:
+            return this->funcType();
+        default:
+            this->fail("Expected a type, but got \"" + this->tokens.text(next.value()).to_string() + "\"");
+            return nullptr;
     }
 }
 
@@ -114,166 +295,270 @@ std::shared_ptr<const AST::Type> Parser::type() {
 //           | ø
 // <types'> ::= , <type>
 //            | ø
-std::shared_ptr<const AST::FunctionPrototype> Parser::funcType() {
-    std::vector<std::shared_ptr<const AST::Type>> parameters;
-
-    this->match("(");
-    if (this->tokens.front()->source != ")") { // Has parameters
-        parameters.push_back(this->type());
-        while (this->tokens.front()->source == ",") {
-            this->match(",");
-            parameters.push_back(this->type());
+const AST::FunctionPrototype* Parser::funcType() {
+    const size_t parameters = this->typeStack.size();
+
+    this->match(Token::LEFT_PAREN);
+    if (!this->peek(Token::RIGHT_PAREN)) { // Has parameters
+        this->typeStack.push_back(this->type());
+        while (this->peek(Token::COMMA)) {
+            this->match(Token::COMMA);
+            this->typeStack.push_back(this->type());
         }
     }
-    this->match(")");
+    this->match(Token::RIGHT_PAREN);
+    const ArenaList<const AST::Type*> parameterList = this->arena.list(this->typeStack.data() + parameters,
+        this->typeStack.size() - parameters);
+    this->typeStack.resize(parameters);
 
-    this->match("->");
-    std::shared_ptr<const AST::Type> returnType = this->type();
+    this->match(Token::ARROW);
+    const AST::Type* returnType = this->type();
+    if (this->failed) return nullptr;
 
-    return std::make_shared<AST::FunctionPrototype>(AST::FunctionPrototype(parameters, returnType));
+    return this->arena.make<AST::FunctionPrototype>(parameterList, returnType);
 }
 
-// <expression> ::= <expr-add-sub>
-std::shared_ptr<const AST::Expression> Parser::expression() {
-    return this->exprAddSub();
-}
-
-// <expr-add-sub> ::= <expr-leaf> <expr-add-sub'>
-// <expr-add-sub'> ::= + <expr-mul-div> <expr-add-sub'>
-//                   | - <expr-mul-div> <expr-add-sub'>
-//                   | ø
-std::shared_ptr<const AST::Expression> Parser::exprAddSub() {
-    std::shared_ptr<const AST::Expression> leftExpr = this->exprMulDiv();
-
-    while (!this->tokens.empty() && (this->tokens.front()->source == "+" || this->tokens.front()->source == "-")) {
-        const std::shared_ptr<const Token> op = this->match();
-        const std::shared_ptr<const AST::Expression> rightExpr = this->exprMulDiv();
-
-        if (op->source == "+") {
-            leftExpr = std::make_shared<const AST::AddOpExpression>(AST::AddOpExpression(leftExpr, rightExpr));
-        } else if (op->source == "-") {
-            leftExpr = std::make_shared<const AST::SubOpExpression>(AST::SubOpExpression(leftExpr, rightExpr));
-        } else {
-            throw AssertionException("Expected operator + or -, but got " + op->source);
+// <expression> ::= <operand> <expression'>
+// <expression'> ::= <binary-operator> <operand> <expression'>
+//                 | ø
+// <operand> ::= ( <expression> )
+//             | <expr-leaf>
+//
+// Parsed by precedence climbing over explicit stacks rather than by recursion, so expressions can be nested as deeply
+// as memory allows. Operands are gathered on the expressionStack, and the frameStack holds each binary operator still
+// waiting for its right operand, along with each parenthesis and function call still waiting to be closed.
+const AST::Expression* Parser::expression() {
+    const size_t frames = this->frameStack.size();
+    const size_t expressions = this->expressionStack.size();
+
+    while (true) {
+        const AST::Expression* operand;
+        while (!(operand = this->operand())) {
+            if (this->failed) return this->abandon(frames, expressions);
+        }
+        this->expressionStack.push_back(operand);
+
+        // Apply binary operators and close parentheses and function calls until another operand is needed.
+        while (true) {
+            const std::experimental::optional<Token> next = this->tokens.peek();
+            const BinaryOperator* op = next ? binaryOperator(next->kind) : nullptr;
+            this->reduce(frames, op ? op->precedence : 0);
+
+            if (op) {
+                this->frameStack.push_back(Frame { Frame::OPERATOR, this->match(), 0 });
+                break;
+            }
+
+            if (this->frameStack.size() == frames) {
+                const AST::Expression* expr = this->expressionStack.back();
+                this->expressionStack.pop_back();
+                return expr;
+            }
+
+            const Frame frame = this->frameStack.back();
+            if (frame.kind == Frame::CALL && this->peek(Token::COMMA)) {
+                this->match(Token::COMMA);
+                break;
+            }
+
+            this->match(Token::RIGHT_PAREN);
+            if (this->failed) return this->abandon(frames, expressions);
+
+            this->frameStack.pop_back();
+            if (frame.kind == Frame::CALL) {
+                const AST::Expression* call = this->functionCall(frame.token, frame.arguments);
+                this->expressionStack.push_back(call);
+            }
         }
     }
-
-    return leftExpr;
 }
 
-// <expr-mul-div> ::= <expr-paren> <expr-mul-div'>
-// <expr-mul-div'> ::= * <expr-paren> <expr-mul-div'>
-//                   | / <expr-paren> <expr-mul-div'>
-//                   | ø
-std::shared_ptr<const AST::Expression> Parser::exprMulDiv() {
-    std::shared_ptr<const AST::Expression> leftExpr = this->exprParen();
-
-    while (!this->tokens.empty() && (this->tokens.front()->source == "*" || this->tokens.front()->source == "/")) {
-        const std::shared_ptr<const Token> op = this->match();
-        const std::shared_ptr<const AST::Expression> rightExpr = this->exprParen();
-
-        if (op->source == "*") {
-            leftExpr = std::make_shared<const AST::MulOpExpression>(AST::MulOpExpression(leftExpr, rightExpr));
-        } else if (op->source == "/") {
-            leftExpr = std::make_shared<const AST::DivOpExpression>(AST::DivOpExpression(leftExpr, rightExpr));
+// <expr-leaf> ::= <char-literal>
+//               | <integer-literal>
+//               | <string-literal>
+//               | <identifier>
+//               | <function-call>
+//
+// Returns the next operand, or nullptr if instead it opened a parenthesis or a function call with arguments, whose
+// first operand comes next.
+const AST::Expression* Parser::operand() {
+    const std::experimental::optional<Token> next = this->tokens.peek();
+    if (!next) {
+        if (this->tokens.failed()) {
+            this->failed = true;
         } else {
-            throw AssertionException("Expected operator * or /, but got " + op->source);
+            this->fail("Expected an expression, but got EOF.");
         }
+        return nullptr;
     }
 
-    return leftExpr;
-}
-
-// <expr-paren> ::= ( <expression> )
-//                | <expr-leaf>
-std::shared_ptr<const AST::Expression> Parser::exprParen() {
-    if (!this->tokens.empty() && this->tokens.front()->source == "(") {
-        this->match(); // (
-        const std::shared_ptr<const AST::Expression> expr = this->expression();
-        this->match(")");
-        return expr;
-    } else {
-        return this->exprLeaf();
+    switch (next->kind) {
+        case Token::LEFT_PAREN:
+            this->frameStack.push_back(Frame { Frame::PAREN, this->match(), 0 });
+            return nullptr;
+        case Token::CHAR_LITERAL:
+            return this->charLiteral();
+        case Token::INTEGER_LITERAL:
+            return this->integerLiteral();
+        case Token::STRING_LITERAL:
+            return this->stringLiteral();
+        default: {
+            const Token identifier = this->match(Token::IDENTIFIER);
+            if (this->failed) return nullptr;
+            if (!this->peek(Token::LEFT_PAREN)) return this->identifierExpr(identifier);
+
+            this->match(Token::LEFT_PAREN);
+            if (this->peek(Token::RIGHT_PAREN)) {
+                this->match(Token::RIGHT_PAREN);
+                return this->functionCall(identifier, this->expressionStack.size());
+            }
+
+            this->frameStack.push_back(Frame { Frame::CALL, identifier, this->expressionStack.size() });
+            return nullptr;
+        }
     }
 }
 
-// <expr-leaf> ::= <char-literal>
-//               | <integer-literal>
-//               | <identifier>
-//               | <function-call>
-std::shared_ptr<const AST::Expression> Parser::exprLeaf() {
-    if (this->tokens.empty()) throw ParseException("Expected an expression, but got EOF.");
-
-    if (this->tokens.front()->isCharLiteral) {
-        return this->charLiteral();
-    } else if (this->tokens.front()->isIntegerLiteral) {
-        return this->integerLiteral();
-    } else if (this->tokens.front()->isStringLiteral) {
-        return this->stringLiteral();
-    } else {
-        const std::shared_ptr<const Token> identifier = this->match([](std::shared_ptr<const Token> token) {
-            return !token->isCharLiteral;
-        }, "identifier");
+// Drops the partial expression being parsed after an error, leaving the stacks as they were before it, and returns
+// nullptr in its place.
+const AST::Expression* Parser::abandon(const size_t frames, const size_t expressions) {
+    this->frameStack.resize(frames);
+    this->expressionStack.resize(expressions);
+    return nullptr;
+}
 
-        if (this->tokens.front()->source == "(") {
-            return this->functionCall(identifier);
-        } else {
-            return this->identifierExpr(identifier);
-        }
+// Applies the binary operators on top of the frameStack, above the given number of frames, which bind at least as
+// tightly as the given precedence. Every operator is left associative.
+void Parser::reduce(const size_t frames, const int precedence) {
+    while (this->frameStack.size() > frames && this->frameStack.back().kind == Frame::OPERATOR) {
+        const BinaryOperator* op = binaryOperator(this->frameStack.back().token.kind);
+        if (op->precedence < precedence) return;
+
+        const AST::Expression* rightExpr = this->expressionStack.back();
+        this->expressionStack.pop_back();
+        const AST::Expression* leftExpr = this->expressionStack.back();
+        this->expressionStack.back() = this->interner
+            ? op->intern(*this->interner, leftExpr, rightExpr) : op->make(this->arena, leftExpr, rightExpr);
+        this->frameStack.pop_back();
     }
 }
 
 // <function-call> ::= <name> ( <arguments> )
-// <arguments> ::= <argument> <arguments'>
+// <arguments> ::= <expression> <arguments'>
 //               | ø
-// <arguments'> ::= , <argument>
+// <arguments'> ::= , <expression> <arguments'>
 //                | ø
-std::shared_ptr<const AST::FunctionCall> Parser::functionCall(const std::shared_ptr<const Token> callee) {
-    this->match("(");
-
-    // Parse arguments
-    std::vector<std::shared_ptr<const AST::Expression>> arguments;
-    if (this->tokens.front()->source != ")") {
-        arguments.push_back(this->expression());
-        while (this->tokens.front()->source == ",") {
-            this->match(",");
-            arguments.push_back(this->expression());
-        }
+//
+// Builds the call from the arguments on the expressionStack from the given index onwards.
+const AST::FunctionCall* Parser::functionCall(const Token& callee, const size_t arguments) {
+    const ArenaList<const AST::Expression*> argumentList = this->arena.list(
+        this->expressionStack.data() + arguments, this->expressionStack.size() - arguments);
+    this->expressionStack.resize(arguments);
+
+    return this->arena.make<AST::FunctionCall>(callee.symbol, argumentList);
+}
+
+const AST::CharLiteral* Parser::charLiteral() {
+    const Token literal = this->match(Token::CHAR_LITERAL);
+
+    if (this->interner) return this->interner->charLiteral(this->tokens.charValue(literal));
+    return this->arena.make<AST::CharLiteral>(this->tokens.charValue(literal));
+}
+
+const AST::IntegerLiteral* Parser::integerLiteral() {
+    const Token literal = this->match(Token::INTEGER_LITERAL);
+    const std::experimental::optional<int32_t> value = this->tokens.integerValue(literal);
+    if (!value) {
+        this->fail("Integer literal \"" + this->tokens.text(literal).to_string() + "\" does not fit in 32 bits.");
+        return nullptr;
     }
 
-    this->match(")");
+    if (this->interner) return this->interner->integerLiteral(value.value());
+    return this->arena.make<AST::IntegerLiteral>(value.value());
+}
+
+const AST::StringLiteral* Parser::stringLiteral() {
+    const Token literal = this->match(Token::STRING_LITERAL);
 
-    return std::make_shared<const AST::FunctionCall>(AST::FunctionCall(callee, arguments));
+    if (this->interner) return this->interner->stringLiteral(this->tokens.stringValue(literal));
+    return this->arena.make<AST::StringLiteral>(this->arena.text(this->tokens.stringValue(literal)));
 }
 
-std::shared_ptr<const AST::CharLiteral> Parser::charLiteral() {
-    const std::shared_ptr<const Token> literal = this->match([](std::shared_ptr<const Token> token) {
-        return token->isCharLiteral;
-    }, "char literal");
+const AST::IdentifierExpr* Parser::identifierExpr(const Token& name) {
+    if (this->interner) return this->interner->identifierExpr(name.symbol);
+    return this->arena.make<AST::IdentifierExpr>(name.symbol);
+}
+
+const AST::File* Parser::parse(TokenStream& tokens, Arena& arena) {
+    return Parser(tokens, arena).file();
+}
+
+const AST::File* Parser::parse(TokenStream& tokens, AST::Interner& interner) {
+    return Parser(tokens, interner.arena(), &interner).file();
+}
 
-    return std::make_shared<const AST::CharLiteral>(AST::CharLiteral(literal));
+const AST::File* Parser::parse(TokenStream& tokens, Arena& arena, Diagnostics& diagnostics) {
+    return Parser(tokens, arena, nullptr, &diagnostics).file();
 }
 
-std::shared_ptr<const AST::IntegerLiteral> Parser::integerLiteral() {
-    const std::shared_ptr<const Token> literal = this->match([](std::shared_ptr<const Token> token) {
-        return token->isIntegerLiteral;
-    }, "integer literal");
+const AST::File* Parser::parse(TokenStream& tokens, AST::Interner& interner, Diagnostics& diagnostics) {
+    return Parser(tokens, interner.arena(), &interner, &diagnostics).file();
+}
 
-    return std::make_shared<const AST::IntegerLiteral>(AST::IntegerLiteral(literal));
+const AST::File* Parser::parse(const TokenList& tokens, Arena& arena) {
+    TokenStream stream(tokens);
+    return Parser::parse(stream, arena);
 }
 
-std::shared_ptr<const AST::StringLiteral> Parser::stringLiteral() {
-    const std::shared_ptr<const Token> literal = this->match([](std::shared_ptr<const Token> token) {
-        return token->isStringLiteral;
-    }, "string literal");
+const AST::File* Parser::parse(const TokenList& tokens, Arena& arena, ThreadPool& pool) {
+    const std::vector<size_t> boundaries = split(tokens,
+        std::min(pool.size() * SEGMENTS_PER_THREAD, tokens.size() / MIN_SEGMENT_SIZE));
+    if (boundaries.size() <= 2) return Parser::parse(tokens, arena);
+
+    std::vector<Segment> segments(boundaries.size() - 1);
+    std::vector<std::future<void>> parsed;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        Segment& segment = segments[i];
+        segment.first = boundaries[i];
+        segment.end = boundaries[i + 1];
+        parsed.push_back(pool.submit([&tokens, &segment]() {
+            try {
+                TokenStream stream(tokens, segment.first);
+                Parser parser(stream, segment.arena);
+                while (segment.first + stream.consumed() < segment.end) {
+                    parser.element(
+                        [&segment](const AST::Function* externDecl) { segment.externDecls.push_back(externDecl); },
+                        [&segment](const AST::Statement* statement) { segment.statements.push_back(statement); });
+                }
+            } catch (...) {
+                segment.error = std::current_exception();
+            }
+        }));
+    }
+    for (std::future<void>& result : parsed) result.get();
+
+    // Stitch the segments together in order, stopping at the first one the serial parse would have failed in.
+    std::vector<const AST::Function*> externDecls;
+    std::vector<const AST::Statement*> statements;
+    for (Segment& segment : segments) {
+        if (segment.error) std::rethrow_exception(segment.error);
+
+        externDecls.insert(externDecls.end(), segment.externDecls.begin(), segment.externDecls.end());
+        statements.insert(statements.end(), segment.statements.begin(), segment.statements.end());
+    }
+    for (Segment& segment : segments) arena.adopt(segment.arena);
 
-    return std::make_shared<const AST::StringLiteral>(AST::StringLiteral(literal));
+    return arena.make<AST::File>(arena.list(externDecls), arena.list(statements));
 }
 
-std::shared_ptr<const AST::IdentifierExpr> Parser::identifierExpr(const std::shared_ptr<const Token> name) {
-    return std::make_shared<const AST::IdentifierExpr>(AST::IdentifierExpr(name));
+void Parser::parseEach(TokenStream& tokens, Arena& arena,
+        const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement) {
+    Parser(tokens, arena).topLevel(onExternDecl, onStatement);
 }
 
-std::shared_ptr<const AST::File> Parser::parse(std::queue<std::shared_ptr<const Token>>& tokens) {
-    return Parser(tokens).file();
+bool Parser::parseNext(TokenStream& tokens, Arena& arena,
+        const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement) {
+    return Parser(tokens, arena).element(onExternDecl, onStatement);
 }
\ No newline at end of file
@@ -1,47 +1,163 @@
 #ifndef SANITY_PARSER_H
 #define SANITY_PARSER_H
 
-#include <queue>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
+#include <experimental/optional>
+#include "../lexer/token_stream.h"
 #include "../models/ast.h"
+#include "../models/ast_interner.h"
+#include "../models/diagnostics.h"
 #include "../models/token.h"
+#include "../models/token_list.h"
+#include "../utils/arena.h"
+#include "../utils/thread_pool.h"
 
 /**
- * Class for parsing the Sanity language. Uses a recursive descent parsing design. The class is only used via the static
- * parse() function, however the class is necessary to maintain state so that the match() methods are usable.
+ * Class for parsing the Sanity language. Statements are parsed by recursive descent, and expressions by precedence
+ * climbing. The class is only used via the static parse() functions, however the class is necessary to maintain state
+ * so that the match() methods are usable.
+ *
+ * Tokens are pulled from a TokenStream as they are needed, which can look up to TokenStream::MAX_LOOKAHEAD Tokens
+ * ahead. AST nodes are placed directly in the given Arena, so the AST is valid for as long as the Arena is not reset.
+ * Expressions are parsed over explicit stacks rather than by recursion, so how deeply they can be nested is only
+ * limited by memory.
  */
 class Parser {
 private:
-    std::queue<std::shared_ptr<const Token>> tokens;
-
-    explicit Parser(std::queue<std::shared_ptr<const Token>>& tokens);
-
-    std::shared_ptr<const Token> match(const std::function<bool (std::shared_ptr<const Token>&)>& matcher,
-        const std::string& errMsg);
-    std::shared_ptr<const Token> match(const std::string& expected);
-    std::shared_ptr<const Token> match();
-
-    std::shared_ptr<const AST::File> file();
-    std::shared_ptr<const AST::Function> externDecl();
-    std::shared_ptr<const AST::Statement> statement();
-    std::shared_ptr<const AST::Type> type();
-    std::shared_ptr<const AST::FunctionPrototype> funcType();
-    std::shared_ptr<const AST::Expression> expression();
-    std::shared_ptr<const AST::Expression> exprAddSub();
-    std::shared_ptr<const AST::Expression> exprMulDiv();
-    std::shared_ptr<const AST::Expression> exprParen();
-    std::shared_ptr<const AST::Expression> exprLeaf();
-    std::shared_ptr<const AST::FunctionCall> functionCall(std::shared_ptr<const Token> callee);
-    std::shared_ptr<const AST::CharLiteral> charLiteral();
-    std::shared_ptr<const AST::IntegerLiteral> integerLiteral();
-    std::shared_ptr<const AST::StringLiteral> stringLiteral();
-    std::shared_ptr<const AST::IdentifierExpr> identifierExpr(std::shared_ptr<const Token> name);
+    // Part of an expression still waiting for its right operand, closing parenthesis or the rest of its arguments.
+    class Frame {
+    public:
+        enum Kind : uint8_t {
+            OPERATOR,
+            PAREN,
+            CALL,
+        };
+
+        Kind kind;
+        Token token; // Operator, parenthesis or callee.
+        size_t arguments; // Index in the expressionStack of the first argument of a call.
+    };
+
+    TokenStream& tokens;
+    Arena& arena;
+    AST::Interner* interner; // Shares identical side-effect-free expressions when set.
+    Diagnostics* diagnostics; // Collects errors rather than throwing them when set.
+
+    // Whether the top-level element being parsed has failed, in which case parsing unwinds to the next element.
+    bool failed = false;
+
+    // Lists and expressions being parsed, which may be nested, are gathered on these stacks before being copied into
+    // the Arena.
+    std::vector<const AST::Type*> typeStack;
+    std::vector<const AST::Expression*> expressionStack;
+    std::vector<Frame> frameStack;
+
+    Parser(TokenStream& tokens, Arena& arena, AST::Interner* interner = nullptr, Diagnostics* diagnostics = nullptr);
+
+    bool peek(Token::Kind kind);
+
+    Token match(Token::Kind expected);
+    Token match();
+    void unexpected(const std::experimental::optional<Token>& token, const char* expected);
+    void fail(const std::string& message);
+
+    const AST::File* file();
+    void topLevel(const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement);
+    bool element(const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement);
+    const AST::Function* externDecl();
+    const AST::Statement* statement();
+    const AST::Type* type();
+    const AST::FunctionPrototype* funcType();
+    const AST::Expression* expression();
+    const AST::Expression* operand();
+    const AST::Expression* abandon(size_t frames, size_t expressions);
+    void reduce(size_t frames, int precedence);
+    const AST::FunctionCall* functionCall(const Token& callee, size_t arguments);
+    const AST::CharLiteral* charLiteral();
+    const AST::IntegerLiteral* integerLiteral();
+    const AST::StringLiteral* stringLiteral();
+    const AST::IdentifierExpr* identifierExpr(const Token& name);
 
 public:
+    /**
+     * Parse the tokens provided, pulling each one from the stream as it is needed.
+     * @throws ParseException
+     * @throws SyntaxException if the stream lexes its source on demand and the source cannot be lexed.
+     */
+    static const AST::File* parse(TokenStream& tokens, Arena& arena);
+
+    /**
+     * Parse the tokens provided, constructing expressions with the given Interner so that identical side-effect-free
+     * expressions share a single node. The AST is placed in the Interner's Arena.
+     * @throws ParseException
+     * @throws SyntaxException if the stream lexes its source on demand and the source cannot be lexed.
+     */
+    static const AST::File* parse(TokenStream& tokens, AST::Interner& interner);
+
+    /**
+     * Parse the tokens provided, reporting each ParseException to the given Diagnostics rather than throwing it. A top-
+     * level element which fails to parse is skipped up to and including the next semicolon, and parsing carries on
+     * after it, so a single run reports an error for every element which has one. The returned File only holds the
+     * elements which parsed.
+     *
+     * Errors are passed around as values rather than by unwinding, so failing inputs cost about as much to parse as
+     * valid ones. A TokenStream which also reports its syntax errors to Diagnostics ends at the first one, which is
+     * not followed by a ParseException for the source ending early.
+     * @throws SyntaxException if the stream lexes its source on demand and throws its syntax errors.
+     */
+    static const AST::File* parse(TokenStream& tokens, Arena& arena, Diagnostics& diagnostics);
+
+    /**
+     * Parse the tokens provided like parse(tokens, arena, diagnostics), constructing expressions with the given
+     * Interner.
+     * @throws SyntaxException if the stream lexes its source on demand and throws its syntax errors.
+     */
+    static const AST::File* parse(TokenStream& tokens, AST::Interner& interner, Diagnostics& diagnostics);
+
     /**
      * Parse the tokens provided.
+     * @throws ParseException
+     */
+    static const AST::File* parse(const TokenList& tokens, Arena& arena);
+
+    /**
+     * Parse the tokens provided, parsing runs of top-level elements in parallel on the given pool. The resulting File
+     * and any ParseException thrown are identical to those of parsing the tokens serially.
+     *
+     * Top-level elements are only ended by a semicolon outside of any parentheses, so the tokens are split just after
+     * such semicolons, and each segment is parsed on its own as if it were the start of a file. When the tokens parse,
+     * every segment starts exactly where the serial parse would reach it. When they do not, the serial parse stops at
+     * the first segment which failed, so its error is the one thrown.
+     * @throws ParseException
+     */
+    static const AST::File* parse(const TokenList& tokens, Arena& arena, ThreadPool& pool);
+
+    /**
+     * Parse the tokens provided one top-level element at a time, passing each extern declaration and statement to the
+     * matching callback as soon as it has been parsed, in the order they appear in the file.
+     * @throws ParseException
+     * @throws SyntaxException if the stream lexes its source on demand and the source cannot be lexed.
+     */
+    static void parseEach(TokenStream& tokens, Arena& arena,
+        const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement);
+
+    /**
+     * Parse only the next top-level extern declaration or statement of the tokens provided, passing it to the matching
+     * callback. Returns false without calling either callback if there are no Tokens left. Top-level elements never
+     * consume Tokens beyond their own, so the stream is left at the start of the next one.
+     * @throws ParseException
+     * @throws SyntaxException if the stream lexes its source on demand and the source cannot be lexed.
      */
-    static std::shared_ptr<const AST::File> parse(std::queue<std::shared_ptr<const Token>>& tokens);
+    static bool parseNext(TokenStream& tokens, Arena& arena,
+        const std::function<void (const AST::Function*)>& onExternDecl,
+        const std::function<void (const AST::Statement*)>& onStatement);
 };
 
 #endif //SANITY_PARSER_H
\ No newline at end of file
@@ -1,42 +1,34 @@
 #include <gtest/gtest.h>
 
-#include <queue>
 #include "parser.h"
+#include "compiler/lexer/lexer.h"
+#include "compiler/lexer/token_stream.h"
 #include "compiler/models/ast.h"
+#include "compiler/models/ast_interner.h"
+#include "compiler/models/diagnostics.h"
 #include "compiler/models/exceptions.h"
-#include "compiler/models/token.h"
-#include "compiler/models/token_builder.h"
-#include "compiler/utils/queue_utils.h"
+#include "compiler/models/token_list.h"
+#include "compiler/utils/arena.h"
+#include "compiler/utils/thread_pool.h"
 #include "llvm/Support/raw_ostream.h"
 
 typedef Exceptions::ParseException ParseException;
+typedef Exceptions::SyntaxException SyntaxException;
 
 TEST(Parser, ParsesEmptyFile) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {};
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     ASSERT_TRUE(file->statements.empty());
 }
 
 TEST(Parser, ParsesExtern) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("extern").build(),
-        TokenBuilder("test").build(),
-        TokenBuilder(":").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("int").build(),
-        TokenBuilder(",").build(),
-        TokenBuilder("int").build(),
-        TokenBuilder(")").build(),
-        TokenBuilder("->").build(),
-        TokenBuilder("int").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("extern test: (int, int) -> int;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -45,20 +37,11 @@ TEST(Parser, ParsesExtern) {
 }
 
 TEST(Parser, ParsesIntegerType) {
+    Arena arena;
     // Currently, the int type can only be used in an extern which must be a function.
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("extern").build(),
-        TokenBuilder("test").build(),
-        TokenBuilder(":").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder(")").build(),
-        TokenBuilder("->").build(),
-        TokenBuilder("int").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const TokenList tokens = Lexer::tokenize("extern test: () -> int;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -67,20 +50,11 @@ TEST(Parser, ParsesIntegerType) {
 }
 
 TEST(Parser, ParsesStringType) {
+    Arena arena;
     // Currently, the string type can only be used in an extern which must be a function.
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("extern").build(),
-        TokenBuilder("test").build(),
-        TokenBuilder(":").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder(")").build(),
-        TokenBuilder("->").build(),
-        TokenBuilder("string").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const TokenList tokens = Lexer::tokenize("extern test: () -> string;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -89,41 +63,24 @@ TEST(Parser, ParsesStringType) {
 }
 
 TEST(Parser, ThrowsParseExceptionOnExternsUnexpectedEOF) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("extern").build(),
-        TokenBuilder("test").build(),
-        TokenBuilder(":").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("extern test:");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ThrowsParseExceptionOnExternsStatementWithNoType) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("extern").build(),
-        TokenBuilder("test").build(),
-        TokenBuilder(":").build(),
-        TokenBuilder("blarg").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("extern test: blarg;");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ParsesAdditionOperationLeftToRight) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder("+").build(),
-        TokenBuilder("2").setIntegerLiteral(true).build(),
-        TokenBuilder("+").build(),
-        TokenBuilder("3").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("1 + 2 + 3;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -132,17 +89,10 @@ TEST(Parser, ParsesAdditionOperationLeftToRight) {
 }
 
 TEST(Parser, ParsesSubtractionOperationLeftToRight) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("3").setIntegerLiteral(true).build(),
-        TokenBuilder("-").build(),
-        TokenBuilder("2").setIntegerLiteral(true).build(),
-        TokenBuilder("-").build(),
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("3 - 2 - 1;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -151,17 +101,10 @@ TEST(Parser, ParsesSubtractionOperationLeftToRight) {
 }
 
 TEST(Parser, ParsesMultiplicationOperationLeftToRight) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder("*").build(),
-        TokenBuilder("2").setIntegerLiteral(true).build(),
-        TokenBuilder("*").build(),
-        TokenBuilder("3").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("1 * 2 * 3;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -170,17 +113,10 @@ TEST(Parser, ParsesMultiplicationOperationLeftToRight) {
 }
 
 TEST(Parser, ParsesDivisionOperationLeftToRight) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("3").setIntegerLiteral(true).build(),
-        TokenBuilder("/").build(),
-        TokenBuilder("2").setIntegerLiteral(true).build(),
-        TokenBuilder("/").build(),
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("3 / 2 / 1;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -189,25 +125,10 @@ TEST(Parser, ParsesDivisionOperationLeftToRight) {
 }
 
 TEST(Parser, RespectsOrderOfOperations) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder("+").build(),
-        TokenBuilder("2").setIntegerLiteral(true).build(),
-        TokenBuilder("*").build(),
-        TokenBuilder("3").setIntegerLiteral(true).build(),
-        TokenBuilder("-").build(),
-        TokenBuilder("4").setIntegerLiteral(true).build(),
-        TokenBuilder("/").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("5").setIntegerLiteral(true).build(),
-        TokenBuilder("+").build(),
-        TokenBuilder("6").setIntegerLiteral(true).build(),
-        TokenBuilder(")").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("1 + 2 * 3 - 4 / (5 + 6);");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -215,19 +136,46 @@ TEST(Parser, RespectsOrderOfOperations) {
     ASSERT_EQ("((1) + ((2) * (3))) - ((4) / ((5) + (6)));\n", ss.str());
 }
 
+TEST(Parser, ParsesOperationsInsideFunctionCallArguments) {
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("1 + foo(2 * (3 - 4), bar(), baz(5) / 6) * 7;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ("(1) + ((foo((2) * ((3) - (4)), bar(), (baz(5)) / (6))) * (7));\n", ss.str());
+}
+
+TEST(Parser, ParsesDeeplyNestedExpressionsWithoutRecursion) {
+    const int depth = 100000;
+    std::string source;
+    for (int i = 0; i < depth; ++i) source += "foo((";
+    source += "1";
+    for (int i = 0; i < depth; ++i) source += ") + 2)";
+    source += ";";
+
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize(source);
+    const AST::File* file = Parser::parse(tokens, arena);
+
+    std::string expected;
+    for (int i = 0; i < depth; ++i) expected += "foo((";
+    expected += "1";
+    for (int i = 0; i < depth; ++i) expected += ") + (2))";
+    expected += ";\n";
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ(expected, ss.str());
+}
+
 TEST(Parser, ParsesSingleFunctionCall) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("a").setCharLiteral(true).build(),
-        TokenBuilder(",").build(),
-        TokenBuilder("b").setCharLiteral(true).build(),
-        TokenBuilder(")").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test('a', 'b');");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -236,15 +184,10 @@ TEST(Parser, ParsesSingleFunctionCall) {
 }
 
 TEST(Parser, ParsesFunctionCallWithEmptyArguments) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder(")").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test();");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -253,13 +196,10 @@ TEST(Parser, ParsesFunctionCallWithEmptyArguments) {
 }
 
 TEST(Parser, ParsesSingleCharLiteralStatement) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("a").setCharLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("'a';");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -268,13 +208,10 @@ TEST(Parser, ParsesSingleCharLiteralStatement) {
 }
 
 TEST(Parser, ParsesSingleIntegerLiteralStatement) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("1234").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("1234;");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -283,13 +220,10 @@ TEST(Parser, ParsesSingleIntegerLiteralStatement) {
 }
 
 TEST(Parser, ParsesSingleStringLiteralStatement) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("abc123").setStringLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("\"abc123\";");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -298,19 +232,10 @@ TEST(Parser, ParsesSingleStringLiteralStatement) {
 }
 
 TEST(Parser, ParsesMultipleStatements) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test1").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("a").setCharLiteral(true).build(),
-        TokenBuilder(")").build(),
-        TokenBuilder(";").build(),
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test1('a'); 'b';");
 
-        TokenBuilder("b").setCharLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -319,18 +244,10 @@ TEST(Parser, ParsesMultipleStatements) {
 }
 
 TEST(Parser, ParsesStatementLet) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("let").build(),
-        TokenBuilder("foo").build(),
-        TokenBuilder(":").build(),
-        TokenBuilder("int").build(),
-        TokenBuilder("=").build(),
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("let foo: int = 1;");
+
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -339,15 +256,10 @@ TEST(Parser, ParsesStatementLet) {
 }
 
 TEST(Parser, ParsesIdentifierUsageInExpression) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("foo").build(),
-        TokenBuilder("+").build(),
-        TokenBuilder("bar").build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("foo + bar;");
 
-    std::shared_ptr<const AST::File> file = Parser::parse(input);
+    const AST::File* file = Parser::parse(tokens, arena);
 
     std::string str;
     llvm::raw_string_ostream ss(str);
@@ -356,57 +268,268 @@ TEST(Parser, ParsesIdentifierUsageInExpression) {
 }
 
 TEST(Parser, ThrowsParseExceptionOnFunctionCallMissingName) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("(").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("(");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ThrowsParseExceptionOnFunctionCallMissingCloseParen) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("a").setCharLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test('a';");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ThrowsParseExceptionOnStatementMissingSemicolon) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test").build(),
-        TokenBuilder("(").build(),
-        TokenBuilder("a").setCharLiteral(true).build(),
-        TokenBuilder(")").build(),
-        TokenBuilder("foo").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test('a') foo");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ThrowsParseExceptionOnUnexpectedEOF) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("test").build(),
-        TokenBuilder("(").build(),
-        // EOF
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("test(");
 
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
 }
 
 TEST(Parser, ThrowsParseExceptionOnUnmatchedParen) {
-    const std::vector<std::shared_ptr<const Token>> tokens = {
-        TokenBuilder("(").build(),
-        TokenBuilder("1").setIntegerLiteral(true).build(),
-        TokenBuilder(";").build(),
-    };
-    std::queue<std::shared_ptr<const Token>> input = QueueUtils::queueify(tokens);
-
-    ASSERT_THROW(Parser::parse(input), ParseException);
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("(1;");
+
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
+}
+
+TEST(Parser, ReportsLocationOfUnexpectedToken) {
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("let foo: int = 1;\nlet bar int = 2;");
+
+    try {
+        Parser::parse(tokens, arena);
+        FAIL();
+    } catch (const ParseException& ex) {
+        ASSERT_EQ(std::string("Expected \":\", but got \"int\" (line 2, col 9 -> 12)"), ex.what());
+    }
+}
+
+TEST(Parser, DoesNotTreatStringLiteralsAsKeywords) {
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize("\"let\";");
+
+    const AST::File* file = Parser::parse(tokens, arena);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ("\"let\";\n", ss.str());
+}
+
+TEST(Parser, ParsesTokensStreamedFromSource) {
+    Arena arena;
+    TokenStream tokens("extern putchar: (int) -> int;\nputchar('a');");
+
+    const AST::File* file = Parser::parse(tokens, arena);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ("extern putchar: (int) -> int;\nputchar(\'a\');\n", ss.str());
+    ASSERT_TRUE(tokens.done());
+}
+
+TEST(Parser, StopsAtFirstErrorWithoutLexingTheRestOfTheSource) {
+    // The unterminated string is never reached, so only the ParseException is thrown.
+    Arena arena;
+    TokenStream tokens("let foo int = 1; \"unterminated");
+
+    ASSERT_THROW(Parser::parse(tokens, arena), ParseException);
+}
+
+TEST(Parser, ThrowsSyntaxExceptionFromStreamedSource) {
+    Arena arena;
+    TokenStream tokens("let foo: int = \'ab\';");
+
+    ASSERT_THROW(Parser::parse(tokens, arena), SyntaxException);
+}
+
+TEST(Parser, ReparsesRewoundTokens) {
+    Arena arena;
+    const TokenList list = Lexer::tokenize("extern foo: () -> int; let bar: int = foo() * 2;");
+    TokenStream tokens(list);
+
+    const AST::File* first = Parser::parse(tokens, arena);
+    tokens.rewind(0);
+    const AST::File* second = Parser::parse(tokens, arena);
+
+    std::string firstStr;
+    llvm::raw_string_ostream firstStream(firstStr);
+    first->print(firstStream);
+    std::string secondStr;
+    llvm::raw_string_ostream secondStream(secondStr);
+    second->print(secondStream);
+    ASSERT_EQ(firstStream.str(), secondStream.str());
+    ASSERT_NE(first, second);
+}
+
+TEST(Parser, ParsesOneTopLevelElementAtATime) {
+    Arena arena;
+    const TokenList list = Lexer::tokenize("extern foo: () -> int; foo(); bar;");
+    TokenStream tokens(list);
+
+    const AST::Function* externDecl = nullptr;
+    const AST::Statement* statement = nullptr;
+    const auto onExternDecl = [&externDecl](const AST::Function* func) { externDecl = func; };
+    const auto onStatement = [&statement](const AST::Statement* stmt) { statement = stmt; };
+
+    ASSERT_TRUE(Parser::parseNext(tokens, arena, onExternDecl, onStatement));
+    ASSERT_TRUE(externDecl != nullptr);
+    ASSERT_TRUE(statement == nullptr);
+    ASSERT_EQ(8, tokens.consumed());
+
+    ASSERT_TRUE(Parser::parseNext(tokens, arena, onExternDecl, onStatement));
+    ASSERT_TRUE(statement != nullptr);
+    ASSERT_EQ(12, tokens.consumed());
+
+    ASSERT_TRUE(Parser::parseNext(tokens, arena, onExternDecl, onStatement));
+    ASSERT_EQ(14, tokens.consumed());
+    ASSERT_FALSE(Parser::parseNext(tokens, arena, onExternDecl, onStatement));
+}
+
+TEST(Parser, SharesIdenticalExpressionsWithInterner) {
+    Arena arena;
+    AST::Interner interner(arena);
+    TokenStream tokens("let a: int = (x * y) + 1; let b: int = (x * y) + 1; foo(x * y); foo(x * y) + 1;");
+
+    const AST::File* file = Parser::parse(tokens, interner);
+
+    const auto first = (const AST::StatementLet*) file->statements[0];
+    const auto second = (const AST::StatementLet*) file->statements[1];
+    const auto firstCall = (const AST::FunctionCall*) ((const AST::StatementExpression*) file->statements[2])->expr;
+    const auto secondSum = (const AST::AddOpExpression*) ((const AST::StatementExpression*) file->statements[3])->expr;
+    const auto secondCall = (const AST::FunctionCall*) secondSum->leftExpr;
+    ASSERT_EQ(first->expr, second->expr);
+    ASSERT_EQ(((const AST::AddOpExpression*) first->expr)->leftExpr, firstCall->arguments[0]);
+    ASSERT_NE(firstCall, secondCall);
+    ASSERT_FALSE(interner.shared(secondSum));
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ("let a: int = ((x) * (y)) + (1);\nlet b: int = ((x) * (y)) + (1);\nfoo((x) * (y));\n"
+        "(foo((x) * (y))) + (1);\n", ss.str());
+}
+
+TEST(Parser, ReportsErrorOfEveryElementToDiagnostics) {
+    Arena arena;
+    Diagnostics diagnostics;
+    const std::string source = "let a int = 1;\nfoo(1);\nfoo(1 +;\nlet b: (int -> int = 2;\nbar;\nbaz(";
+    TokenStream tokens(source, diagnostics);
+
+    const AST::File* file = Parser::parse(tokens, arena, diagnostics);
+
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    file->print(ss);
+    ASSERT_EQ("foo(1);\nbar;\n", ss.str());
+    ASSERT_EQ(4, diagnostics.size());
+    ASSERT_EQ(Diagnostic::PARSE, diagnostics.all()[0].kind);
+
+    // The first error is the one the throwing parser stops at.
+    TokenStream thrown(source);
+    try {
+        Parser::parse(thrown, arena);
+        FAIL();
+    } catch (const ParseException& ex) {
+        ASSERT_EQ(std::string(ex.what()), diagnostics.all()[0].message);
+    }
+}
+
+TEST(Parser, ReportsOnlySyntaxErrorWhenSourceEndsAtOne) {
+    Arena arena;
+    Diagnostics diagnostics;
+    TokenStream tokens("foo(1);\nlet a: int = \"unterminated", diagnostics);
+
+    const AST::File* file = Parser::parse(tokens, arena, diagnostics);
+
+    ASSERT_EQ(1, file->statements.size());
+    ASSERT_EQ(1, diagnostics.size());
+    ASSERT_EQ(Diagnostic::SYNTAX, diagnostics.all()[0].kind);
+    ASSERT_TRUE(tokens.failed());
+}
+
+TEST(Parser, ReportsIntegerLiteralsWhichDoNotFitInInt) {
+    Arena arena;
+    Diagnostics diagnostics;
+    TokenStream tokens("putchar(99999999999);\nputchar(2147483647);\n", diagnostics);
+
+    const AST::File* file = Parser::parse(tokens, arena, diagnostics);
+
+    ASSERT_EQ(1, file->statements.size());
+    ASSERT_EQ(1, diagnostics.size());
+    ASSERT_EQ(Diagnostic::PARSE, diagnostics.all()[0].kind);
+
+    const TokenList overflowing = Lexer::tokenize("1 + 99999999999999999999999;");
+    ASSERT_THROW(Parser::parse(overflowing, arena), ParseException);
+}
+
+// Returns the printed File of parsing the given source, or the message of the ParseException thrown instead.
+std::string parseOrError(const std::string& source, ThreadPool* pool) {
+    Arena arena;
+    const TokenList tokens = Lexer::tokenize(source);
+    try {
+        const AST::File* file = pool ? Parser::parse(tokens, arena, *pool) : Parser::parse(tokens, arena);
+
+        std::string str;
+        llvm::raw_string_ostream ss(str);
+        file->print(ss);
+        return ss.str();
+    } catch (const ParseException& ex) {
+        return std::string("ParseException: ") + ex.what();
+    }
+}
+
+// Returns a source of enough statements to be split into several segments.
+std::string largeSource() {
+    std::string source = "extern foo: (int, (int) -> int) -> int;\n";
+    for (int i = 0; i < 8000; ++i) {
+        source += "let a" + std::to_string(i) + ": int = foo((1 + " + std::to_string(i) + ") * 2, foo);\n";
+    }
+    return source;
+}
+
+TEST(Parser, ParsesSegmentsInParallelLikeSerially) {
+    ThreadPool pool(4);
+    const std::string source = largeSource();
+
+    const std::string serial = parseOrError(source, nullptr);
+
+    ASSERT_EQ(0, serial.find("extern foo"));
+    ASSERT_EQ(serial, parseOrError(source, &pool));
+    ASSERT_EQ(parseOrError("", nullptr), parseOrError("", &pool));
+    ASSERT_EQ(parseOrError("1; 2;", nullptr), parseOrError("1; 2;", &pool));
+}
+
+TEST(Parser, ThrowsFirstErrorOfParallelSegmentsLikeSerially) {
+    ThreadPool pool(4);
+    const std::string source = largeSource();
+    const size_t early = source.find("let a100:");
+    const size_t late = source.find("let a7000:");
+
+    // Errors in several segments, in one which the serial parse never reaches a boundary of, unbalanced parentheses
+    // and semicolons inside them.
+    for (const std::string& edited : {
+        source.substr(0, late) + "let x int = 1;" + source.substr(late),
+        source.substr(0, early) + "1 +;" + source.substr(early, late - early) + "let;" + source.substr(late),
+        source.substr(0, early) + "foo((1;" + source.substr(early),
+        source.substr(0, early) + "foo(1; 2);" + source.substr(early),
+        source.substr(0, early) + "1);" + source.substr(early),
+        source + "foo(",
+    }) {
+        const std::string serial = parseOrError(edited, nullptr);
+
+        ASSERT_EQ(0, serial.find("ParseException: "));
+        ASSERT_EQ(serial, parseOrError(edited, &pool));
+    }
 }
\ No newline at end of file
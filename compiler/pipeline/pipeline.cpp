@@ -0,0 +1,143 @@
+#include "pipeline.h"
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <experimental/optional>
+#include <experimental/string_view>
+#include "compiler/generator/generator.h"
+#include "compiler/lexer/scanner.h"
+#include "compiler/lexer/token_stream.h"
+#include "compiler/models/ast.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/token.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+#include "compiler/utils/spsc_queue.h"
+#include "llvm/IR/Function.h"
+
+namespace {
+    // A single top-level element of a file, which is either an extern declaration or a statement.
+    class Element {
+    public:
+        const AST::Function* externDecl;
+        const AST::Statement* statement;
+    };
+
+    // Thrown within the parser to stop it once the generator has stopped taking elements.
+    class Cancelled { };
+
+    // Scans the source into chunks of Tokens until the source is exhausted or the parser stops taking them.
+    void lex(const std::experimental::string_view source, SpscQueue<std::vector<Token>>& chunks) {
+        Scanner scanner(source);
+
+        std::vector<Token> chunk;
+        chunk.reserve(Pipeline::TOKENS_PER_CHUNK);
+        std::experimental::optional<Token> token;
+        while ((token = scanner.next())) {
+            chunk.push_back(token.value());
+            if (chunk.size() == Pipeline::TOKENS_PER_CHUNK) {
+                if (!chunks.push(std::move(chunk))) return;
+                chunk = std::vector<Token>();
+                chunk.reserve(Pipeline::TOKENS_PER_CHUNK);
+            }
+        }
+
+        if (!chunk.empty()) chunks.push(std::move(chunk));
+    }
+
+    // Parses chunks of Tokens into top-level elements until they run out or the generator stops taking them.
+    void parse(const std::experimental::string_view source, SpscQueue<std::vector<Token>>& chunks,
+            SpscQueue<Element>& elements, Arena& arena) {
+        TokenStream tokens(source, chunks);
+
+        try {
+            Parser::parseEach(tokens, arena,
+                [&elements](const AST::Function* externDecl) {
+                    if (!elements.push(Element{externDecl, nullptr})) throw Cancelled();
+                },
+                [&elements](const AST::Statement* statement) {
+                    if (!elements.push(Element{nullptr, statement})) throw Cancelled();
+                });
+        } catch (const Cancelled&) {
+            // The generator already failed, and will report its own exception.
+        }
+    }
+
+    // Runs one phase on a new thread. Whether it finishes or fails, the phase stops taking input from the previous phase
+    // and tells the next phase that no more output is coming, so no thread is left waiting on another.
+    template <typename Input, typename Output, typename Phase>
+    std::thread start(SpscQueue<Input>* input, SpscQueue<Output>& output, std::exception_ptr& error, Phase phase) {
+        return std::thread([input, &output, &error, phase]() {
+            try {
+                phase();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            if (input) input->cancel();
+            output.close();
+        });
+    }
+}
+
+llvm::Function* Pipeline::compile(CompilationSession& session, const std::experimental::string_view source,
+        const size_t chunkInstructions) {
+    // Only the parser allocates in the Arena, and the generator only reads what it has been handed.
+    Arena arena;
+    SpscQueue<std::vector<Token>> chunks(QUEUE_CAPACITY);
+    SpscQueue<Element> elements(QUEUE_CAPACITY);
+    std::exception_ptr lexError, parseError, generateError;
+
+    std::thread lexer = start<std::vector<Token>>(nullptr, chunks, lexError,
+        [source, &chunks]() { lex(source, chunks); });
+    std::thread parser = start(&chunks, elements, parseError,
+        [source, &chunks, &elements, &arena]() { parse(source, chunks, elements, arena); });
+
+    llvm::Function* main = nullptr;
+    try {
+        Generator generator(session);
+        generator.outline(chunkInstructions);
+        std::experimental::optional<Element> element;
+        while ((element = elements.pop())) {
+            if (element->externDecl) {
+                generator.declare(*element->externDecl);
+            } else {
+                generator.append(*element->statement);
+            }
+        }
+        main = generator.finish();
+    } catch (...) {
+        generateError = std::current_exception();
+    }
+    elements.cancel();
+
+    lexer.join();
+    parser.join();
+
+    // A failure in an earlier phase usually causes failures in later ones, such as a lexer error cutting the parser's
+    // input short, so report the earliest one.
+    for (const std::exception_ptr& error : { lexError, parseError, generateError }) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    return main;
+}
+
+llvm::Function* Pipeline::stream(CompilationSession& session, const std::experimental::string_view source,
+        const size_t chunkInstructions) {
+    TokenStream tokens(source);
+    Generator generator(session);
+    generator.outline(chunkInstructions);
+    const std::function<void (const AST::Function*)> onExternDecl =
+        [&generator](const AST::Function* externDecl) { generator.declare(*externDecl); };
+    const std::function<void (const AST::Statement*)> onStatement =
+        [&generator](const AST::Statement* statement) { generator.append(*statement); };
+
+    // The generator keeps nothing from the AST once an element has been generated, so the Arena is cleared for the
+    // next one, reusing the same memory throughout.
+    Arena arena;
+    while (Parser::parseNext(tokens, arena, onExternDecl, onStatement)) arena.clear();
+
+    return generator.finish();
+}
\ No newline at end of file
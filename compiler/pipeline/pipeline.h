@@ -0,0 +1,57 @@
+#ifndef SANITY_PIPELINE_H
+#define SANITY_PIPELINE_H
+
+#include <cstddef>
+#include <experimental/string_view>
+#include "compiler/models/compilation_session.h"
+#include "llvm/IR/Function.h"
+
+/**
+ * Pipelined compilation, where the lexer, the parser and the generator each run on their own thread, connected by
+ * bounded single-producer/single-consumer queues. The lexer hands Tokens to the parser in chunks, and the parser hands
+ * each extern declaration and statement to the generator as soon as it has been parsed, so the phases overlap rather
+ * than each one waiting for the previous to finish the whole file.
+ *
+ * Since statements are generated as they arrive, a function must be declared before it is first called.
+ */
+namespace Pipeline {
+    // Number of Tokens the lexer hands over at once, which amortizes the synchronization over many Tokens.
+    const size_t TOKENS_PER_CHUNK = 4096;
+
+    // Number of chunks of Tokens and of top-level elements which may be waiting between two phases at once.
+    const size_t QUEUE_CAPACITY = 64;
+
+    /**
+     * Compiles the given source into the module of the given session and returns its main function. The generator runs
+     * on the calling thread, since a session is not safe to use from multiple threads. If multiple phases fail, the
+     * exception of the earliest phase is thrown, just as if they had been run one after another. Statements are
+     * outlined into chunks of the given number of instructions, as with Generator::outline(), unless it is zero.
+     * @throws SyntaxException
+     * @throws ParseException
+     * @throws RedeclaredException
+     * @throws TypeException
+     * @throws UndeclaredException
+     */
+    llvm::Function* compile(CompilationSession& session, std::experimental::string_view source,
+        size_t chunkInstructions = 0);
+
+    /**
+     * Compiles the given source into the module of the given session one top-level element at a time on the calling
+     * thread, lexing and parsing each extern declaration or statement, then generating it and freeing its AST before
+     * moving on to the next one. Only the declared functions and variables are remembered between elements, so memory
+     * grows with the IR generated rather than with the size of the source or its AST, which suits huge generated
+     * programs.
+     *
+     * As with compile(), a function must be declared before it is first called, and statements are outlined into chunks
+     * of the given number of instructions unless it is zero.
+     * @throws SyntaxException
+     * @throws ParseException
+     * @throws RedeclaredException
+     * @throws TypeException
+     * @throws UndeclaredException
+     */
+    llvm::Function* stream(CompilationSession& session, std::experimental::string_view source,
+        size_t chunkInstructions = 0);
+}
+
+#endif //SANITY_PIPELINE_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include "pipeline.h"
+#include "compiler/generator/generator.h"
+#include "compiler/lexer/lexer.h"
+#include "compiler/models/exceptions.h"
+#include "compiler/models/compilation_session.h"
+#include "compiler/models/symbol.h"
+#include "compiler/models/token_list.h"
+#include "compiler/parser/parser.h"
+#include "compiler/utils/arena.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+typedef Exceptions::ParseException ParseException;
+typedef Exceptions::SyntaxException SyntaxException;
+typedef Exceptions::UndeclaredException UndeclaredException;
+
+// Each compilation gets a session of its own, so its module is printed on its own.
+std::string printModule(const CompilationSession& session) {
+    std::string str;
+    llvm::raw_string_ostream ss(str);
+    session.module->print(ss, nullptr);
+    return ss.str();
+}
+
+std::string compileSequentially(const std::string& source) {
+    CompilationSession session("Pipeline Test");
+    const TokenList tokens = Lexer::tokenize(source);
+    Arena arena;
+    Generator::gen(session, *Parser::parse(tokens, arena));
+    return printModule(session);
+}
+
+std::string compilePipelined(const std::string& source) {
+    CompilationSession session("Pipeline Test");
+    Pipeline::compile(session, source);
+    return printModule(session);
+}
+
+std::string compileStreamed(const std::string& source) {
+    CompilationSession session("Pipeline Test");
+    Pipeline::stream(session, source);
+    return printModule(session);
+}
+
+TEST(Pipeline, GeneratesSameIRAsSequentialCompilation) {
+    const std::string source = "extern putchar: (int) -> int;\n"
+        "let foo: int = 1 + 2 * 3;\n"
+        "putchar(foo);\n"
+        "putchar(\'a\');";
+
+    ASSERT_EQ(compileSequentially(source), compilePipelined(source));
+}
+
+TEST(Pipeline, GeneratesSameIRAcrossManyChunks) {
+    std::string source = "extern putchar: (int) -> int;\n";
+    for (size_t i = 0; i < 2 * Pipeline::TOKENS_PER_CHUNK; ++i) source += "putchar(" + std::to_string(i) + ");\n";
+
+    ASSERT_EQ(compileSequentially(source), compilePipelined(source));
+}
+
+TEST(Pipeline, KeepsExternsDeclaredAfterStatementsBeforeMain) {
+    const std::string source = "extern putchar: (int) -> int;\nputchar(1);\nextern puts: (string) -> int;";
+
+    ASSERT_EQ(compileSequentially(source), compilePipelined(source));
+}
+
+TEST(Pipeline, CompilesEmptySource) {
+    ASSERT_EQ(compileSequentially(""), compilePipelined(""));
+}
+
+TEST(Pipeline, ThrowsSyntaxException) {
+    CompilationSession session("Pipeline Test");
+
+    ASSERT_THROW(Pipeline::compile(session, "extern putchar: (int) -> int;\nputchar(\'ab\');"), SyntaxException);
+}
+
+TEST(Pipeline, ThrowsParseException) {
+    CompilationSession session("Pipeline Test");
+
+    ASSERT_THROW(Pipeline::compile(session, "let foo int = 1;"), ParseException);
+}
+
+TEST(Pipeline, PrefersSyntaxExceptionOverTheParseExceptionItCauses) {
+    CompilationSession session("Pipeline Test");
+
+    // The lexer stops at the unterminated string, so the parser also sees the let statement cut short.
+    ASSERT_THROW(Pipeline::compile(session, "let foo: int = \"unterminated"), SyntaxException);
+}
+
+TEST(Pipeline, ThrowsGeneratorExceptionsAndStopsTheOtherPhases) {
+    CompilationSession session("Pipeline Test");
+
+    std::string source = "putchar(1);\n";
+    for (size_t i = 0; i < 4 * Pipeline::TOKENS_PER_CHUNK; ++i) source += "1;\n";
+
+    ASSERT_THROW(Pipeline::compile(session, source), UndeclaredException);
+}
+
+TEST(Pipeline, StreamsSameIRAsSequentialCompilation) {
+    std::string source = "extern putchar: (int) -> int;\nlet foo: int = 1 + 2 * 3;\nputchar(foo);\n"
+        "extern puts: (string) -> int;\n";
+    for (size_t i = 0; i < Arena::SLAB_SIZE; ++i) source += "puts(\"" + std::to_string(i) + "\") + foo;\n";
+
+    ASSERT_EQ(compileSequentially(source), compileStreamed(source));
+    ASSERT_EQ(compileSequentially(""), compileStreamed(""));
+}
+
+TEST(Pipeline, ThrowsExceptionsWhileStreaming) {
+    CompilationSession lexed("Pipeline Test");
+    ASSERT_THROW(Pipeline::stream(lexed, "putchar(\'ab\');"), SyntaxException);
+
+    CompilationSession parsed("Pipeline Test");
+    ASSERT_THROW(Pipeline::stream(parsed, "let foo int = 1;"), ParseException);
+
+    CompilationSession generated("Pipeline Test");
+    ASSERT_THROW(Pipeline::stream(generated, "putchar(1);\nextern putchar: (int) -> int;"), UndeclaredException);
+}
\ No newline at end of file
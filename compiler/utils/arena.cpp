@@ -0,0 +1,67 @@
+#include "arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <experimental/string_view>
+
+namespace {
+    uintptr_t align(const uintptr_t address, const size_t alignment) {
+        return (address + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    }
+}
+
+void* Arena::grow(const size_t size, const size_t alignment) {
+    if (size + alignment > SLAB_SIZE / 4) {
+        // Large objects get a slab of their own, leaving the current slab to be filled by smaller ones.
+        this->slabs.emplace_back(new char[size + alignment]);
+        return (void*) align((uintptr_t) this->slabs.back().get(), alignment);
+    }
+
+    this->slabs.emplace_back(new char[SLAB_SIZE]);
+    this->next = (uintptr_t) this->slabs.back().get();
+    this->end = this->next + SLAB_SIZE;
+
+    return this->allocate(size, alignment);
+}
+
+std::experimental::string_view Arena::text(const std::experimental::string_view text) {
+    if (text.empty()) return std::experimental::string_view();
+
+    char* copy = (char*) this->allocate(text.size(), 1);
+    std::memcpy(copy, text.data(), text.size());
+    return std::experimental::string_view(copy, text.size());
+}
+
+void Arena::reset() {
+    this->slabs.clear();
+    this->next = 0;
+    this->end = 0;
+}
+
+void Arena::clear() {
+    if (this->end == 0) return this->reset();
+
+    // Large objects' slabs are never the current one, so the current slab is the one ending where free space does.
+    const uintptr_t current = this->end - SLAB_SIZE;
+    for (std::unique_ptr<char[]>& slab : this->slabs) {
+        if ((uintptr_t) slab.get() == current) {
+            std::unique_ptr<char[]> kept = std::move(slab);
+            this->slabs.clear();
+            this->slabs.push_back(std::move(kept));
+            break;
+        }
+    }
+    this->next = current;
+}
+
+void Arena::adopt(Arena& other) {
+    // The current slab is kept, so allocation carries on filling it rather than the other Arena's last slab.
+    for (std::unique_ptr<char[]>& slab : other.slabs) this->slabs.push_back(std::move(slab));
+    other.reset();
+}
+
+size_t Arena::slabCount() const {
+    return this->slabs.size();
+}
\ No newline at end of file
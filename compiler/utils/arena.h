@@ -0,0 +1,136 @@
+#ifndef SANITY_ARENA_H
+#define SANITY_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <experimental/string_view>
+
+/**
+ * Immutable array allocated in an Arena. Only views its items, so it is as cheap to copy as a pointer.
+ */
+template <typename T>
+class ArenaList {
+private:
+    const T* items;
+    size_t count;
+
+public:
+    ArenaList() : items(nullptr), count(0) { }
+    ArenaList(const T* items, const size_t count) : items(items), count(count) { }
+
+    size_t size() const {
+        return this->count;
+    }
+
+    bool empty() const {
+        return this->count == 0;
+    }
+
+    const T& operator[](const size_t index) const {
+        return this->items[index];
+    }
+
+    const T* begin() const {
+        return this->items;
+    }
+
+    const T* end() const {
+        return this->items + this->count;
+    }
+};
+
+/**
+ * Bump-pointer allocator which places objects one after another in large slabs of memory. Allocating is a pointer
+ * increment, and everything allocated is freed at once when the Arena is reset or destroyed, so only objects which need
+ * no destructor can be placed in one.
+ *
+ * Arenas are not thread-safe, but objects allocated in one can be read from any thread once they have been handed over.
+ */
+class Arena {
+public:
+    // Size of each slab. Objects larger than a quarter of this get a slab of their own, so they waste little space.
+    static const size_t SLAB_SIZE = 64 * 1024;
+
+private:
+    std::vector<std::unique_ptr<char[]>> slabs;
+    uintptr_t next = 0; // Free space left in the current slab is [next, end).
+    uintptr_t end = 0;
+
+    void* grow(size_t size, size_t alignment);
+
+    void* allocate(const size_t size, const size_t alignment) {
+        const uintptr_t start = (this->next + alignment - 1) & ~(uintptr_t) (alignment - 1);
+        if (start > this->end || this->end - start < size) return this->grow(size, alignment);
+
+        this->next = start + size;
+        return (void*) start;
+    }
+
+public:
+    Arena() = default;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Constructs a T from the given arguments directly in the Arena.
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed.");
+        return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Copies the given items into the Arena.
+     */
+    template <typename T>
+    ArenaList<T> list(const T* items, const size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Arena lists are copied byte for byte.");
+        if (count == 0) return ArenaList<T>();
+
+        T* copy = (T*) this->allocate(sizeof(T) * count, alignof(T));
+        std::uninitialized_copy(items, items + count, copy);
+        return ArenaList<T>(copy, count);
+    }
+
+    template <typename T>
+    ArenaList<T> list(const std::vector<T>& items) {
+        return this->list(items.data(), items.size());
+    }
+
+    /**
+     * Copies the given text into the Arena.
+     */
+    std::experimental::string_view text(std::experimental::string_view text);
+
+    /**
+     * Frees everything allocated in the Arena at once.
+     */
+    void reset();
+
+    /**
+     * Frees everything allocated in the Arena like reset(), except that the slab currently being filled is kept and
+     * filled again from its start. An Arena cleared after each of many small batches of objects therefore allocates
+     * no memory once it has warmed up.
+     */
+    void clear();
+
+    /**
+     * Takes ownership of everything allocated in the given Arena, which is left empty. Objects allocated in it stay
+     * where they are and are freed along with this Arena instead.
+     */
+    void adopt(Arena& other);
+
+    /**
+     * Returns the number of slabs currently allocated.
+     */
+    size_t slabCount() const;
+};
+
+#endif //SANITY_ARENA_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "arena.h"
+
+class Point {
+public:
+    int32_t x;
+    int32_t y;
+
+    Point(const int32_t x, const int32_t y) : x(x), y(y) { }
+};
+
+TEST(Arena, ConstructsObjectsInPlace) {
+    Arena arena;
+
+    const Point* first = arena.make<Point>(1, 2);
+    const Point* second = arena.make<Point>(3, 4);
+
+    ASSERT_EQ(1, first->x);
+    ASSERT_EQ(4, second->y);
+    ASSERT_EQ(1, arena.slabCount());
+}
+
+TEST(Arena, AlignsObjects) {
+    Arena arena;
+
+    arena.make<char>('a');
+    const double* value = arena.make<double>(1.5);
+
+    ASSERT_EQ(0, (uintptr_t) value % alignof(double));
+    ASSERT_EQ(1.5, *value);
+}
+
+TEST(Arena, FillsSlabsBeforeAllocatingMore) {
+    Arena arena;
+
+    const size_t count = 3 * Arena::SLAB_SIZE / sizeof(Point);
+    for (size_t i = 0; i < count; ++i) arena.make<Point>(0, 0);
+
+    ASSERT_EQ(3, arena.slabCount());
+}
+
+TEST(Arena, GivesLargeObjectsTheirOwnSlab) {
+    Arena arena;
+    const std::vector<int32_t> large(Arena::SLAB_SIZE, 7);
+
+    const Point* before = arena.make<Point>(1, 2);
+    const ArenaList<int32_t> list = arena.list(large);
+    const Point* after = arena.make<Point>(3, 4);
+
+    ASSERT_EQ(large.size(), list.size());
+    ASSERT_EQ(7, list[large.size() - 1]);
+    ASSERT_EQ(2, arena.slabCount());
+    ASSERT_EQ(before + 1, after); // Still placed in the first slab.
+}
+
+TEST(Arena, CopiesListsAndText) {
+    Arena arena;
+    std::vector<int32_t> items = { 1, 2, 3 };
+    std::string text = "text";
+
+    const ArenaList<int32_t> list = arena.list(items);
+    const std::experimental::string_view copy = arena.text(text);
+    items[0] = 0;
+    text[0] = 'n';
+
+    ASSERT_EQ(std::vector<int32_t>({ 1, 2, 3 }), std::vector<int32_t>(list.begin(), list.end()));
+    ASSERT_EQ("text", copy);
+    ASSERT_TRUE(arena.list(std::vector<int32_t>()).empty());
+}
+
+TEST(Arena, FreesEverythingOnReset) {
+    Arena arena;
+    for (size_t i = 0; i < Arena::SLAB_SIZE; ++i) arena.make<Point>(0, 0);
+
+    arena.reset();
+
+    ASSERT_EQ(0, arena.slabCount());
+    ASSERT_EQ(5, arena.make<Point>(5, 6)->x);
+}
+
+TEST(Arena, ReusesCurrentSlabOnClear) {
+    Arena arena;
+    const std::vector<int32_t> large(Arena::SLAB_SIZE, 7);
+    for (size_t i = 0; i < Arena::SLAB_SIZE; ++i) arena.make<Point>(0, 0);
+    arena.list(large);
+    const Point* last = arena.make<Point>(1, 2);
+
+    arena.clear();
+
+    ASSERT_EQ(1, arena.slabCount());
+    const Point* first = arena.make<Point>(3, 4);
+    // Placed back at the start of the slab the last Point was in.
+    ASSERT_LE(first, last);
+    ASSERT_LT(last, first + Arena::SLAB_SIZE / sizeof(Point));
+    ASSERT_EQ(3, first->x);
+
+    Arena empty;
+    empty.clear();
+    ASSERT_EQ(0, empty.slabCount());
+}
+
+TEST(Arena, AdoptsAnotherArenasObjects) {
+    Arena arena;
+    const Point* kept = arena.make<Point>(1, 2);
+    const Point* adopted;
+    {
+        Arena other;
+        adopted = other.make<Point>(3, 4);
+
+        arena.adopt(other);
+
+        ASSERT_EQ(0, other.slabCount());
+    }
+
+    ASSERT_EQ(2, arena.slabCount());
+    ASSERT_EQ(1, kept->x);
+    ASSERT_EQ(3, adopted->x);
+    ASSERT_EQ(4, adopted->y);
+}
\ No newline at end of file
@@ -1,6 +1,4 @@
 #include "queue_utils.h"
-#include "compiler/models/token.h"
-#include <memory>
 #include <string>
 #include <queue>
 
@@ -11,15 +9,5 @@ std::queue<char> QueueUtils::queueify(const std::string& str) {
         q.push(c);
     }
 
-    return q;
-}
-
-std::queue<std::shared_ptr<const Token>> QueueUtils::queueify(const std::vector<std::shared_ptr<const Token>>& tokens) {
-    std::queue<std::shared_ptr<const Token>> q;
-
-    for (const auto& token : tokens) {
-        q.push(token);
-    }
-
     return q;
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "source_buffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <experimental/string_view>
+#include "compiler/models/exceptions.h"
+
+typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+const size_t READ_CHUNK_SIZE = 64 * 1024;
+
+SourceBuffer::SourceBuffer(const char* data, const size_t size, const bool mapped)
+    : data(data), size(size), mapped(mapped) { }
+
+SourceBuffer::SourceBuffer(std::string contents)
+    : data(nullptr), size(contents.size()), mapped(false), contents(std::move(contents)) {
+    this->data = this->contents.data();
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (this->mapped) munmap(const_cast<char*>(this->data), this->size);
+}
+
+std::unique_ptr<const SourceBuffer> SourceBuffer::open(const std::string& filename) {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw FileNotFoundException(filename);
+
+    // Map regular files directly into memory. The lexer reads them front to back, so let the kernel read ahead.
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        const auto size = (size_t) info.st_size;
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            return std::unique_ptr<const SourceBuffer>(new SourceBuffer((const char*) mapping, size, true));
+        }
+    }
+
+    // Pipes and other files which can't be mapped are read in large chunks until EOF, retrying reads interrupted by a
+    // signal before any data arrived.
+    std::string contents;
+    size_t length = 0;
+    ssize_t bytesRead;
+    do {
+        contents.resize(length + READ_CHUNK_SIZE);
+        bytesRead = read(fd, &contents[length], READ_CHUNK_SIZE);
+        if (bytesRead > 0) length += bytesRead;
+    } while (bytesRead > 0 || (bytesRead < 0 && errno == EINTR));
+
+    if (bytesRead < 0) {
+        const std::string error = std::strerror(errno);
+        close(fd);
+        throw IllegalStateException("Cannot read \"" + filename + "\": " + error);
+    }
+    close(fd);
+    contents.resize(length);
+
+    return fromString(std::move(contents));
+}
+
+std::unique_ptr<const SourceBuffer> SourceBuffer::fromString(std::string contents) {
+    return std::unique_ptr<const SourceBuffer>(new SourceBuffer(std::move(contents)));
+}
+
+std::experimental::string_view SourceBuffer::view() const {
+    return std::experimental::string_view(this->data, this->size);
+}
\ No newline at end of file
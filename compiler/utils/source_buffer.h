@@ -0,0 +1,48 @@
+#ifndef SANITY_SOURCE_BUFFER_H
+#define SANITY_SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <experimental/string_view>
+
+/**
+ * Read-only, contiguous view of the contents of a source file. Regular files are memory-mapped so their contents are
+ * never copied, anything else (such as a pipe to /dev/stdin) is read into memory with bulk reads.
+ */
+class SourceBuffer {
+private:
+    const char* data;
+    size_t size;
+    bool mapped;
+    std::string contents;
+
+    SourceBuffer(const char* data, size_t size, bool mapped);
+
+    explicit SourceBuffer(std::string contents);
+
+public:
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    /**
+     * Opens the file with the given name and exposes its contents, including all forms of whitespace.
+     * @throws FileNotFoundException if the file cannot be opened.
+     * @throws IllegalStateException if the file was opened but reading it failed, with the reason it failed.
+     */
+    static std::unique_ptr<const SourceBuffer> open(const std::string& filename);
+
+    /**
+     * Wraps the given in-memory contents.
+     */
+    static std::unique_ptr<const SourceBuffer> fromString(std::string contents);
+
+    /**
+     * Returns a view of the whole contents, which is valid for as long as this SourceBuffer is alive.
+     */
+    std::experimental::string_view view() const;
+};
+
+#endif //SANITY_SOURCE_BUFFER_H
\ No newline at end of file
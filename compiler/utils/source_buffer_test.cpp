@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "source_buffer.h"
+#include "compiler/models/exceptions.h"
+
+typedef Exceptions::FileNotFoundException FileNotFoundException;
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+TEST(SourceBuffer, OpensRegularFiles) {
+    const auto filename = "hello.txt";
+    const std::string content = "Hello World!\n\tGoodbye.";
+    std::ofstream stream(filename);
+    stream << content;
+    stream.close();
+
+    const auto buffer = SourceBuffer::open(filename);
+
+    ASSERT_EQ(content, buffer->view());
+}
+
+TEST(SourceBuffer, OpensEmptyFiles) {
+    const auto filename = "empty.txt";
+    std::ofstream stream(filename);
+    stream.close();
+
+    const auto buffer = SourceBuffer::open(filename);
+
+    ASSERT_TRUE(buffer->view().empty());
+}
+
+TEST(SourceBuffer, ReadsPipes) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    // Write more than a single chunk so the buffer has to grow.
+    const std::string content(200 * 1024, 'a');
+    std::thread writer([&fds, &content]() {
+        const char* data = content.data();
+        size_t remaining = content.size();
+        while (remaining > 0) {
+            const ssize_t written = write(fds[1], data, remaining);
+            if (written <= 0) break;
+            data += written;
+            remaining -= written;
+        }
+        close(fds[1]);
+    });
+
+    const auto buffer = SourceBuffer::open("/dev/fd/" + std::to_string(fds[0]));
+    writer.join();
+    close(fds[0]);
+
+    ASSERT_EQ(content, buffer->view());
+}
+
+TEST(SourceBuffer, WrapsStrings) {
+    const auto buffer = SourceBuffer::fromString("abc");
+
+    ASSERT_EQ("abc", buffer->view());
+}
+
+TEST(SourceBuffer, OpenThrowsFileNotFound) {
+    ASSERT_THROW(SourceBuffer::open("does_not_exist.txt"), FileNotFoundException);
+}
+
+TEST(SourceBuffer, OpenThrowsIllegalStateOnReadFailure) {
+    // A directory can be opened, but reading it fails.
+    try {
+        SourceBuffer::open(".");
+        FAIL() << "Expected an IllegalStateException.";
+    } catch (const IllegalStateException& ex) {
+        ASSERT_NE(std::string::npos, std::string(ex.what()).find(std::strerror(EISDIR)));
+    }
+}
\ No newline at end of file
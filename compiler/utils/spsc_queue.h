@@ -0,0 +1,138 @@
+#ifndef SANITY_SPSC_QUEUE_H
+#define SANITY_SPSC_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <experimental/optional>
+
+/**
+ * Bounded, lock-free queue for handing values from exactly one producer thread to exactly one consumer thread. Values
+ * are stored in a fixed ring buffer, and each side only ever writes its own index, so pushing and popping are a pair of
+ * atomic loads and a single atomic store. A side which cannot make progress yields its thread a bounded number of times,
+ * then parks until the other side wakes it, so a stalled phase does not keep a core busy. The other side only takes the
+ * lock to wake it when it sees it parked, so neither side locks while both are keeping up.
+ *
+ * The producer close()s the queue once it has pushed everything, and the consumer cancel()s it if it gives up early,
+ * so neither side can be left waiting on the other forever.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> slots;
+    const size_t capacity;
+
+    // Kept on separate cache lines so the producer and consumer do not contend on each other's writes.
+    alignas(64) std::atomic<size_t> head; // Index of the next value to pop, only written by the consumer.
+    alignas(64) std::atomic<size_t> tail; // Index of the next value to push, only written by the producer.
+    alignas(64) std::atomic<bool> closed;
+    std::atomic<bool> cancelled;
+
+    // Number of times a side checks the queue, yielding in between, before it parks.
+    static const int SPINS = 64;
+
+    // Each side sets its flag before parking on its condition variable, so the other side knows to wake it.
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::atomic<bool> consumerParked;
+    std::atomic<bool> producerParked;
+
+    // Waits until the given condition holds, parking on the given condition variable if it does not hold soon.
+    template <typename Condition>
+    void await(std::atomic<bool>& parked, std::condition_variable& wakeup, const Condition condition) {
+        for (int spin = 0; spin < SPINS; ++spin) {
+            if (condition()) return;
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        parked.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in wake(): either the other side sees this one parked, or this one sees its update.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeup.wait(lock, condition);
+        parked.store(false, std::memory_order_relaxed);
+    }
+
+    // Wakes the other side if it has parked, after an update it may be waiting for.
+    void wake(std::atomic<bool>& parked, std::condition_variable& wakeup) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!parked.load(std::memory_order_relaxed)) return;
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        wakeup.notify_one();
+    }
+
+public:
+    /**
+     * Creates a queue which holds at most the given number of values at once.
+     */
+    explicit SpscQueue(const size_t capacity)
+        : slots(capacity + 1), capacity(capacity + 1), head(0), tail(0), closed(false), cancelled(false),
+          consumerParked(false), producerParked(false) { }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Pushes the given value, waiting for space if the queue is full. Returns false without pushing if the consumer has
+     * cancelled the queue. Must only be called from the producer thread.
+     */
+    bool push(T value) {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % this->capacity;
+
+        this->await(this->producerParked, this->notFull, [this, next]() {
+            return next != this->head.load(std::memory_order_acquire)
+                || this->cancelled.load(std::memory_order_acquire);
+        });
+        if (this->cancelled.load(std::memory_order_acquire)) return false;
+
+        this->slots[tail] = std::move(value);
+        this->tail.store(next, std::memory_order_release);
+        this->wake(this->consumerParked, this->notEmpty);
+        return true;
+    }
+
+    /**
+     * Pops the next value, waiting for one if the queue is empty. Returns std::experimental::nullopt once the queue has
+     * been closed and every value pushed before that has been popped. Must only be called from the consumer thread.
+     */
+    std::experimental::optional<T> pop() {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+
+        this->await(this->consumerParked, this->notEmpty, [this, head]() {
+            return head != this->tail.load(std::memory_order_acquire)
+                || this->closed.load(std::memory_order_acquire);
+        });
+        // Check the tail again after seeing the queue closed, in case a value was pushed just before closing.
+        if (head == this->tail.load(std::memory_order_acquire)) return std::experimental::nullopt;
+
+        T value = std::move(this->slots[head]);
+        this->head.store((head + 1) % this->capacity, std::memory_order_release);
+        this->wake(this->producerParked, this->notFull);
+        return std::experimental::optional<T>(std::move(value));
+    }
+
+    /**
+     * Marks that no more values will be pushed. Must only be called from the producer thread.
+     */
+    void close() {
+        this->closed.store(true, std::memory_order_release);
+        this->wake(this->consumerParked, this->notEmpty);
+    }
+
+    /**
+     * Marks that no more values will be popped, so any further pushes are dropped. Must only be called from the
+     * consumer thread.
+     */
+    void cancel() {
+        this->cancelled.store(true, std::memory_order_release);
+        this->wake(this->producerParked, this->notFull);
+    }
+};
+
+#endif //SANITY_SPSC_QUEUE_H
\ No newline at end of file
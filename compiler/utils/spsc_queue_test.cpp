@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spsc_queue.h"
+
+TEST(SpscQueue, PopsValuesInOrder) {
+    SpscQueue<std::string> queue(4);
+
+    ASSERT_TRUE(queue.push("a"));
+    ASSERT_TRUE(queue.push("b"));
+    queue.close();
+
+    ASSERT_EQ("a", queue.pop().value());
+    ASSERT_EQ("b", queue.pop().value());
+    ASSERT_FALSE(queue.pop());
+}
+
+TEST(SpscQueue, DropsPushesOnceCancelled) {
+    SpscQueue<int> queue(1);
+
+    ASSERT_TRUE(queue.push(1));
+    queue.cancel();
+
+    ASSERT_FALSE(queue.push(2)); // Would otherwise wait forever on the full queue.
+}
+
+TEST(SpscQueue, HandsValuesBetweenThreads) {
+    const int count = 100000;
+    SpscQueue<int> queue(16);
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; ++i) queue.push(i);
+        queue.close();
+    });
+
+    std::vector<int> values;
+    std::experimental::optional<int> value;
+    while ((value = queue.pop())) values.push_back(value.value());
+    producer.join();
+
+    ASSERT_EQ(count, values.size());
+    for (int i = 0; i < count; ++i) ASSERT_EQ(i, values[i]);
+}
+
+TEST(SpscQueue, UnblocksProducerWhenCancelled) {
+    SpscQueue<int> queue(2);
+
+    std::thread producer([&queue]() {
+        int i = 0;
+        while (queue.push(i++)) { }
+    });
+
+    ASSERT_EQ(0, queue.pop().value());
+    queue.cancel();
+    producer.join();
+}
+
+TEST(SpscQueue, ParksConsumerUntilValuePushed) {
+    SpscQueue<int> queue(1);
+    std::experimental::optional<int> value;
+    std::thread consumer([&queue, &value]() { value = queue.pop(); });
+
+    // A consumer spinning the whole time would use about as much CPU time as passes, rather than barely any.
+    const std::clock_t start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const double seconds = (double) (std::clock() - start) / CLOCKS_PER_SEC;
+    queue.push(1);
+    consumer.join();
+
+    ASSERT_EQ(1, value.value());
+    ASSERT_LT(seconds, 0.15);
+}
+
+TEST(SpscQueue, WakesParkedSidesWhenClosedOrCancelled) {
+    SpscQueue<int> empty(1);
+    std::thread consumer([&empty]() { ASSERT_FALSE(empty.pop()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    empty.close();
+    consumer.join();
+
+    SpscQueue<int> full(1);
+    ASSERT_TRUE(full.push(1));
+    std::thread producer([&full]() { ASSERT_FALSE(full.push(2)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    full.cancel();
+    producer.join();
+}
\ No newline at end of file
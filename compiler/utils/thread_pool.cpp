@@ -0,0 +1,51 @@
+#include "thread_pool.h"
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "compiler/models/exceptions.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+ThreadPool::ThreadPool(const size_t threads) {
+    if (threads == 0) throw IllegalStateException("A ThreadPool needs at least one thread.");
+
+    for (size_t i = 0; i < threads; ++i) {
+        this->workers.emplace_back([this]() { this->work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->available.notify_all();
+
+    for (std::thread& worker : this->workers) worker.join();
+}
+
+// Runs tasks until the pool is stopping and no tasks are left.
+void ThreadPool::work() {
+    while (true) {
+        std::function<void ()> task;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->available.wait(lock, [this]() { return this->stopping || !this->tasks.empty(); });
+            if (this->tasks.empty()) return;
+
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+        }
+
+        task();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void ()> task) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->tasks.push(std::move(task));
+    }
+    this->available.notify_one();
+}
\ No newline at end of file
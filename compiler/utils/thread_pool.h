@@ -0,0 +1,65 @@
+#ifndef SANITY_THREAD_POOL_H
+#define SANITY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads which run submitted tasks in the order they were submitted. The pool finishes every task
+ * already submitted before it is destroyed.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void ()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+    void work();
+    void enqueue(std::function<void ()> task);
+
+public:
+    /**
+     * Starts the given number of worker threads, which must be at least one.
+     * @throws IllegalStateException if the number of threads is zero.
+     */
+    explicit ThreadPool(size_t threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Returns the number of worker threads.
+     */
+    size_t size() const {
+        return this->workers.size();
+    }
+
+    /**
+     * Runs the given task on a worker thread, and returns a future of its result. Any exception thrown by the task is
+     * rethrown from the future.
+     */
+    template <typename Task>
+    std::future<typename std::result_of<Task ()>::type> submit(Task task) {
+        typedef typename std::result_of<Task ()>::type Result;
+
+        // std::function requires a copyable task, so the packaged_task is shared rather than moved into it.
+        const auto packaged = std::make_shared<std::packaged_task<Result ()>>(std::move(task));
+        std::future<Result> result = packaged->get_future();
+        this->enqueue([packaged]() { (*packaged)(); });
+
+        return result;
+    }
+};
+
+#endif //SANITY_THREAD_POOL_H
\ No newline at end of file
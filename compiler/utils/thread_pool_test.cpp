@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+#include "thread_pool.h"
+#include "compiler/models/exceptions.h"
+
+typedef Exceptions::IllegalStateException IllegalStateException;
+
+TEST(ThreadPool, ReturnsResultsOfTasks) {
+    ThreadPool pool(4);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) results.push_back(pool.submit([i]() { return i * i; }));
+
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(i * i, results[i].get());
+}
+
+TEST(ThreadPool, RethrowsExceptionsOfTasks) {
+    ThreadPool pool(1);
+
+    std::future<void> result = pool.submit([]() { throw std::runtime_error("Task failed."); });
+
+    ASSERT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, FinishesSubmittedTasksBeforeDestruction) {
+    std::atomic<int> finished(0);
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 50; ++i) pool.submit([&finished]() { finished++; });
+    }
+
+    ASSERT_EQ(50, finished);
+}
+
+TEST(ThreadPool, RequiresAThread) {
+    ASSERT_THROW(ThreadPool(0), IllegalStateException);
+}
\ No newline at end of file